@@ -0,0 +1,140 @@
+/**
+ * NoiseBench - NoiseGenerator 标量 / SSE2 路径一致性检查和微基准
+ *
+ * 在一组尺寸（包括不是 4 的倍数的宽度）和参数上分别用两条路径生成
+ * Perlin / Simplex / FBM，逐位比较结果；任一不一致时返回 1
+ * 之后在 1024x1024 上对比两条路径的耗时
+ *
+ * 用法: noise-bench [最短运行秒数，默认 0.5]
+ */
+
+#include "renderer/NoiseGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace shadertoy;
+
+namespace {
+
+struct NoiseKind {
+    const char* name;
+    std::function<std::vector<float>(int width, int height, int octaves, float param, float scale)> generate;
+};
+
+const NoiseKind KINDS[] = {
+    {"perlin", [](int w, int h, int octaves, float param, float scale) {
+        return NoiseGenerator::generatePerlin2D(w, h, octaves, param, scale);
+    }},
+    {"simplex", [](int w, int h, int octaves, float param, float scale) {
+        return NoiseGenerator::generateSimplex2D(w, h, octaves, param, scale);
+    }},
+    // FBM 的缩放固定为 4，scale 用作 lacunarity
+    {"fbm", [](int w, int h, int octaves, float param, float scale) {
+        return NoiseGenerator::generateFBM2D(w, h, octaves, scale, param);
+    }},
+};
+
+std::vector<float> generateWith(bool simd, const NoiseKind& kind, int size, int octaves, float param, float scale) {
+    NoiseGenerator::setSimdEnabled(simd);
+    std::vector<float> result = kind.generate(size, size, octaves, param, scale);
+    NoiseGenerator::setSimdEnabled(true);
+    return result;
+}
+
+// 逐位比较，返回不一致的样本数并打印第一个
+size_t compareBits(const NoiseKind& kind, int size, int octaves, float param, float scale) {
+    std::vector<float> scalar = generateWith(false, kind, size, octaves, param, scale);
+    std::vector<float> simd = generateWith(true, kind, size, octaves, param, scale);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < scalar.size(); i++) {
+        if (std::memcmp(&scalar[i], &simd[i], sizeof(float)) != 0) {
+            if (mismatches == 0) {
+                std::cerr << "MISMATCH " << kind.name << " size=" << size << " octaves=" << octaves
+                          << " param=" << param << " scale=" << scale
+                          << " at (" << (i % size) << ", " << (i / size) << "): scalar="
+                          << std::setprecision(9) << scalar[i] << " simd=" << simd[i] << std::endl;
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+double measureMedianMs(bool simd, const NoiseKind& kind, int size, double minSeconds, double& checksum) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> samples;
+    auto begin = Clock::now();
+    do {
+        auto start = Clock::now();
+        std::vector<float> out = generateWith(simd, kind, size, 4, 0.5f, 4.0f);
+        auto end = Clock::now();
+        checksum += out[out.size() / 2];
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    } while (std::chrono::duration<double>(Clock::now() - begin).count() < minSeconds || samples.size() < 5);
+
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double minSeconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+    if (minSeconds <= 0.0) {
+        minSeconds = 0.5;
+    }
+
+    if (!NoiseGenerator::isSimdAvailable()) {
+        std::cout << "SSE2 path not compiled, nothing to compare" << std::endl;
+    }
+
+    // 一致性检查
+    size_t cases = 0;
+    size_t failedCases = 0;
+    for (const NoiseKind& kind : KINDS) {
+        for (int size : {4, 61, 128, 257}) {
+            for (int octaves : {1, 4, 8}) {
+                for (float param : {0.5f, 0.37f}) {
+                    for (float scale : {1.0f, 4.0f, 2.0f, 37.3f}) {
+                        cases++;
+                        if (compareBits(kind, size, octaves, param, scale) > 0) {
+                            failedCases++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    std::cout << "bit-exact check: " << (cases - failedCases) << "/" << cases << " cases identical" << std::endl;
+
+    // 耗时对比
+    const int size = 1024;
+    std::cout << std::left << std::setw(10) << "noise"
+              << std::setw(14) << "scalar (ms)"
+              << std::setw(14) << "sse2 (ms)"
+              << "speedup" << std::endl;
+
+    double checksum = 0.0;
+    for (const NoiseKind& kind : KINDS) {
+        double scalarMs = measureMedianMs(false, kind, size, minSeconds, checksum);
+        double simdMs = measureMedianMs(true, kind, size, minSeconds, checksum);
+
+        std::cout << std::left << std::setw(10) << kind.name
+                  << std::setw(14) << std::fixed << std::setprecision(2) << scalarMs
+                  << std::setw(14) << simdMs
+                  << std::setprecision(2) << (scalarMs / simdMs) << std::endl;
+    }
+
+    // 防止优化掉结果
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    return failedCases == 0 ? 0 : 1;
+}
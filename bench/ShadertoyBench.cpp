@@ -0,0 +1,25 @@
+/**
+ * shadertoy-bench - 屏保 Profile 的命令行基准测试
+ *
+ * 无窗口渲染每个 Profile，输出编译时间、首帧延迟、帧时间分布和每个 Pass 的 GPU 时间
+ * 详见 BenchmarkRunner::printUsage()
+ */
+
+#include "core/BenchmarkRunner.h"
+
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    shadertoy::BenchmarkOptions options;
+    std::string error;
+    if (!shadertoy::BenchmarkRunner::parseArguments(argc, argv, options, error)) {
+        if (!error.empty()) {
+            std::cerr << "shadertoy-bench: " << error << "\n" << std::endl;
+        }
+        shadertoy::BenchmarkRunner::printUsage();
+        return error.empty() ? 0 : 2;
+    }
+
+    shadertoy::BenchmarkRunner runner;
+    return runner.run(options);
+}
@@ -0,0 +1,164 @@
+/**
+ * TranspilerBench - GLSLTranspiler 微基准
+ *
+ * 对比旧的 std::regex 实现（在此保留一份作为参考）和单遍扫描实现
+ * 在不同大小的 Shadertoy 源码上的耗时
+ *
+ * 用法: transpiler-bench [最短运行秒数，默认 0.5]
+ */
+
+#include "transpiler/GLSLTranspiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace shadertoy;
+
+namespace {
+
+// 旧实现：每次调用构造并执行 5 个 std::regex
+std::string transpileRegex(const std::string& shadertoyCode) {
+    std::string code = shadertoyCode;
+    code = std::regex_replace(code, std::regex(R"(#version\s+\d+(\s+\w+)?\s*)"), "");
+    code = std::regex_replace(code, std::regex(R"(precision\s+(lowp|mediump|highp)\s+\w+\s*;)"), "");
+    code = std::regex_replace(code, std::regex(R"(\btexture2D\s*\()"), "texture(");
+    code = std::regex_replace(code, std::regex(R"(\btextureCube\s*\()"), "texture(");
+    code = std::regex_replace(code, std::regex(R"(\btexture2DLod\s*\()"), "textureLod(");
+
+    std::string result = "#version 430 core\nout vec4 FragColor;\n\n";
+    result += GLSLTranspiler::getUniformDeclarations(false);
+    result += "\n" + code + "\n\n";
+    result += "\nvoid main() {\n    mainImage(FragColor, gl_FragCoord.xy);\n}\n";
+    return result;
+}
+
+// 典型 Shadertoy 代码片段：注释、宏、纹理采样、数学函数
+const char* SOURCE_HEADER = R"(#version 300 es
+precision highp float;
+precision mediump int;
+)";
+
+const char* SOURCE_CHUNK = R"(
+// ---------------------------------------------------------------------------
+// Raymarching helpers. texture2D() calls below are rewritten to texture().
+// ---------------------------------------------------------------------------
+#define MAX_STEPS 128
+#define SAMPLE(uv) texture2D(iChannel0, uv)
+#define saturate(x) clamp(x, 0.0, 1.0)
+
+/* Value noise from a 256x256 lookup texture,
+   see https://www.shadertoy.com/view/4sfGzS */
+float noise_@(in vec3 x) {
+    vec3 p = floor(x);
+    vec3 f = fract(x);
+    f = f * f * (3.0 - 2.0 * f);
+    vec2 uv = (p.xy + vec2(37.0, 17.0) * p.z) + f.xy;
+    vec2 rg = texture2DLod(iChannel0, (uv + 0.5) / 256.0, 0.0).yx;
+    return mix(rg.x, rg.y, f.z);
+}
+
+float map_@(vec3 p) {
+    float d = length(p) - 1.0;
+    d += 0.05 * noise_@(p * 4.0 + iTime);
+    vec4 env = textureCube(iChannel1, normalize(p));
+    return d - 0.01 * env.r + 1.5e-3;
+}
+
+vec3 normal_@(vec3 p) {
+    const vec2 e = vec2(1e-3, 0.0);
+    return normalize(vec3(map_@(p + e.xyy) - map_@(p - e.xyy),
+                          map_@(p + e.yxy) - map_@(p - e.yxy),
+                          map_@(p + e.yyx) - map_@(p - e.yyx)));
+}
+)";
+
+const char* SOURCE_FOOTER = R"(
+void mainImage(out vec4 fragColor, in vec2 fragCoord) {
+    vec2 uv = (2.0 * fragCoord - iResolution.xy) / iResolution.y;
+    vec3 ro = vec3(0.0, 0.0, 3.0);
+    vec3 rd = normalize(vec3(uv, -1.5));
+    float t = 0.0;
+    for (int i = 0; i < MAX_STEPS; i++) {
+        float d = map_0(ro + rd * t);
+        if (d < 1e-3) break;
+        t += d;
+    }
+    vec3 col = saturate(normal_0(ro + rd * t) * 0.5 + 0.5) * SAMPLE(uv).rgb;
+    fragColor = vec4(col, 1.0);
+}
+)";
+
+std::string makeSource(int chunks) {
+    std::string source = SOURCE_HEADER;
+    for (int i = 0; i < chunks; i++) {
+        std::string chunk = SOURCE_CHUNK;
+        std::string suffix = std::to_string(i);
+        size_t pos = 0;
+        while ((pos = chunk.find('@', pos)) != std::string::npos) {
+            chunk.replace(pos, 1, suffix);
+            pos += suffix.size();
+        }
+        source += chunk;
+    }
+    source += SOURCE_FOOTER;
+    return source;
+}
+
+// 重复运行直到超过最短时间，返回每次调用耗时的中位数（微秒）
+template <typename Fn>
+double measureMedianUs(Fn&& fn, double minSeconds, size_t& checksum) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> samples;
+    auto begin = Clock::now();
+    do {
+        auto start = Clock::now();
+        std::string out = fn();
+        auto end = Clock::now();
+        checksum += out.size();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    } while (std::chrono::duration<double>(Clock::now() - begin).count() < minSeconds || samples.size() < 5);
+
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double minSeconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+    if (minSeconds <= 0.0) {
+        minSeconds = 0.5;
+    }
+
+    std::cout << std::left << std::setw(10) << "chunks"
+              << std::setw(12) << "bytes"
+              << std::setw(14) << "regex (us)"
+              << std::setw(14) << "scan (us)"
+              << std::setw(10) << "speedup"
+              << "scan MB/s" << std::endl;
+
+    size_t checksum = 0;
+    for (int chunks : {1, 8, 64, 512}) {
+        std::string source = makeSource(chunks);
+
+        double regexUs = measureMedianUs([&] { return transpileRegex(source); }, minSeconds, checksum);
+        double scanUs = measureMedianUs([&] { return GLSLTranspiler::transpile(source); }, minSeconds, checksum);
+
+        std::cout << std::left << std::setw(10) << chunks
+                  << std::setw(12) << source.size()
+                  << std::setw(14) << std::fixed << std::setprecision(1) << regexUs
+                  << std::setw(14) << scanUs
+                  << std::setw(10) << std::setprecision(1) << (regexUs / scanUs)
+                  << std::setprecision(1) << (source.size() / scanUs) << std::endl;
+    }
+
+    // 防止优化掉结果
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,574 @@
+#include "BenchmarkRunner.h"
+#include "HeadlessRunner.h"
+#include "../renderer/MultiPassRenderer.h"
+#include "../utils/FileUtils.h"
+
+#include <glad/glad.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace shadertoy {
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 最近秩百分位（samples 必须已排序）
+double percentile(const std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(samples.size())));
+    rank = std::clamp<size_t>(rank, 1, samples.size());
+    return samples[rank - 1];
+}
+
+std::string csvEscape(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+        return value;
+    }
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"') escaped += '"';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+const ShaderPassType CSV_PASSES[] = {
+    ShaderPassType::BufferA, ShaderPassType::BufferB, ShaderPassType::BufferC,
+    ShaderPassType::BufferD, ShaderPassType::Image
+};
+
+} // namespace
+
+// ============================================================================
+// 命令行解析
+// ============================================================================
+
+void BenchmarkRunner::printUsage() {
+    std::cout <<
+        "Usage: shadertoy-bench <input> [options]\n"
+        "\n"
+        "  <input>               Screensaver config (.json), directory of .glsl files, or single shader\n"
+        "\n"
+        "Options:\n"
+        "  --frames N            Measured frames per resolution (default 300)\n"
+        "  --warmup N            Unmeasured frames after the first frame (default 10)\n"
+        "  --size WxH[,WxH...]   Resolutions to test (default 1280x720)\n"
+        "  --dt SECONDS          Fixed time step per frame (default 1/60)\n"
+        "  --profile INDEX       Only benchmark one profile of a .json config\n"
+        "  --json PATH           Write results as JSON ('-' for stdout)\n"
+        "  --csv PATH            Write results as CSV\n"
+        "  --baseline PATH       Compare p50 frame time with an earlier --json result\n"
+        "  --max-regression PCT  Allowed p50 slowdown against the baseline (default 10)\n"
+        "\n"
+        "Exit codes: 0 ok, 1 compile failure, 2 usage/context error, 4 regression over threshold\n"
+        << std::endl;
+}
+
+bool BenchmarkRunner::parseArguments(int argc, char* argv[], BenchmarkOptions& options, std::string& errorOut) {
+    bool sizesGiven = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto nextValue = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                errorOut = std::string("Missing value for ") + name;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        try {
+            if (arg == "--frames") {
+                const char* v = nextValue("--frames");
+                if (!v) return false;
+                options.frames = std::stoi(v);
+            } else if (arg == "--warmup") {
+                const char* v = nextValue("--warmup");
+                if (!v) return false;
+                options.warmupFrames = std::stoi(v);
+            } else if (arg == "--size") {
+                const char* v = nextValue("--size");
+                if (!v) return false;
+                if (!sizesGiven) {
+                    options.sizes.clear();
+                    sizesGiven = true;
+                }
+                std::stringstream list(v);
+                std::string item;
+                while (std::getline(list, item, ',')) {
+                    int w = 0, h = 0;
+                    if (std::sscanf(item.c_str(), "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0) {
+                        errorOut = "Invalid --size '" + item + "', expected WxH";
+                        return false;
+                    }
+                    options.sizes.emplace_back(w, h);
+                }
+            } else if (arg == "--dt") {
+                const char* v = nextValue("--dt");
+                if (!v) return false;
+                options.timeStep = std::stof(v);
+            } else if (arg == "--profile") {
+                const char* v = nextValue("--profile");
+                if (!v) return false;
+                options.profileIndex = std::stoi(v);
+            } else if (arg == "--json") {
+                const char* v = nextValue("--json");
+                if (!v) return false;
+                options.jsonPath = v;
+            } else if (arg == "--csv") {
+                const char* v = nextValue("--csv");
+                if (!v) return false;
+                options.csvPath = v;
+            } else if (arg == "--baseline") {
+                const char* v = nextValue("--baseline");
+                if (!v) return false;
+                options.baselinePath = v;
+            } else if (arg == "--max-regression") {
+                const char* v = nextValue("--max-regression");
+                if (!v) return false;
+                options.maxRegression = std::stod(v);
+            } else if (arg == "--help" || arg == "-h") {
+                errorOut.clear();
+                return false;
+            } else if (!arg.empty() && arg[0] == '-') {
+                errorOut = "Unknown option: " + arg;
+                return false;
+            } else if (options.inputPath.empty()) {
+                options.inputPath = arg;
+            } else {
+                errorOut = "Unexpected argument: " + arg;
+                return false;
+            }
+        } catch (...) {
+            errorOut = "Invalid value for " + arg;
+            return false;
+        }
+    }
+
+    if (options.inputPath.empty()) {
+        errorOut = "No input given";
+        return false;
+    }
+    if (options.frames <= 0 || options.warmupFrames < 0) {
+        errorOut = "--frames must be positive and --warmup must not be negative";
+        return false;
+    }
+    if (options.sizes.empty()) {
+        errorOut = "No resolution given";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// 输入
+// ============================================================================
+
+bool BenchmarkRunner::loadInputs(std::vector<std::pair<ScreensaverProfile, std::string>>& profilesOut,
+                                 std::string& errorOut) const {
+    const std::string& path = m_options.inputPath;
+    if (!fs::exists(path)) {
+        errorOut = "Input not found: " + path;
+        return false;
+    }
+
+    // 目录：每个 .glsl 文件作为单 Pass Profile，按文件名排序保证结果顺序稳定
+    if (fs::is_directory(path)) {
+        std::vector<fs::path> files;
+        for (const auto& entry : fs::directory_iterator(path)) {
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (entry.is_regular_file() && ext == ".glsl") {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files) {
+            std::string code = FileUtils::readFile(file.string());
+            if (code.empty()) {
+                std::cerr << "BenchmarkRunner: Skipping empty " << file.string() << std::endl;
+                continue;
+            }
+            profilesOut.emplace_back(ScreensaverProfile(file.stem().string(), code), file.string());
+        }
+        if (profilesOut.empty()) {
+            errorOut = "No .glsl files in " + path;
+            return false;
+        }
+        return true;
+    }
+
+    std::string ext = FileUtils::getFileExtension(path);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == ".json") {
+        ScreensaverMode::initBuiltinShaders();
+
+        ScreensaverConfig config;
+        if (!ScreensaverMode::loadConfigFromFile(path, config) || config.profiles.empty()) {
+            errorOut = "Failed to load profiles from " + path;
+            return false;
+        }
+
+        if (m_options.profileIndex >= 0) {
+            if (m_options.profileIndex >= static_cast<int>(config.profiles.size())) {
+                errorOut = "Profile index " + std::to_string(m_options.profileIndex) + " out of range (" +
+                           std::to_string(config.profiles.size()) + " profiles)";
+                return false;
+            }
+            profilesOut.emplace_back(config.profiles[static_cast<size_t>(m_options.profileIndex)], path);
+            return true;
+        }
+
+        for (const auto& profile : config.profiles) {
+            profilesOut.emplace_back(profile, path);
+        }
+        return true;
+    }
+
+    std::string code = FileUtils::readFile(path);
+    if (code.empty()) {
+        errorOut = "Failed to read shader: " + path;
+        return false;
+    }
+    profilesOut.emplace_back(ScreensaverProfile(FileUtils::getFileName(path), code), path);
+    return true;
+}
+
+// ============================================================================
+// 运行
+// ============================================================================
+
+int BenchmarkRunner::run(const BenchmarkOptions& options) {
+    m_options = options;
+    m_results.clear();
+
+    // --json - 时 stdout 只输出 JSON，日志和汇总全部改到 stderr
+    m_stdout = options.jsonPath == "-" ? std::cout.rdbuf(std::cerr.rdbuf()) : nullptr;
+    struct CoutRestore {
+        std::streambuf*& buf;
+        ~CoutRestore() {
+            if (buf) std::cout.rdbuf(buf);
+            buf = nullptr;
+        }
+    } coutRestore{m_stdout};
+
+    std::string error;
+    std::vector<std::pair<ScreensaverProfile, std::string>> profiles;
+    if (!loadInputs(profiles, error)) {
+        std::cerr << "BenchmarkRunner: " << error << std::endl;
+        return 2;
+    }
+
+    HeadlessOptions headless;
+    headless.inputPath = options.inputPath;
+    headless.width = options.sizes.front().first;
+    headless.height = options.sizes.front().second;
+    headless.timeStep = options.timeStep;
+    headless.writeEvery = 0;
+
+    HeadlessRunner runner;
+    if (!runner.init(headless, error)) {
+        std::cerr << "BenchmarkRunner: " << error << std::endl;
+        return 2;
+    }
+    m_rendererName = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    m_versionString = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    m_backendName = runner.getContext().getBackendName();
+
+    MultiPassRenderer* multiPass = runner.getMultiPassRenderer();
+    multiPass->setProfilingEnabled(true);
+
+    bool anyFailed = false;
+    for (const auto& [profile, source] : profiles) {
+        std::cout << "BenchmarkRunner: " << profile.name << std::endl;
+
+        // 每个 Profile 从空的渲染器开始，避免相同源码的 Pass 被复用而跳过编译
+        int width = options.sizes.front().first;
+        int height = options.sizes.front().second;
+        if (!runner.resize(width, height, error)) {
+            std::cerr << "BenchmarkRunner: " << error << std::endl;
+            return 2;
+        }
+        multiPass->cleanup();
+        multiPass->init(width, height);
+
+        auto compileStart = std::chrono::steady_clock::now();
+        bool compiled = runner.loadProfile(profile, error);
+        glFinish();
+        double compileMs = elapsedMs(compileStart);
+
+        for (const auto& [w, h] : options.sizes) {
+            BenchmarkResult result;
+            result.profile = profile.name;
+            result.source = source;
+            result.width = w;
+            result.height = h;
+            result.compileMs = compileMs;
+
+            if (!compiled) {
+                result.error = error;
+                anyFailed = true;
+                m_results.push_back(result);
+                continue;
+            }
+            if (!runner.resize(w, h, error)) {
+                result.error = error;
+                anyFailed = true;
+                m_results.push_back(result);
+                continue;
+            }
+
+            // 首帧：编译后的第一次绘制，驱动常在此时完成延迟的编译和资源分配
+            auto firstStart = std::chrono::steady_clock::now();
+            runner.renderFrame(0);
+            glFinish();
+            result.firstFrameMs = elapsedMs(firstStart);
+
+            int frame = 1;
+            for (int i = 0; i < options.warmupFrames; i++, frame++) {
+                runner.renderFrame(frame);
+            }
+            glFinish();
+            multiPass->flushProfiling();
+            multiPass->resetProfiling();
+
+            std::vector<double> frameMs;
+            frameMs.reserve(static_cast<size_t>(options.frames));
+            for (int i = 0; i < options.frames; i++, frame++) {
+                auto frameStart = std::chrono::steady_clock::now();
+                runner.renderFrame(frame);
+                glFinish();
+                frameMs.push_back(elapsedMs(frameStart));
+            }
+            multiPass->flushProfiling();
+
+            double sum = 0.0;
+            for (double ms : frameMs) sum += ms;
+            std::sort(frameMs.begin(), frameMs.end());
+            result.meanMs = sum / static_cast<double>(frameMs.size());
+            result.p50Ms = percentile(frameMs, 50.0);
+            result.p99Ms = percentile(frameMs, 99.0);
+            result.minMs = frameMs.front();
+            result.maxMs = frameMs.back();
+
+            for (const auto& timing : multiPass->getProfiler().getTimings()) {
+                if (timing.gpuSamples == 0) continue;
+                double mean = timing.gpuTotalMs / timing.gpuSamples;
+                result.passGpuMs.emplace_back(timing.type, mean);
+                result.gpuTotalMs += mean;
+            }
+
+            result.ok = true;
+            m_results.push_back(result);
+        }
+    }
+
+    runner.shutdown();
+
+    printSummary();
+
+    if (!options.jsonPath.empty() && !writeJson(options.jsonPath, error)) {
+        std::cerr << "BenchmarkRunner: " << error << std::endl;
+        return 2;
+    }
+    if (!options.csvPath.empty() && !writeCsv(options.csvPath, error)) {
+        std::cerr << "BenchmarkRunner: " << error << std::endl;
+        return 2;
+    }
+
+    if (!options.baselinePath.empty()) {
+        int regressions = compareBaseline(error);
+        if (regressions < 0) {
+            std::cerr << "BenchmarkRunner: " << error << std::endl;
+            return 2;
+        }
+        if (regressions > 0) {
+            return 4;
+        }
+    }
+
+    return anyFailed ? 1 : 0;
+}
+
+// ============================================================================
+// 输出
+// ============================================================================
+
+void BenchmarkRunner::printSummary() const {
+    std::cout << "\n" << std::left
+              << std::setw(28) << "profile" << std::setw(11) << "size"
+              << std::right
+              << std::setw(10) << "compile" << std::setw(10) << "first"
+              << std::setw(9) << "mean" << std::setw(9) << "p50" << std::setw(9) << "p99"
+              << std::setw(9) << "gpu" << "  (ms)" << std::endl;
+
+    for (const auto& r : m_results) {
+        std::string size = std::to_string(r.width) + "x" + std::to_string(r.height);
+        std::cout << std::left << std::setw(28) << r.profile.substr(0, 27) << std::setw(11) << size;
+        if (!r.ok) {
+            std::cout << "FAILED" << std::endl;
+            continue;
+        }
+        std::cout << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << r.compileMs << std::setw(10) << r.firstFrameMs
+                  << std::setw(9) << r.meanMs << std::setw(9) << r.p50Ms << std::setw(9) << r.p99Ms
+                  << std::setw(9) << r.gpuTotalMs << std::endl;
+    }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+bool BenchmarkRunner::writeJson(const std::string& path, std::string& errorOut) const {
+    nlohmann::json results = nlohmann::json::array();
+    for (const auto& r : m_results) {
+        nlohmann::json passes = nlohmann::json::object();
+        for (const auto& [type, ms] : r.passGpuMs) {
+            passes[PassConfig::getTypeName(type)] = ms;
+        }
+        results.push_back({
+            {"profile", r.profile},
+            {"source", r.source},
+            {"width", r.width},
+            {"height", r.height},
+            {"ok", r.ok},
+            {"error", r.error},
+            {"compileMs", r.compileMs},
+            {"firstFrameMs", r.firstFrameMs},
+            {"frameMs", {
+                {"mean", r.meanMs}, {"p50", r.p50Ms}, {"p99", r.p99Ms},
+                {"min", r.minMs}, {"max", r.maxMs}
+            }},
+            {"gpuMs", passes},
+            {"gpuTotalMs", r.gpuTotalMs}
+        });
+    }
+
+    nlohmann::json root = {
+        {"renderer", m_rendererName},
+        {"version", m_versionString},
+        {"backend", m_backendName},
+        {"frames", m_options.frames},
+        {"warmupFrames", m_options.warmupFrames},
+        {"timeStep", m_options.timeStep},
+        {"results", results}
+    };
+
+    if (path == "-") {
+        std::ostream out(m_stdout ? m_stdout : std::cout.rdbuf());
+        out << root.dump(2) << std::endl;
+        if (!out.good()) {
+            errorOut = "Failed to write JSON to stdout";
+            return false;
+        }
+        return true;
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        errorOut = "Cannot open " + path;
+        return false;
+    }
+    file << root.dump(2) << std::endl;
+    if (!file.good()) {
+        errorOut = "Failed to write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool BenchmarkRunner::writeCsv(const std::string& path, std::string& errorOut) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        errorOut = "Cannot open " + path;
+        return false;
+    }
+
+    file << "profile,width,height,ok,compile_ms,first_frame_ms,mean_ms,p50_ms,p99_ms,min_ms,max_ms,gpu_total_ms";
+    for (ShaderPassType type : CSV_PASSES) {
+        std::string name = PassConfig::getTypeName(type);
+        std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+            return c == ' ' ? '_' : static_cast<char>(::tolower(c));
+        });
+        file << ",gpu_" << name << "_ms";
+    }
+    file << "\n";
+
+    for (const auto& r : m_results) {
+        file << csvEscape(r.profile) << "," << r.width << "," << r.height << "," << (r.ok ? 1 : 0)
+             << "," << r.compileMs << "," << r.firstFrameMs << "," << r.meanMs << "," << r.p50Ms
+             << "," << r.p99Ms << "," << r.minMs << "," << r.maxMs << "," << r.gpuTotalMs;
+        for (ShaderPassType type : CSV_PASSES) {
+            file << ",";
+            for (const auto& [passType, ms] : r.passGpuMs) {
+                if (passType == type) file << ms;
+            }
+        }
+        file << "\n";
+    }
+    if (!file.good()) {
+        errorOut = "Failed to write " + path;
+        return false;
+    }
+    return true;
+}
+
+int BenchmarkRunner::compareBaseline(std::string& errorOut) const {
+    std::ifstream file(m_options.baselinePath);
+    if (!file.is_open()) {
+        errorOut = "Cannot open baseline " + m_options.baselinePath;
+        return -1;
+    }
+
+    nlohmann::json baseline;
+    try {
+        file >> baseline;
+    } catch (const std::exception& e) {
+        errorOut = std::string("Invalid baseline JSON: ") + e.what();
+        return -1;
+    }
+
+    int regressions = 0;
+    for (const auto& r : m_results) {
+        if (!r.ok) continue;
+        for (const auto& entry : baseline.value("results", nlohmann::json::array())) {
+            if (entry.value("profile", "") != r.profile || entry.value("width", 0) != r.width ||
+                entry.value("height", 0) != r.height || !entry.value("ok", false)) {
+                continue;
+            }
+            double before = entry.value("frameMs", nlohmann::json::object()).value("p50", 0.0);
+            if (before <= 0.0) break;
+
+            double change = (r.p50Ms - before) / before * 100.0;
+            if (change > m_options.maxRegression) {
+                std::cout << "REGRESSION " << r.profile << " " << r.width << "x" << r.height
+                          << ": p50 " << before << " -> " << r.p50Ms << " ms (+"
+                          << std::fixed << std::setprecision(1) << change << "%)"
+                          << std::defaultfloat << std::endl;
+                regressions++;
+            }
+            break;
+        }
+    }
+
+    std::cout << "BenchmarkRunner: " << regressions << " regression(s) over "
+              << m_options.maxRegression << "% against " << m_options.baselinePath << std::endl;
+    return regressions;
+}
+
+} // namespace shadertoy
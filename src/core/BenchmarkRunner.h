@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ScreensaverMode.h"
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shadertoy {
+
+// 基准测试参数
+struct BenchmarkOptions {
+    std::string inputPath;                  // .json 屏保配置、.glsl 目录或单个 shader 文件
+    int profileIndex = -1;                  // 只测 .json 中的一个 Profile（-1 = 全部）
+    std::vector<std::pair<int, int>> sizes = {{1280, 720}};
+    int frames = 300;                       // 每个分辨率统计的帧数
+    int warmupFrames = 10;                  // 不计入统计的预热帧（第 0 帧另计为首帧延迟）
+    float timeStep = 1.0f / 60.0f;          // 固定时间步长（秒）
+    std::string jsonPath;                   // 结果 JSON（"-" = 标准输出）
+    std::string csvPath;                    // 结果 CSV
+    std::string baselinePath;               // 对比的基准 JSON（之前一次的 --json 输出）
+    double maxRegression = 10.0;            // 允许 p50 帧时间比基准慢的百分比
+};
+
+// 单个 Profile 在单个分辨率下的结果
+struct BenchmarkResult {
+    std::string profile;
+    std::string source;
+    int width = 0;
+    int height = 0;
+    bool ok = false;
+    std::string error;
+    double compileMs = 0.0;                 // loadProfile 到所有 Pass 可用
+    double firstFrameMs = 0.0;              // 编译后第一帧（含驱动的延迟初始化）
+    double meanMs = 0.0;                    // 帧时间：提交到 glFinish 返回
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    std::vector<std::pair<ShaderPassType, double>> passGpuMs;  // 每个 Pass 的平均 GPU 时间
+    double gpuTotalMs = 0.0;
+};
+
+// 命令行基准测试
+// 复用 HeadlessRunner 的上下文和渲染路径，逐个 Profile、逐个分辨率固定帧数渲染并统计帧时间
+// 每帧都 glFinish，帧时间反映 GPU 实际耗时而不是提交速度
+class BenchmarkRunner {
+public:
+    static bool parseArguments(int argc, char* argv[], BenchmarkOptions& options, std::string& errorOut);
+    static void printUsage();
+
+    // @return 进程退出码：0 = 成功，1 = 有 Profile 编译失败，2 = 参数/环境错误，4 = 超出回归阈值
+    int run(const BenchmarkOptions& options);
+
+private:
+    // 读取输入中的所有 Profile（source 为来源文件）
+    bool loadInputs(std::vector<std::pair<ScreensaverProfile, std::string>>& profilesOut,
+                    std::string& errorOut) const;
+
+    bool writeJson(const std::string& path, std::string& errorOut) const;
+    bool writeCsv(const std::string& path, std::string& errorOut) const;
+
+    // 与基准 JSON 对比，输出回归的条目
+    // @return 回归数量，-1 表示无法读取基准
+    int compareBaseline(std::string& errorOut) const;
+
+    void printSummary() const;
+
+    BenchmarkOptions m_options;
+    std::vector<BenchmarkResult> m_results;
+    std::string m_rendererName;
+    std::string m_versionString;
+    std::string m_backendName;
+    std::streambuf* m_stdout = nullptr;  // --json - 时保存的 stdout（std::cout 在运行期间指向 stderr）
+};
+
+} // namespace shadertoy
@@ -0,0 +1,71 @@
+#include "BufferSettings.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace shadertoy {
+
+void BufferSettings::resolveSize(int windowWidth, int windowHeight, int& widthOut, int& heightOut) const {
+    if (fixedWidth > 0 && fixedHeight > 0) {
+        widthOut = fixedWidth;
+        heightOut = fixedHeight;
+        return;
+    }
+
+    float s = scale > 0.0f ? scale : 1.0f;
+    widthOut = std::max(1, static_cast<int>(std::lround(windowWidth * s)));
+    heightOut = std::max(1, static_cast<int>(std::lround(windowHeight * s)));
+}
+
+int BufferSettings::getBytesPerPixel() const {
+    switch (format) {
+        case BufferFormat::RGBA16F: return 8;
+        case BufferFormat::RGBA8: return 4;
+        case BufferFormat::R32F: return 4;
+        default: return 16;
+    }
+}
+
+const char* BufferSettings::formatToString(BufferFormat format) {
+    switch (format) {
+        case BufferFormat::RGBA16F: return "rgba16f";
+        case BufferFormat::RGBA8: return "rgba8";
+        case BufferFormat::R32F: return "r32f";
+        default: return "rgba32f";
+    }
+}
+
+BufferFormat BufferSettings::stringToFormat(const std::string& str) {
+    if (str == "rgba16f") return BufferFormat::RGBA16F;
+    if (str == "rgba8") return BufferFormat::RGBA8;
+    if (str == "r32f") return BufferFormat::R32F;
+    return BufferFormat::RGBA32F;
+}
+
+bool BufferSettings::operator==(const BufferSettings& other) const {
+    return format == other.format && scale == other.scale &&
+           fixedWidth == other.fixedWidth && fixedHeight == other.fixedHeight &&
+           linearFilter == other.linearFilter && repeatWrap == other.repeatWrap;
+}
+
+void to_json(nlohmann::json& j, const BufferSettings& s) {
+    j = nlohmann::json{
+        {"format", BufferSettings::formatToString(s.format)},
+        {"scale", s.scale},
+        {"width", s.fixedWidth},
+        {"height", s.fixedHeight},
+        {"filter", s.linearFilter ? "linear" : "nearest"},
+        {"wrap", s.repeatWrap ? "repeat" : "clamp"}
+    };
+}
+
+void from_json(const nlohmann::json& j, BufferSettings& s) {
+    if (j.contains("format")) s.format = BufferSettings::stringToFormat(j["format"].get<std::string>());
+    if (j.contains("scale")) s.scale = j["scale"].get<float>();
+    if (j.contains("width")) s.fixedWidth = j["width"].get<int>();
+    if (j.contains("height")) s.fixedHeight = j["height"].get<int>();
+    if (j.contains("filter")) s.linearFilter = j["filter"].get<std::string>() != "nearest";
+    if (j.contains("wrap")) s.repeatWrap = j["wrap"].get<std::string>() == "repeat";
+}
+
+} // namespace shadertoy
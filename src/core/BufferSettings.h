@@ -0,0 +1,42 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace shadertoy {
+
+// Buffer 渲染目标的纹理格式
+enum class BufferFormat {
+    RGBA32F,        // 默认，与 Shadertoy 一致
+    RGBA16F,        // 半精度，多数模糊/反馈效果足够
+    RGBA8,          // 8 位定点，只适合 [0,1] 范围的颜色
+    R32F            // 单通道浮点（高度场、SDF 等），读取时 gba = (0,0,1)
+};
+
+// 单个 Buffer Pass 的渲染目标设置
+struct BufferSettings {
+    BufferFormat format = BufferFormat::RGBA32F;
+    float scale = 1.0f;             // 相对窗口分辨率的缩放（如 0.5 / 0.25）
+    int fixedWidth = 0;             // > 0 时使用固定尺寸，忽略 scale
+    int fixedHeight = 0;
+    bool linearFilter = true;       // false = GL_NEAREST
+    bool repeatWrap = false;        // false = GL_CLAMP_TO_EDGE
+
+    // 根据窗口尺寸计算实际渲染尺寸（至少 1x1）
+    void resolveSize(int windowWidth, int windowHeight, int& widthOut, int& heightOut) const;
+
+    // 每像素字节数（用于显存统计）
+    int getBytesPerPixel() const;
+
+    static const char* formatToString(BufferFormat format);
+    static BufferFormat stringToFormat(const std::string& str);
+
+    bool operator==(const BufferSettings& other) const;
+    bool operator!=(const BufferSettings& other) const { return !(*this == other); }
+};
+
+// JSON 序列化（缺省字段保持默认值，兼容旧配置）
+void to_json(nlohmann::json& j, const BufferSettings& s);
+void from_json(const nlohmann::json& j, BufferSettings& s);
+
+} // namespace shadertoy
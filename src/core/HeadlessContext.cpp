@@ -0,0 +1,241 @@
+#include "HeadlessContext.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#ifdef SHADERTOY_HAS_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <cstring>
+#include <iostream>
+
+namespace shadertoy {
+
+HeadlessContext::~HeadlessContext() {
+    shutdown();
+}
+
+const char* HeadlessContext::getBackendName() const {
+    switch (m_backend) {
+        case Backend::EGLSurfaceless: return "EGL (surfaceless)";
+        case Backend::HiddenWindow: return "GLFW (hidden window)";
+        default: return "None";
+    }
+}
+
+bool HeadlessContext::init(int glMajor, int glMinor, std::string& errorOut) {
+    shutdown();
+
+    std::string eglError;
+    if (initEGL(glMajor, glMinor, eglError)) {
+        return true;
+    }
+    if (!eglError.empty()) {
+        std::cout << "HeadlessContext: EGL unavailable (" << eglError
+                  << "), falling back to hidden GLFW window" << std::endl;
+    }
+
+    if (initHiddenWindow(glMajor, glMinor, errorOut)) {
+        return true;
+    }
+
+    if (!eglError.empty()) {
+        errorOut = eglError + "; " + errorOut;
+    }
+    return false;
+}
+
+// ============================================================================
+// EGL surfaceless
+// ============================================================================
+
+#ifdef SHADERTOY_HAS_EGL
+
+static bool hasExtension(const char* extensions, const char* name) {
+    if (!extensions) return false;
+    size_t len = std::strlen(name);
+    const char* p = extensions;
+    while ((p = std::strstr(p, name)) != nullptr) {
+        if ((p == extensions || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0')) {
+            return true;
+        }
+        p += len;
+    }
+    return false;
+}
+
+bool HeadlessContext::initEGL(int glMajor, int glMinor, std::string& errorOut) {
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // 优先使用 Mesa surfaceless 平台，不依赖 X11/Wayland
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay && hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        errorOut = "no EGL display";
+        return false;
+    }
+
+    EGLint eglMajor = 0, eglMinor = 0;
+    if (!eglInitialize(display, &eglMajor, &eglMinor)) {
+        errorOut = "eglInitialize failed";
+        return false;
+    }
+
+    const char* displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!hasExtension(displayExtensions, "EGL_KHR_surfaceless_context")) {
+        eglTerminate(display);
+        errorOut = "EGL_KHR_surfaceless_context not supported";
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        eglTerminate(display);
+        errorOut = "eglBindAPI(EGL_OPENGL_API) failed";
+        return false;
+    }
+
+    // 所有渲染都进入 FBO，配置只需要支持桌面 OpenGL
+    const EGLint configAttribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+        if (hasExtension(displayExtensions, "EGL_KHR_no_config_context")) {
+            config = EGL_NO_CONFIG_KHR;
+        } else {
+            eglTerminate(display);
+            errorOut = "no suitable EGLConfig";
+            return false;
+        }
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR, glMajor,
+        EGL_CONTEXT_MINOR_VERSION_KHR, glMinor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) {
+        eglTerminate(display);
+        errorOut = "eglCreateContext failed for OpenGL " +
+                   std::to_string(glMajor) + "." + std::to_string(glMinor) + " core";
+        return false;
+    }
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        errorOut = "eglMakeCurrent failed";
+        return false;
+    }
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        errorOut = "failed to load OpenGL functions through EGL";
+        return false;
+    }
+
+    m_eglDisplay = display;
+    m_eglContext = context;
+    m_backend = Backend::EGLSurfaceless;
+
+    std::cout << "HeadlessContext: EGL " << eglMajor << "." << eglMinor
+              << " surfaceless context" << std::endl;
+    return true;
+}
+
+#else
+
+bool HeadlessContext::initEGL(int glMajor, int glMinor, std::string& errorOut) {
+    (void)glMajor; (void)glMinor; (void)errorOut;
+    return false;
+}
+
+#endif
+
+// ============================================================================
+// 隐藏 GLFW 窗口回退
+// ============================================================================
+
+bool HeadlessContext::initHiddenWindow(int glMajor, int glMinor, std::string& errorOut) {
+    if (!glfwInit()) {
+        errorOut = "glfwInit failed (no display available?)";
+        return false;
+    }
+    m_ownsGlfw = true;
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, glMajor);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, glMinor);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+    m_window = glfwCreateWindow(1, 1, "LocalShadertoy Headless", nullptr, nullptr);
+    if (!m_window) {
+        shutdown();
+        errorOut = "failed to create hidden GLFW window";
+        return false;
+    }
+
+    glfwMakeContextCurrent(m_window);
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+        shutdown();
+        errorOut = "failed to initialize GLAD";
+        return false;
+    }
+
+    m_backend = Backend::HiddenWindow;
+    return true;
+}
+
+void HeadlessContext::shutdown() {
+#ifdef SHADERTOY_HAS_EGL
+    if (m_eglDisplay) {
+        EGLDisplay display = static_cast<EGLDisplay>(m_eglDisplay);
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_eglContext) {
+            eglDestroyContext(display, static_cast<EGLContext>(m_eglContext));
+        }
+        eglTerminate(display);
+    }
+#endif
+    m_eglDisplay = nullptr;
+    m_eglContext = nullptr;
+
+    if (m_window) {
+        glfwDestroyWindow(m_window);
+        m_window = nullptr;
+    }
+    if (m_ownsGlfw) {
+        glfwTerminate();
+        m_ownsGlfw = false;
+    }
+
+    m_backend = Backend::None;
+}
+
+} // namespace shadertoy
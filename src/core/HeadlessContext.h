@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+
+struct GLFWwindow;
+
+namespace shadertoy {
+
+// 无窗口 OpenGL 上下文
+// 优先使用 EGL surfaceless（Mesa llvmpipe 在无显示器、无 GPU 的机器上即可提供），
+// EGL 不可用时回退到隐藏的 GLFW 窗口
+class HeadlessContext {
+public:
+    enum class Backend {
+        None,
+        EGLSurfaceless,     // EGL + EGL_MESA_platform_surfaceless / EGL_KHR_surfaceless_context
+        HiddenWindow        // 不可见的 GLFW 窗口（需要显示服务器）
+    };
+
+    HeadlessContext() = default;
+    ~HeadlessContext();
+
+    // 禁止拷贝
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // 创建 Core Profile 上下文并加载 GLAD
+    bool init(int glMajor, int glMinor, std::string& errorOut);
+
+    // 销毁上下文
+    void shutdown();
+
+    bool isValid() const { return m_backend != Backend::None; }
+    Backend getBackend() const { return m_backend; }
+    const char* getBackendName() const;
+
+private:
+    bool initEGL(int glMajor, int glMinor, std::string& errorOut);
+    bool initHiddenWindow(int glMajor, int glMinor, std::string& errorOut);
+
+    Backend m_backend = Backend::None;
+
+    // EGL 句柄（使用 void* 避免在头文件中引入 EGL）
+    void* m_eglDisplay = nullptr;
+    void* m_eglContext = nullptr;
+
+    // 隐藏窗口回退
+    GLFWwindow* m_window = nullptr;
+    bool m_ownsGlfw = false;
+};
+
+} // namespace shadertoy
@@ -0,0 +1,412 @@
+#include "HeadlessRunner.h"
+#include "../renderer/MultiPassRenderer.h"
+#include "../renderer/Renderer.h"
+#include "../renderer/Framebuffer.h"
+#include "../renderer/TextureManager.h"
+#include "../utils/FileUtils.h"
+
+#include <glad/glad.h>
+
+// stb_image_write 的实现放在这里，FrameCapture 的写出线程使用
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace shadertoy {
+
+HeadlessRunner::HeadlessRunner() = default;
+
+HeadlessRunner::~HeadlessRunner() {
+    shutdown();
+}
+
+// ============================================================================
+// 命令行解析
+// ============================================================================
+
+void HeadlessRunner::printUsage() {
+    std::cout <<
+        "Usage: LocalShadertoy --headless <input> [options]\n"
+        "\n"
+        "  <input>            Screensaver config (.json) or single shader file\n"
+        "\n"
+        "Options:\n"
+        "  --frames N         Number of frames to render (default 60)\n"
+        "  --size WxH         Render resolution (default 1280x720)\n"
+        "  --dt SECONDS       Fixed time step per frame (default 1/60)\n"
+        "  --start SECONDS    iTime of frame 0 (default 0)\n"
+        "  --profile INDEX    Profile index in a .json config (default: active profile)\n"
+        "  --out DIR          Output directory for frame files (default headless_out)\n"
+        "  --format FORMAT    png, exr (32-bit float), raw (RGBA8) files in --out,\n"
+        "                     or y4m / rgba streamed to stdout (default png)\n"
+        "  --buffer A-D       Capture a buffer instead of the Image output\n"
+        "  --every N          Write every Nth frame; the last frame is always written (default 1)\n"
+        "  --no-write         Render only, do not write any frames\n"
+        << std::endl;
+}
+
+bool HeadlessRunner::parseArguments(int argc, char* argv[], HeadlessOptions& options, std::string& errorOut) {
+    // argv[1] 为 --headless
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        auto nextValue = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                errorOut = std::string("Missing value for ") + name;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        try {
+            if (arg == "--frames") {
+                const char* v = nextValue("--frames");
+                if (!v) return false;
+                options.frames = std::stoi(v);
+            } else if (arg == "--size") {
+                const char* v = nextValue("--size");
+                if (!v) return false;
+                int w = 0, h = 0;
+                if (std::sscanf(v, "%dx%d", &w, &h) != 2) {
+                    errorOut = std::string("Invalid --size '") + v + "', expected WxH";
+                    return false;
+                }
+                options.width = w;
+                options.height = h;
+            } else if (arg == "--dt") {
+                const char* v = nextValue("--dt");
+                if (!v) return false;
+                options.timeStep = std::stof(v);
+            } else if (arg == "--start") {
+                const char* v = nextValue("--start");
+                if (!v) return false;
+                options.startTime = std::stof(v);
+            } else if (arg == "--profile") {
+                const char* v = nextValue("--profile");
+                if (!v) return false;
+                options.profileIndex = std::stoi(v);
+            } else if (arg == "--out") {
+                const char* v = nextValue("--out");
+                if (!v) return false;
+                options.outputDir = v;
+            } else if (arg == "--every") {
+                const char* v = nextValue("--every");
+                if (!v) return false;
+                options.writeEvery = std::stoi(v);
+            } else if (arg == "--format") {
+                const char* v = nextValue("--format");
+                if (!v) return false;
+                options.format = CaptureSettings::stringToFormat(v);
+                if (options.format == CaptureFormat::Count) {
+                    errorOut = std::string("Unknown --format '") + v + "'";
+                    return false;
+                }
+            } else if (arg == "--buffer") {
+                const char* v = nextValue("--buffer");
+                if (!v) return false;
+                char c = static_cast<char>(std::toupper(static_cast<unsigned char>(v[0])));
+                if (c < 'A' || c > 'D' || v[1] != '\0') {
+                    errorOut = std::string("Invalid --buffer '") + v + "', expected A-D";
+                    return false;
+                }
+                options.captureSource = c - 'A';
+            } else if (arg == "--no-write") {
+                options.writeEvery = 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                errorOut = "Unknown option: " + arg;
+                return false;
+            } else if (options.inputPath.empty()) {
+                options.inputPath = arg;
+            } else {
+                errorOut = "Unexpected argument: " + arg;
+                return false;
+            }
+        } catch (...) {
+            errorOut = "Invalid value for " + arg;
+            return false;
+        }
+    }
+
+    if (options.inputPath.empty()) {
+        errorOut = "No input file given";
+        return false;
+    }
+    if (options.width <= 0 || options.height <= 0) {
+        errorOut = "Resolution must be positive";
+        return false;
+    }
+    if (options.frames <= 0) {
+        errorOut = "--frames must be positive";
+        return false;
+    }
+    if (options.timeStep < 0.0f || options.writeEvery < 0) {
+        errorOut = "--dt and --every must not be negative";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// 初始化
+// ============================================================================
+
+bool HeadlessRunner::init(const HeadlessOptions& options, std::string& errorOut) {
+    m_options = options;
+
+    if (!m_context.init(4, 3, errorOut)) {
+        return false;
+    }
+
+    std::cout << "HeadlessRunner: Context " << m_context.getBackendName() << std::endl;
+    std::cout << "HeadlessRunner: Renderer " << glGetString(GL_RENDERER)
+              << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+
+    m_renderer = std::make_unique<Renderer>();
+    if (!m_renderer->init()) {
+        errorOut = "Failed to initialize renderer";
+        return false;
+    }
+
+    if (!TextureManager::instance().init()) {
+        std::cerr << "HeadlessRunner: Warning: failed to initialize some builtin textures" << std::endl;
+    }
+
+    m_output = std::make_unique<Framebuffer>();
+    if (!m_output->create(options.width, options.height)) {
+        errorOut = "Failed to create output framebuffer";
+        return false;
+    }
+
+    m_multiPass = std::make_unique<MultiPassRenderer>();
+    m_multiPass->init(options.width, options.height);
+    m_multiPass->setOutputFramebuffer(m_output->getFBO());
+
+    // 日期在启动时固定，之后只随 iTime 推进，保证同一批次内逐帧可复现
+    m_uniforms.updateDate();
+    m_startDate = m_uniforms.getUniforms().iDate;
+
+    return true;
+}
+
+bool HeadlessRunner::loadInput(ScreensaverProfile& profileOut, std::string& errorOut) const {
+    const std::string& path = m_options.inputPath;
+    if (!fs::exists(path)) {
+        errorOut = "Input not found: " + path;
+        return false;
+    }
+
+    std::string ext = FileUtils::getFileExtension(path);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == ".json") {
+        ScreensaverMode::initBuiltinShaders();
+
+        ScreensaverConfig config;
+        if (!ScreensaverMode::loadConfigFromFile(path, config) || config.profiles.empty()) {
+            errorOut = "Failed to load profiles from " + path;
+            return false;
+        }
+
+        int index = m_options.profileIndex >= 0 ? m_options.profileIndex : config.activeProfileIndex;
+        if (index < 0 || index >= static_cast<int>(config.profiles.size())) {
+            errorOut = "Profile index " + std::to_string(index) + " out of range (" +
+                       std::to_string(config.profiles.size()) + " profiles)";
+            return false;
+        }
+        profileOut = config.profiles[static_cast<size_t>(index)];
+        return true;
+    }
+
+    // 其他扩展名按单个 Image Pass 处理
+    std::string code = FileUtils::readFile(path);
+    if (code.empty()) {
+        errorOut = "Failed to read shader: " + path;
+        return false;
+    }
+    profileOut = ScreensaverProfile(FileUtils::getFileName(path), code);
+    return true;
+}
+
+bool HeadlessRunner::loadProfile(const ScreensaverProfile& profile, std::string& errorOut) {
+    m_timeScale = profile.timeScale > 0.0f ? profile.timeScale : 1.0f;
+
+    bool success = m_multiPass->loadProfile(profile);
+    if (!success || !m_multiPass->hasValidMainPass()) {
+        errorOut = m_multiPass->getAllErrors();
+        if (errorOut.empty()) {
+            errorOut = "Profile '" + profile.name + "' has no valid Image pass";
+        }
+        return false;
+    }
+    
+    // 离线渲染要求输出确定，始终使用完整分辨率
+    m_multiPass->setDynamicResolution(DynamicResolutionSettings());
+    return true;
+}
+
+bool HeadlessRunner::resize(int width, int height, std::string& errorOut) {
+    if (width <= 0 || height <= 0) {
+        errorOut = "Resolution must be positive";
+        return false;
+    }
+    if (width == m_options.width && height == m_options.height) {
+        return true;
+    }
+
+    m_options.width = width;
+    m_options.height = height;
+
+    m_output = std::make_unique<Framebuffer>();
+    if (!m_output->create(width, height)) {
+        errorOut = "Failed to create output framebuffer";
+        return false;
+    }
+    m_multiPass->setOutputFramebuffer(m_output->getFBO());
+    m_multiPass->resize(width, height);
+    return true;
+}
+
+// ============================================================================
+// 渲染和输出
+// ============================================================================
+
+void HeadlessRunner::renderFrame(int frame) {
+    float time = m_options.startTime + static_cast<float>(frame) * m_options.timeStep;
+
+    glm::vec4 date = m_startDate;
+    date.w += time;
+
+    m_uniforms.setResolution(static_cast<float>(m_options.width),
+                             static_cast<float>(m_options.height));
+    m_uniforms.setTime(time * m_timeScale);
+    m_uniforms.setTimeDelta(m_options.timeStep);
+    m_uniforms.setFrame(frame);
+    m_uniforms.setMouse(0.0f, 0.0f, 0.0f, 0.0f);
+    m_uniforms.setDate(date);
+
+    m_output->bind();
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    m_multiPass->render(m_uniforms, *m_renderer);
+}
+
+void HeadlessRunner::shutdown() {
+    if (!m_context.isValid()) {
+        return;
+    }
+
+    m_multiPass.reset();
+    m_output.reset();
+    m_renderer.reset();
+    m_uniforms.cleanup();
+    TextureManager::instance().cleanup();
+
+    m_context.shutdown();
+}
+
+// ============================================================================
+// 批处理
+// ============================================================================
+
+int HeadlessRunner::run(const HeadlessOptions& options) {
+    std::string error;
+    
+    // 流格式时 stdout 只输出视频数据，日志全部改到 stderr
+    bool stream = options.writeEvery > 0 && CaptureSettings::isStream(options.format);
+    std::streambuf* savedCout = stream ? std::cout.rdbuf(std::cerr.rdbuf()) : nullptr;
+    struct CoutRestore {
+        std::streambuf* buf;
+        ~CoutRestore() { if (buf) std::cout.rdbuf(buf); }
+    } coutRestore{savedCout};
+
+    if (!init(options, error)) {
+        std::cerr << "HeadlessRunner: " << error << std::endl;
+        return 2;
+    }
+
+    ScreensaverProfile profile;
+    if (!loadInput(profile, error)) {
+        std::cerr << "HeadlessRunner: " << error << std::endl;
+        return 2;
+    }
+
+    auto compileStart = std::chrono::steady_clock::now();
+    if (!loadProfile(profile, error)) {
+        std::cerr << "HeadlessRunner: Compile failed:\n" << error << std::endl;
+        return 2;
+    }
+    double compileMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - compileStart).count();
+
+    // 帧经 PBO 异步读回，由写出线程编码，渲染不等待读回
+    bool writeFrames = options.writeEvery > 0;
+    if (writeFrames) {
+        CaptureSettings capture;
+        capture.format = options.format;
+        capture.outputDir = options.outputDir;
+        capture.source = options.captureSource;
+        capture.every = options.writeEvery;
+        capture.fps = options.timeStep > 0.0f ? static_cast<int>(std::lround(1.0f / options.timeStep)) : 60;
+        if (!m_multiPass->startCapture(capture, error)) {
+            std::cerr << "HeadlessRunner: " << error << std::endl;
+            return 3;
+        }
+    }
+
+    std::cout << "HeadlessRunner: Rendering " << options.frames << " frames at "
+              << options.width << "x" << options.height << ", dt=" << options.timeStep << "s" << std::endl;
+
+    auto batchStart = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        bool isLast = (frame == options.frames - 1);
+        if (writeFrames && isLast) {
+            m_multiPass->getCapture().forceNext();
+        }
+        renderFrame(frame);
+    }
+    glFinish();
+    double renderSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - batchStart).count();
+
+    int framesWritten = 0;
+    if (writeFrames) {
+        // 等待剩余的读回和写出
+        m_multiPass->stopCapture();
+        CaptureStats stats = m_multiPass->getCapture().getStats();
+        framesWritten = stats.framesWritten;
+        if (stats.framesFailed > 0) {
+            std::cerr << "HeadlessRunner: " << m_multiPass->getCapture().getLastError() << std::endl;
+            return 3;
+        }
+    }
+
+    double totalSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - batchStart).count();
+
+    std::cout << "HeadlessRunner: Done. compile " << compileMs << " ms, "
+              << options.frames << " frames in " << totalSeconds << " s"
+              << " (render " << (renderSeconds * 1000.0 / options.frames) << " ms/frame, "
+              << (renderSeconds > 0.0 ? options.frames / renderSeconds : 0.0) << " fps)";
+    if (writeFrames) {
+        std::cout << ", " << framesWritten << " frames written";
+        if (!stream) {
+            std::cout << " to " << options.outputDir;
+        }
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
+
+} // namespace shadertoy
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "HeadlessContext.h"
+#include "ScreensaverMode.h"
+#include "UniformManager.h"
+#include "../renderer/FrameCapture.h"
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+
+namespace shadertoy {
+
+class MultiPassRenderer;
+class Renderer;
+class Framebuffer;
+
+// 无窗口批量渲染参数
+struct HeadlessOptions {
+    std::string inputPath;                  // .json 屏保配置 或 单个 shader 文件
+    std::string outputDir = "headless_out"; // 帧输出目录
+    int profileIndex = -1;                  // 使用的 Profile（-1 = activeProfileIndex）
+    int width = 1280;
+    int height = 720;
+    int frames = 60;                        // 渲染帧数
+    float timeStep = 1.0f / 60.0f;          // 固定时间步长（秒）
+    float startTime = 0.0f;                 // 第 0 帧的 iTime
+    int writeEvery = 1;                     // 每 N 帧写出一帧（0 = 不写出，仅测速）
+    CaptureFormat format = CaptureFormat::PNG;  // 序列格式，或写到 stdout 的流格式
+    int captureSource = -1;                 // -1 = Image 输出，0-3 = Buffer A-D
+};
+
+// 无窗口渲染器
+// 以固定分辨率和固定时间步驱动 MultiPassRenderer，经 FrameCapture 异步读回并写出帧
+// iTime / iFrame / iTimeDelta 完全由帧号决定，不受墙钟和 VSync 影响
+class HeadlessRunner {
+public:
+    HeadlessRunner();
+    ~HeadlessRunner();
+
+    // 禁止拷贝
+    HeadlessRunner(const HeadlessRunner&) = delete;
+    HeadlessRunner& operator=(const HeadlessRunner&) = delete;
+
+    // 解析 --headless 之后的命令行参数
+    static bool parseArguments(int argc, char* argv[], HeadlessOptions& options, std::string& errorOut);
+    static void printUsage();
+
+    // 完整批处理：创建上下文 -> 加载输入 -> 渲染 N 帧 -> 写出
+    // @return 进程退出码（0 = 成功）
+    int run(const HeadlessOptions& options);
+
+    // 分步接口（供基准测试等复用）
+    bool init(const HeadlessOptions& options, std::string& errorOut);
+    bool loadProfile(const ScreensaverProfile& profile, std::string& errorOut);
+    bool resize(int width, int height, std::string& errorOut);
+    void renderFrame(int frame);
+    void shutdown();
+
+    MultiPassRenderer* getMultiPassRenderer() { return m_multiPass.get(); }
+    const HeadlessContext& getContext() const { return m_context; }
+
+private:
+    // 根据 inputPath 读取 Profile
+    bool loadInput(ScreensaverProfile& profileOut, std::string& errorOut) const;
+
+    HeadlessOptions m_options;
+    HeadlessContext m_context;
+
+    // GL 资源必须在上下文销毁前释放，因此使用指针手动控制生命周期
+    std::unique_ptr<MultiPassRenderer> m_multiPass;
+    std::unique_ptr<Renderer> m_renderer;
+    std::unique_ptr<Framebuffer> m_output;
+    UniformManager m_uniforms;
+
+    float m_timeScale = 1.0f;
+    glm::vec4 m_startDate{0.0f};
+};
+
+} // namespace shadertoy
@@ -0,0 +1,92 @@
+#include "ProfileSwitcher.h"
+
+#include <iostream>
+#include <utility>
+
+namespace shadertoy {
+
+ProfileSwitcher::ProfileSwitcher()
+    : m_active(std::make_unique<MultiPassRenderer>())
+    , m_standby(std::make_unique<MultiPassRenderer>()) {
+}
+
+void ProfileSwitcher::init(int width, int height) {
+    m_active->init(width, height);
+    m_standby->init(width, height);
+}
+
+void ProfileSwitcher::cleanup() {
+    m_active->cleanup();
+    m_standby->cleanup();
+    m_activeIndex = -1;
+    m_preloadIndex = -1;
+    m_preloadState = PreloadState::None;
+    m_failedProfiles.clear();
+}
+
+void ProfileSwitcher::resize(int width, int height) {
+    m_active->resize(width, height, true);
+    m_standby->resize(width, height, true);
+}
+
+bool ProfileSwitcher::preload(const ScreensaverProfile& profile, int profileIndex) {
+    m_standby->cancelCompile();
+
+    if (!m_standby->beginLoadProfile(profile)) {
+        m_preloadIndex = profileIndex;
+        m_preloadState = PreloadState::Failed;
+        m_failedProfiles.insert(profileIndex);
+        return false;
+    }
+
+    m_preloadIndex = profileIndex;
+    m_preloadState = PreloadState::Compiling;
+    std::cout << "ProfileSwitcher: Preloading profile [" << profileIndex << "] '" << profile.name << "'"
+              << std::endl;
+    return true;
+}
+
+void ProfileSwitcher::update() {
+    if (m_preloadState != PreloadState::Compiling) {
+        return;
+    }
+
+    CompileStatus status = m_standby->pollCompile();
+    if (status == CompileStatus::Pending) {
+        return;
+    }
+
+    // 部分 Buffer 失败时和直接加载一样照常播放，只有 Image Pass 不可用才放弃
+    if (!m_standby->hasValidMainPass()) {
+        m_preloadState = PreloadState::Failed;
+        m_failedProfiles.insert(m_preloadIndex);
+        std::cerr << "ProfileSwitcher: Preloaded profile [" << m_preloadIndex << "] has no valid Image pass"
+                  << std::endl;
+        return;
+    }
+
+    m_standby->prepare();
+    m_preloadState = PreloadState::Ready;
+    std::cout << "ProfileSwitcher: Profile [" << m_preloadIndex << "] ready"
+              << (status == CompileStatus::Failed ? " (some passes failed)" : "") << std::endl;
+}
+
+void ProfileSwitcher::cancelPreload() {
+    m_standby->cancelCompile();
+    m_preloadIndex = -1;
+    m_preloadState = PreloadState::None;
+}
+
+bool ProfileSwitcher::swap() {
+    if (m_preloadState != PreloadState::Ready) {
+        return false;
+    }
+
+    std::swap(m_active, m_standby);
+    m_activeIndex = m_preloadIndex;
+    m_preloadIndex = -1;
+    m_preloadState = PreloadState::None;
+    return true;
+}
+
+} // namespace shadertoy
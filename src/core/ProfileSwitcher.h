@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../renderer/MultiPassRenderer.h"
+#include "ScreensaverMode.h"
+
+#include <memory>
+#include <unordered_set>
+
+namespace shadertoy {
+
+// 屏保随机播放的 Profile 切换器
+// 持有两个 MultiPassRenderer：正在播放的和后台预加载的。下一个 Profile 提前选定，
+// 在后台渲染器上异步编译、分配 Buffer、创建纹理，到期时只交换两个渲染器，
+// 渲染线程上不再有编译或资源分配
+class ProfileSwitcher {
+public:
+    ProfileSwitcher();
+
+    // 禁止拷贝
+    ProfileSwitcher(const ProfileSwitcher&) = delete;
+    ProfileSwitcher& operator=(const ProfileSwitcher&) = delete;
+
+    void init(int width, int height);
+    void cleanup();
+
+    // 两个渲染器同时调整尺寸（合并连续的窗口尺寸变化）
+    void resize(int width, int height);
+
+    // 正在播放的渲染器（swap() 后指向新的对象）
+    MultiPassRenderer& getActive() { return *m_active; }
+
+    // 后台渲染器：预加载目标，切换过渡期间为仍在淡出的旧 Profile
+    MultiPassRenderer& getStandby() { return *m_standby; }
+    
+    // 正在播放的 Profile 索引（-1 = 不是来自配置的 Profile）
+    int getActiveIndex() const { return m_activeIndex; }
+    void setActiveIndex(int index) { m_activeIndex = index; }
+
+    // 在后台渲染器上开始预加载，取消之前未完成的预加载（切换过渡结束后才能调用）
+    bool preload(const ScreensaverProfile& profile, int profileIndex);
+
+    // 推进预加载：轮询编译，完成后准备首帧资源（不阻塞，每帧调用）
+    void update();
+
+    int getPreloadIndex() const { return m_preloadIndex; }
+    bool isPreloading() const { return m_preloadState == PreloadState::Compiling; }
+    bool isPreloadReady() const { return m_preloadState == PreloadState::Ready; }
+
+    // 预加载的 Profile 没有可用的 Image Pass（需要另选一个）
+    bool isPreloadFailed() const { return m_preloadState == PreloadState::Failed; }
+
+    // 放弃预加载（没有可选的 Profile 时继续播放当前 Profile）
+    void cancelPreload();
+
+    // 预加载失败过的 Profile，随机选择时跳过，避免每帧重新编译同一个坏 Profile
+    bool isProfileFailed(int profileIndex) const { return m_failedProfiles.count(profileIndex) > 0; }
+
+    // 配置变化后索引不再对应，清空失败记录
+    void clearFailedProfiles() { m_failedProfiles.clear(); }
+
+    // 切换到已就绪的预加载 Profile，未就绪时返回 false
+    bool swap();
+
+private:
+    enum class PreloadState {
+        None,
+        Compiling,
+        Ready,
+        Failed
+    };
+
+    std::unique_ptr<MultiPassRenderer> m_active;
+    std::unique_ptr<MultiPassRenderer> m_standby;
+    int m_activeIndex = -1;
+    int m_preloadIndex = -1;
+    PreloadState m_preloadState = PreloadState::None;
+    std::unordered_set<int> m_failedProfiles;
+};
+
+} // namespace shadertoy
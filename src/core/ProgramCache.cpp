@@ -0,0 +1,255 @@
+#include "ProgramCache.h"
+#include "ScreensaverMode.h"
+#include "utils/FileUtils.h"
+#include "utils/Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace shadertoy {
+
+namespace {
+
+// 缓存文件头
+struct CacheFileHeader {
+    char magic[4];          // "STPB"
+    uint32_t version;
+    uint32_t format;        // glProgramBinary 的 binaryFormat
+    uint32_t length;        // 二进制长度
+    uint64_t key;
+};
+
+const char CACHE_MAGIC[4] = {'S', 'T', 'P', 'B'};
+const uint32_t CACHE_VERSION = 1;
+const char* const CACHE_EXTENSION = ".bin";
+
+std::string getGLString(GLenum name) {
+    const GLubyte* str = glGetString(name);
+    return str ? reinterpret_cast<const char*>(str) : "";
+}
+
+} // namespace
+
+ProgramCache& ProgramCache::instance() {
+    static ProgramCache instance;
+    return instance;
+}
+
+std::string ProgramCache::getDefaultDirectory() {
+    std::string configDir = FileUtils::getDirectory(ScreensaverMode::getConfigPath());
+    if (configDir.empty()) {
+        return "shader_cache";
+    }
+    return (fs::path(configDir) / "shader_cache").string();
+}
+
+bool ProgramCache::init(const std::string& directory, size_t maxBytes) {
+    m_enabled = false;
+    m_entries.clear();
+    m_totalBytes = 0;
+    m_directory = directory;
+    m_maxBytes = maxBytes;
+
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    if (numFormats <= 0) {
+        std::cout << "ProgramCache: Driver exposes no program binary formats, cache disabled" << std::endl;
+        return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (!fs::is_directory(directory, ec)) {
+        std::cerr << "ProgramCache: Cannot create cache directory: " << directory << std::endl;
+        return false;
+    }
+
+    // 驱动信息参与键计算，驱动更新后旧条目不会再命中，最终被 LRU 淘汰
+    m_driverHash = Hash::fnv1a(getGLString(GL_VENDOR));
+    m_driverHash = Hash::combine(m_driverHash, getGLString(GL_RENDERER));
+    m_driverHash = Hash::combine(m_driverHash, getGLString(GL_VERSION));
+
+    // 扫描已有条目，按修改时间确定初始 LRU 顺序
+    struct ScannedEntry {
+        uint64_t key;
+        size_t size;
+        fs::file_time_type time;
+    };
+    std::vector<ScannedEntry> scanned;
+    for (const auto& file : fs::directory_iterator(directory, ec)) {
+        if (!file.is_regular_file(ec) || file.path().extension() != CACHE_EXTENSION) {
+            continue;
+        }
+        std::string stem = file.path().stem().string();
+        if (stem.size() != 16) {
+            continue;
+        }
+        ScannedEntry entry;
+        entry.key = std::strtoull(stem.c_str(), nullptr, 16);
+        entry.size = static_cast<size_t>(file.file_size(ec));
+        entry.time = file.last_write_time(ec);
+        scanned.push_back(entry);
+    }
+    std::sort(scanned.begin(), scanned.end(), [](const ScannedEntry& a, const ScannedEntry& b) {
+        return a.time < b.time;
+    });
+
+    m_useCounter = 0;
+    for (const auto& s : scanned) {
+        Entry entry;
+        entry.size = s.size;
+        entry.lastUse = ++m_useCounter;
+        m_entries[s.key] = entry;
+        m_totalBytes += s.size;
+    }
+
+    m_enabled = true;
+    evict();
+
+    std::cout << "ProgramCache: " << m_entries.size() << " entries ("
+              << (m_totalBytes / 1024) << " KB) in " << directory << std::endl;
+    return true;
+}
+
+uint64_t ProgramCache::makeKey(const std::string& vertexSource, const std::string& fragmentSource) const {
+    uint64_t key = Hash::combine(m_driverHash, vertexSource);
+    return Hash::combine(key, fragmentSource);
+}
+
+std::string ProgramCache::getEntryPath(uint64_t key) const {
+    return (fs::path(m_directory) / (Hash::toHex(key) + CACHE_EXTENSION)).string();
+}
+
+GLuint ProgramCache::load(uint64_t key) {
+    if (!m_enabled) {
+        return 0;
+    }
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return 0;
+    }
+
+    std::string path = getEntryPath(key);
+    std::ifstream file(path, std::ios::binary);
+    CacheFileHeader header{};
+    if (!file.is_open() || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION || header.key != key || header.length == 0) {
+        file.close();
+        removeEntry(key);
+        return 0;
+    }
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+        file.close();
+        removeEntry(key);
+        return 0;
+    }
+    file.close();
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, static_cast<GLenum>(header.format), binary.data(),
+                    static_cast<GLsizei>(binary.size()));
+
+    // 驱动可以拒绝任何二进制（格式变化等），此时删除条目并回退到源码编译
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(program);
+        removeEntry(key);
+        return 0;
+    }
+
+    it->second.lastUse = ++m_useCounter;
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return program;
+}
+
+void ProgramCache::store(uint64_t key, GLuint program) {
+    if (!m_enabled || program == 0) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    CacheFileHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+    header.key = key;
+
+    std::string path = getEntryPath(key);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            fs::remove(path, ec);
+            return;
+        }
+    }
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_totalBytes -= it->second.size;
+    }
+    Entry& entry = m_entries[key];
+    entry.size = sizeof(header) + static_cast<size_t>(written);
+    entry.lastUse = ++m_useCounter;
+    m_totalBytes += entry.size;
+
+    evict();
+}
+
+void ProgramCache::removeEntry(uint64_t key) {
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_totalBytes -= it->second.size;
+        m_entries.erase(it);
+    }
+    std::error_code ec;
+    fs::remove(getEntryPath(key), ec);
+}
+
+void ProgramCache::evict() {
+    while (m_totalBytes > m_maxBytes && !m_entries.empty()) {
+        auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+            [](const auto& a, const auto& b) { return a.second.lastUse < b.second.lastUse; });
+        removeEntry(oldest->first);
+    }
+}
+
+void ProgramCache::clear() {
+    while (!m_entries.empty()) {
+        removeEntry(m_entries.begin()->first);
+    }
+}
+
+} // namespace shadertoy
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace shadertoy {
+
+// 程序二进制磁盘缓存（glGetProgramBinary / glProgramBinary）
+// 键 = 顶点源码 + 转译后的片段源码 + 驱动 vendor/renderer/version 的哈希，
+// 驱动升级或换卡后键自然失效；目录总大小超过上限时按最近使用时间淘汰
+class ProgramCache {
+public:
+    static ProgramCache& instance();
+
+    // 禁止拷贝
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    // 打开缓存目录（需要 GL 上下文，用于读取驱动信息）
+    // 驱动不支持任何程序二进制格式时缓存保持禁用
+    bool init(const std::string& directory, size_t maxBytes = 64 * 1024 * 1024);
+
+    // 默认目录：配置文件旁的 shader_cache
+    static std::string getDefaultDirectory();
+
+    bool isEnabled() const { return m_enabled; }
+
+    // 计算缓存键
+    uint64_t makeKey(const std::string& vertexSource, const std::string& fragmentSource) const;
+
+    // 从缓存创建程序，未命中或驱动拒绝二进制时返回 0
+    GLuint load(uint64_t key);
+
+    // 保存已链接程序的二进制（链接前需设置 GL_PROGRAM_BINARY_RETRIEVABLE_HINT）
+    void store(uint64_t key, GLuint program);
+
+    // 删除所有缓存文件
+    void clear();
+
+    size_t getTotalBytes() const { return m_totalBytes; }
+    size_t getEntryCount() const { return m_entries.size(); }
+
+private:
+    ProgramCache() = default;
+
+    struct Entry {
+        size_t size = 0;
+        uint64_t lastUse = 0;   // 单调递增的使用序号
+    };
+
+    std::string getEntryPath(uint64_t key) const;
+    void removeEntry(uint64_t key);
+    void evict();
+
+    bool m_enabled = false;
+    std::string m_directory;
+    size_t m_maxBytes = 0;
+    size_t m_totalBytes = 0;
+    uint64_t m_driverHash = 0;
+    uint64_t m_useCounter = 0;
+    std::unordered_map<uint64_t, Entry> m_entries;
+};
+
+} // namespace shadertoy
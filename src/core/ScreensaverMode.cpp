@@ -4,7 +4,13 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
+
+#ifdef _WIN32
 #include <shlobj.h>
+#else
+#include <sys/stat.h>
+#endif
 
 namespace shadertoy {
 
@@ -35,6 +41,11 @@ ScreensaverRunMode ScreensaverMode::parseCommandLine(int argc, char* argv[], HWN
     
     std::string arg = toLower(argv[1]);
     
+    // 处理 --headless（参数由 HeadlessRunner 解析）
+    if (arg == "--headless") {
+        return ScreensaverRunMode::Headless;
+    }
+    
     // 处理 /s 或 -s
     if (arg == "/s" || arg == "-s") {
         return ScreensaverRunMode::Screensaver;
@@ -96,12 +107,28 @@ ScreensaverRunMode ScreensaverMode::parseCommandLine(const std::string& cmdLine,
 }
 
 std::string ScreensaverMode::getConfigPath() {
+#ifdef _WIN32
     char appDataPath[MAX_PATH];
     if (SUCCEEDED(SHGetFolderPathA(nullptr, CSIDL_APPDATA, nullptr, 0, appDataPath))) {
         std::string configDir = std::string(appDataPath) + "\\LocalShadertoy";
         CreateDirectoryA(configDir.c_str(), nullptr);
         return configDir + "\\config.json";
     }
+#else
+    // 遵循 XDG 规范：$XDG_CONFIG_HOME 或 ~/.config
+    std::string baseDir;
+    if (const char* xdg = std::getenv("XDG_CONFIG_HOME")) {
+        baseDir = xdg;
+    } else if (const char* home = std::getenv("HOME")) {
+        baseDir = std::string(home) + "/.config";
+    }
+    if (!baseDir.empty()) {
+        std::string configDir = baseDir + "/LocalShadertoy";
+        mkdir(baseDir.c_str(), 0755);
+        mkdir(configDir.c_str(), 0755);
+        return configDir + "/config.json";
+    }
+#endif
     return "config.json";
 }
 
@@ -128,9 +155,30 @@ static ShaderPassType stringToPassType(const std::string& str) {
     return ShaderPassType::Image;
 }
 
+const char* TransitionSettings::typeToString(TransitionType type) {
+    switch (type) {
+        case TransitionType::Fade: return "fade";
+        case TransitionType::Wipe: return "wipe";
+        case TransitionType::Dissolve: return "dissolve";
+        case TransitionType::Circle: return "circle";
+        default: return "fade";
+    }
+}
+
+TransitionType TransitionSettings::stringToType(const std::string& str) {
+    if (str == "wipe") return TransitionType::Wipe;
+    if (str == "dissolve") return TransitionType::Dissolve;
+    if (str == "circle") return TransitionType::Circle;
+    return TransitionType::Fade;
+}
+
 bool ScreensaverMode::loadConfig(ScreensaverConfig& config) {
+    return loadConfigFromFile(getConfigPath(), config);
+}
+
+bool ScreensaverMode::loadConfigFromFile(const std::string& path, ScreensaverConfig& config) {
     try {
-        std::ifstream file(getConfigPath());
+        std::ifstream file(path);
         if (!file.is_open()) {
             return false;
         }
@@ -146,6 +194,21 @@ bool ScreensaverMode::loadConfig(ScreensaverConfig& config) {
                 if (pj.contains("name")) profile.name = pj["name"].get<std::string>();
                 if (pj.contains("timeScale")) profile.timeScale = pj["timeScale"].get<float>();
                 if (pj.contains("includeInRandom")) profile.includeInRandom = pj["includeInRandom"].get<bool>();
+                if (pj.contains("dynamicResolution") && pj["dynamicResolution"].is_object()) {
+                    const auto& dj = pj["dynamicResolution"];
+                    auto& dr = profile.dynamicResolution;
+                    if (dj.contains("enabled")) dr.enabled = dj["enabled"].get<bool>();
+                    if (dj.contains("targetFrameMs")) dr.targetFrameMs = dj["targetFrameMs"].get<float>();
+                    if (dj.contains("minScale")) dr.minScale = dj["minScale"].get<float>();
+                    if (dj.contains("maxScale")) dr.maxScale = dj["maxScale"].get<float>();
+                    if (dj.contains("scaleBuffers")) dr.scaleBuffers = dj["scaleBuffers"].get<bool>();
+                }
+                if (pj.contains("warmUp") && pj["warmUp"].is_object()) {
+                    const auto& wj = pj["warmUp"];
+                    auto& wu = profile.warmUp;
+                    if (wj.contains("frames")) wu.frames = std::clamp(wj["frames"].get<int>(), 0, 600);
+                    if (wj.contains("scale")) wu.scale = std::clamp(wj["scale"].get<float>(), 0.125f, 1.0f);
+                }
                 
                 // 新格式：Multi-pass
                 if (pj.contains("passes") && pj["passes"].is_array()) {
@@ -166,6 +229,9 @@ bool ScreensaverMode::loadConfig(ScreensaverConfig& config) {
                                 pass.channels[i] = passJson["channels"][i].get<int>();
                             }
                         }
+                        if (passJson.contains("buffer") && passJson["buffer"].is_object()) {
+                            pass.buffer = passJson["buffer"].get<BufferSettings>();
+                        }
                         profile.passes.push_back(pass);
                     }
                     // 确保有 Image pass
@@ -197,6 +263,18 @@ bool ScreensaverMode::loadConfig(ScreensaverConfig& config) {
             if (j.contains("randomInterval")) {
                 config.randomInterval = j["randomInterval"].get<float>();
             }
+            if (j.contains("transition") && j["transition"].is_object()) {
+                const auto& tj = j["transition"];
+                if (tj.contains("type")) {
+                    config.transition.type = TransitionSettings::stringToType(tj["type"].get<std::string>());
+                }
+                if (tj.contains("duration")) {
+                    config.transition.duration = std::max(0.0f, tj["duration"].get<float>());
+                }
+            }
+            if (j.contains("textureBudgetMB")) {
+                config.textureBudgetMB = std::max(0, j["textureBudgetMB"].get<int>());
+            }
         }
         // 兼容旧版本配置：迁移为单个 profile
         else if (j.contains("shaderCode") || j.contains("useBuiltinShader")) {
@@ -262,6 +340,17 @@ bool ScreensaverMode::saveConfig(const ScreensaverConfig& config) {
             pj["name"] = profile.name;
             pj["timeScale"] = profile.timeScale;
             pj["includeInRandom"] = profile.includeInRandom;
+            pj["dynamicResolution"] = {
+                {"enabled", profile.dynamicResolution.enabled},
+                {"targetFrameMs", profile.dynamicResolution.targetFrameMs},
+                {"minScale", profile.dynamicResolution.minScale},
+                {"maxScale", profile.dynamicResolution.maxScale},
+                {"scaleBuffers", profile.dynamicResolution.scaleBuffers}
+            };
+            pj["warmUp"] = {
+                {"frames", profile.warmUp.frames},
+                {"scale", profile.warmUp.scale}
+            };
             
             // 新格式：保存 passes 数组
             pj["passes"] = nlohmann::json::array();
@@ -276,6 +365,9 @@ bool ScreensaverMode::saveConfig(const ScreensaverConfig& config) {
                     pass.channels[2],
                     pass.channels[3]
                 };
+                if (pass.type != ShaderPassType::Image && pass.type != ShaderPassType::Common) {
+                    passJson["buffer"] = pass.buffer;
+                }
                 pj["passes"].push_back(passJson);
             }
             
@@ -295,6 +387,11 @@ bool ScreensaverMode::saveConfig(const ScreensaverConfig& config) {
         // 保存随机播放设置
         j["randomMode"] = config.randomMode;
         j["randomInterval"] = config.randomInterval;
+        j["transition"] = {
+            {"type", TransitionSettings::typeToString(config.transition.type)},
+            {"duration", config.transition.duration}
+        };
+        j["textureBudgetMB"] = config.textureBudgetMB;
         
         // 配置版本标记
         j["version"] = 2;  // Multi-pass 格式版本
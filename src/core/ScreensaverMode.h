@@ -1,9 +1,16 @@
 #pragma once
 
+#include "BufferSettings.h"
+
 #include <string>
 #include <vector>
 #include <array>
+
+#ifdef _WIN32
 #include <windows.h>
+#else
+typedef void* HWND;  // 非 Windows 平台没有预览窗口句柄
+#endif
 
 namespace shadertoy {
 
@@ -12,7 +19,8 @@ enum class ScreensaverRunMode {
     Editor,         // 正常编辑器模式 (无参数)
     Screensaver,    // 屏保模式 (/s)
     Configure,      // 配置模式 (/c)
-    Preview         // 预览模式 (/p hwnd)
+    Preview,        // 预览模式 (/p hwnd)
+    Headless        // 无窗口批量渲染 (--headless)
 };
 
 // Pass 类型枚举
@@ -44,6 +52,7 @@ struct PassConfig {
     std::string code;                                   // shader 代码
     std::array<int, 4> channels = {-1, -1, -1, -1};     // iChannel 绑定
     bool enabled = true;                                // 是否启用
+    BufferSettings buffer;                              // 渲染目标设置（仅 Buffer A-D）
     
     PassConfig() = default;
     PassConfig(ShaderPassType t) : type(t) {}
@@ -68,11 +77,47 @@ struct PassConfig {
     const char* getTypeName() const { return getTypeName(type); }
 };
 
+// 动态分辨率设置：Image Pass 渲染到缩放后的 FBO 再放大输出，缩放由 GPU 帧时间自动调节
+struct DynamicResolutionSettings {
+    bool enabled = false;
+    float targetFrameMs = 16.0f;    // 目标 GPU 帧时间（毫秒）
+    float minScale = 0.5f;          // 每轴最小缩放
+    float maxScale = 1.0f;          // 每轴最大缩放
+    bool scaleBuffers = false;      // Buffer 也随之缩放（按 1/8 级别变化，变化时 Buffer 被重建）
+};
+
+// Buffer 预热：加载 Profile 或调整尺寸后，在第一次输出前只运行 Buffer Pass 若干帧，
+// 跳过反馈类效果（流体、反应扩散等）从空白开始的阶段
+struct WarmUpSettings {
+    int frames = 0;                 // 预热帧数，0 = 关闭
+    float scale = 1.0f;             // 预热时 Buffer 的分辨率缩放，< 1 时结束后放大到原尺寸
+};
+
+// 随机播放切换 Profile 时的过渡效果
+enum class TransitionType {
+    Fade,           // 交叉淡化
+    Wipe,           // 从左到右擦除
+    Dissolve,       // 随机方块溶解
+    Circle,         // 从中心扩散的圆
+    Count
+};
+
+// 切换过渡：两个 Profile 同时渲染 duration 秒并混合输出，duration <= 0 时直接切换
+struct TransitionSettings {
+    TransitionType type = TransitionType::Fade;
+    float duration = 1.5f;          // 秒
+
+    static const char* typeToString(TransitionType type);
+    static TransitionType stringToType(const std::string& str);
+};
+
 // 单个屏保配置档案 (支持 Multi-pass)
 struct ScreensaverProfile {
     std::string name;               // 配置名称
     float timeScale = 1.0f;         // 时间缩放
     bool includeInRandom = true;    // 是否参与随机播放
+    DynamicResolutionSettings dynamicResolution;
+    WarmUpSettings warmUp;
     
     // Multi-pass 配置
     std::vector<PassConfig> passes; // 所有 Pass（至少包含 Image）
@@ -204,6 +249,11 @@ struct ScreensaverConfig {
     bool randomMode = false;                     // 是否启用随机播放模式
     float randomInterval = 30.0f;                // 随机切换间隔（秒）
     
+    TransitionSettings transition;               // 随机切换的过渡效果
+    
+    // 用户纹理显存预算（MB），不再使用的图片在预算内保留以便切回时复用
+    int textureBudgetMB = 256;
+    
     // 兼容旧配置的字段（已废弃，仅用于迁移）
     std::string shaderPath;         // shader 文件路径
     std::string shaderCode;         // 缓存的 shader 代码
@@ -249,6 +299,7 @@ public:
     
     // 加载/保存配置
     static bool loadConfig(ScreensaverConfig& config);
+    static bool loadConfigFromFile(const std::string& path, ScreensaverConfig& config);
     static bool saveConfig(const ScreensaverConfig& config);
     
     // 获取内置 shader 列表
@@ -1,4 +1,5 @@
 #include "ShaderEngine.h"
+#include "ProgramCache.h"
 #include <iostream>
 #include <algorithm>
 
@@ -21,17 +22,48 @@ void main() {
 )";
 }
 
+void UniformLocations::resolve(GLuint program) {
+    iResolution = glGetUniformLocation(program, "iResolution");
+    iTime = glGetUniformLocation(program, "iTime");
+    iTimeDelta = glGetUniformLocation(program, "iTimeDelta");
+    iFrame = glGetUniformLocation(program, "iFrame");
+    iMouse = glGetUniformLocation(program, "iMouse");
+    iDate = glGetUniformLocation(program, "iDate");
+    iSampleRate = glGetUniformLocation(program, "iSampleRate");
+    iChannelTime = glGetUniformLocation(program, "iChannelTime");
+    
+    static const char* const channelResNames[4] = {
+        "iChannelResolution[0]", "iChannelResolution[1]",
+        "iChannelResolution[2]", "iChannelResolution[3]"
+    };
+    static const char* const channelNames[4] = {
+        "iChannel0", "iChannel1", "iChannel2", "iChannel3"
+    };
+    for (int i = 0; i < 4; i++) {
+        iChannelResolution[i] = glGetUniformLocation(program, channelResNames[i]);
+        iChannel[i] = glGetUniformLocation(program, channelNames[i]);
+    }
+}
+
 ShaderEngine::~ShaderEngine() {
+    cancelCompile();
     if (m_program != 0) {
         glDeleteProgram(m_program);
     }
 }
 
 bool ShaderEngine::compileShader(const std::string& fragmentSource, std::string& errorOut) {
-    GLuint newProgram = 0;
+    ProgramCache& cache = ProgramCache::instance();
+    uint64_t cacheKey = cache.isEnabled() ? cache.makeKey(getDefaultVertexShader(), fragmentSource) : 0;
     
-    if (!createProgram(getDefaultVertexShader(), fragmentSource, newProgram, errorOut)) {
-        return false;
+    GLuint newProgram = cacheKey ? cache.load(cacheKey) : 0;
+    if (newProgram == 0) {
+        if (!createProgram(getDefaultVertexShader(), fragmentSource, newProgram, errorOut)) {
+            return false;
+        }
+        if (cacheKey) {
+            cache.store(cacheKey, newProgram);
+        }
     }
     
     // 删除旧程序
@@ -40,9 +72,181 @@ bool ShaderEngine::compileShader(const std::string& fragmentSource, std::string&
     }
     
     m_program = newProgram;
+    onProgramLinked();
+    return true;
+}
+
+void ShaderEngine::onProgramLinked() {
+    m_locations.resolve(m_program);
+    
+    // 采样器绑定的纹理单元固定不变，链接后设置一次即可
+    for (int i = 0; i < 4; i++) {
+        if (m_locations.iChannel[i] >= 0) {
+            glProgramUniform1i(m_program, m_locations.iChannel[i], i);
+        }
+    }
+}
+
+// ============================================================================
+// 异步编译
+// ============================================================================
+
+static bool s_parallelCompileSupported = false;
+
+void ShaderEngine::enableParallelCompile() {
+    static bool s_enabled = false;
+    if (s_enabled) return;
+    s_enabled = true;
+    
+    // 0xFFFFFFFF = 由驱动决定线程数
+    if (GLAD_GL_KHR_parallel_shader_compile && glMaxShaderCompilerThreadsKHR) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        s_parallelCompileSupported = true;
+    } else if (GLAD_GL_ARB_parallel_shader_compile && glMaxShaderCompilerThreadsARB) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        s_parallelCompileSupported = true;
+    }
+    
+    std::cout << "ShaderEngine: Parallel shader compile "
+              << (s_parallelCompileSupported ? "enabled" : "not supported") << std::endl;
+}
+
+bool ShaderEngine::isParallelCompileSupported() {
+    return s_parallelCompileSupported;
+}
+
+bool ShaderEngine::beginCompile(const std::string& fragmentSource, std::string& errorOut) {
+    cancelCompile();
+    
+    PendingCompile pending;
+    
+    // 命中程序二进制缓存时跳过编译
+    ProgramCache& cache = ProgramCache::instance();
+    if (cache.isEnabled()) {
+        pending.cacheKey = cache.makeKey(getDefaultVertexShader(), fragmentSource);
+        pending.program = cache.load(pending.cacheKey);
+        if (pending.program != 0) {
+            pending.cacheKey = 0;
+            pending.finished = true;
+            m_pending = pending;
+            return true;
+        }
+    }
+    
+    // 只提交命令，不查询状态，驱动可在后台线程编译
+    pending.vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    pending.fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    pending.program = glCreateProgram();
+    if (!pending.vertexShader || !pending.fragmentShader || !pending.program) {
+        if (pending.vertexShader) glDeleteShader(pending.vertexShader);
+        if (pending.fragmentShader) glDeleteShader(pending.fragmentShader);
+        if (pending.program) glDeleteProgram(pending.program);
+        errorOut = "Failed to create shader objects";
+        return false;
+    }
+    
+    const char* vsSrc = getDefaultVertexShader();
+    const char* fsSrc = fragmentSource.c_str();
+    glShaderSource(pending.vertexShader, 1, &vsSrc, nullptr);
+    glShaderSource(pending.fragmentShader, 1, &fsSrc, nullptr);
+    glCompileShader(pending.vertexShader);
+    glCompileShader(pending.fragmentShader);
+    
+    glAttachShader(pending.program, pending.vertexShader);
+    glAttachShader(pending.program, pending.fragmentShader);
+    if (pending.cacheKey) {
+        glProgramParameteri(pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(pending.program);
+    
+    m_pending = pending;
     return true;
 }
 
+CompileStatus ShaderEngine::pollCompile(std::string& errorOut, bool wait) {
+    if (m_pending.program == 0) {
+        return CompileStatus::Idle;
+    }
+    if (m_pending.finished) {
+        return CompileStatus::Ready;
+    }
+    
+    if (s_parallelCompileSupported && !wait) {
+        GLint completed = GL_FALSE;
+        glGetProgramiv(m_pending.program, GL_COMPLETION_STATUS_KHR, &completed);
+        if (!completed) {
+            return CompileStatus::Pending;
+        }
+    }
+    
+    // 不支持并行编译扩展时，这里会阻塞直到链接完成
+    GLint linked = GL_FALSE;
+    glGetProgramiv(m_pending.program, GL_LINK_STATUS, &linked);
+    
+    if (!linked) {
+        errorOut = getCompileError(m_pending);
+        cancelCompile();
+        return CompileStatus::Failed;
+    }
+    
+    // 着色器已链接，可以删除
+    glDetachShader(m_pending.program, m_pending.vertexShader);
+    glDetachShader(m_pending.program, m_pending.fragmentShader);
+    glDeleteShader(m_pending.vertexShader);
+    glDeleteShader(m_pending.fragmentShader);
+    m_pending.vertexShader = 0;
+    m_pending.fragmentShader = 0;
+    m_pending.finished = true;
+    
+    if (m_pending.cacheKey) {
+        ProgramCache::instance().store(m_pending.cacheKey, m_pending.program);
+    }
+    
+    return CompileStatus::Ready;
+}
+
+bool ShaderEngine::commitCompile() {
+    if (m_pending.program == 0 || !m_pending.finished) {
+        return false;
+    }
+    
+    if (m_program != 0) {
+        glDeleteProgram(m_program);
+    }
+    
+    m_program = m_pending.program;
+    m_pending = PendingCompile{};
+    onProgramLinked();
+    return true;
+}
+
+void ShaderEngine::cancelCompile() {
+    if (m_pending.vertexShader) glDeleteShader(m_pending.vertexShader);
+    if (m_pending.fragmentShader) glDeleteShader(m_pending.fragmentShader);
+    if (m_pending.program) glDeleteProgram(m_pending.program);
+    m_pending = PendingCompile{};
+}
+
+std::string ShaderEngine::getCompileError(const PendingCompile& pending) {
+    char infoLog[2048];
+    GLint success = GL_FALSE;
+    
+    glGetShaderiv(pending.vertexShader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(pending.vertexShader, sizeof(infoLog), nullptr, infoLog);
+        return std::string("Vertex shader error:\n") + infoLog;
+    }
+    
+    glGetShaderiv(pending.fragmentShader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(pending.fragmentShader, sizeof(infoLog), nullptr, infoLog);
+        return std::string("Fragment shader error:\n") + infoLog;
+    }
+    
+    glGetProgramInfoLog(pending.program, sizeof(infoLog), nullptr, infoLog);
+    return infoLog;
+}
+
 void ShaderEngine::use() {
     if (m_program != 0) {
         glUseProgram(m_program);
@@ -74,6 +278,9 @@ bool ShaderEngine::linkProgram(GLuint vertexShader, GLuint fragmentShader, GLuin
     GLuint program = glCreateProgram();
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
+    if (ProgramCache::instance().isEnabled()) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(program);
 
     GLint success;
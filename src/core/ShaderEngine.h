@@ -1,19 +1,73 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace shadertoy {
 
+// Shadertoy 标准 uniform 的位置表
+// 在链接成功后解析一次，程序重新编译时随之重建；-1 表示 shader 未使用该 uniform
+struct UniformLocations {
+    GLint iResolution = -1;
+    GLint iTime = -1;
+    GLint iTimeDelta = -1;
+    GLint iFrame = -1;
+    GLint iMouse = -1;
+    GLint iDate = -1;
+    GLint iSampleRate = -1;
+    GLint iChannelResolution[4] = {-1, -1, -1, -1};
+    GLint iChannelTime = -1;
+    GLint iChannel[4] = {-1, -1, -1, -1};
+    
+    // 从程序中查询所有位置
+    void resolve(GLuint program);
+    
+    // 全部置为 -1
+    void reset() { *this = UniformLocations{}; }
+};
+
+// 异步编译状态
+enum class CompileStatus {
+    Idle,       // 没有进行中的编译
+    Pending,    // 驱动仍在编译/链接
+    Ready,      // 编译链接成功，等待 commitCompile()
+    Failed      // 编译或链接失败
+};
+
 class ShaderEngine {
 public:
     ShaderEngine() = default;
     ~ShaderEngine();
 
     // 从转译后的fragment shader代码编译
+    // ProgramCache 启用时优先从程序二进制缓存加载
     bool compileShader(const std::string& fragmentSource, std::string& errorOut);
     
+    // 异步编译：提交编译和链接后立即返回，不等待结果
+    // 之后通过 pollCompile() 轮询；成功后调用 commitCompile() 替换当前程序
+    // 编译期间当前程序保持可用；命中 ProgramCache 时直接进入 Ready 状态
+    bool beginCompile(const std::string& fragmentSource, std::string& errorOut);
+    
+    // 轮询异步编译状态（支持 GL_KHR_parallel_shader_compile 时不阻塞）
+    // wait = true 时阻塞直到编译完成
+    // 返回 Failed 时 errorOut 为错误信息，挂起的编译被丢弃
+    CompileStatus pollCompile(std::string& errorOut, bool wait = false);
+    
+    // 用已完成的异步编译结果替换当前程序（仅在 pollCompile() 返回 Ready 后有效）
+    bool commitCompile();
+    
+    // 丢弃进行中的异步编译
+    void cancelCompile();
+    
+    // 是否有进行中或待提交的异步编译
+    bool hasPendingCompile() const { return m_pending.program != 0; }
+    
+    // 启用驱动的多线程编译（GL_KHR/ARB_parallel_shader_compile），在上下文创建后调用
+    static void enableParallelCompile();
+    static bool isParallelCompileSupported();
+    
     // 使用当前shader程序
     void use();
     
@@ -23,6 +77,9 @@ public:
     // 获取程序ID
     GLuint getProgram() const { return m_program; }
     
+    // 获取链接时缓存的 uniform 位置
+    const UniformLocations& getUniformLocations() const { return m_locations; }
+    
     // 基础编译函数
     bool compileShaderSource(GLenum type, const std::string& source, GLuint& shaderOut, std::string& errorOut);
     bool linkProgram(GLuint vertexShader, GLuint fragmentShader, GLuint& programOut, std::string& errorOut);
@@ -34,7 +91,24 @@ public:
     void deleteProgram(GLuint program);
 
 private:
+    // 链接成功后：缓存 uniform 位置并把 iChannel0-3 固定到纹理单元 0-3
+    void onProgramLinked();
+    
+    // 进行中的异步编译
+    struct PendingCompile {
+        GLuint program = 0;
+        GLuint vertexShader = 0;
+        GLuint fragmentShader = 0;
+        uint64_t cacheKey = 0;      // ProgramCache 键（0 = 不写入缓存）
+        bool finished = false;
+    };
+    
+    // 查询 shader/program 的编译链接错误
+    static std::string getCompileError(const PendingCompile& pending);
+    
     GLuint m_program = 0;
+    PendingCompile m_pending;
+    UniformLocations m_locations;
     std::string m_lastError;
     
     // 默认顶点着色器
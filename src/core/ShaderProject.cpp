@@ -187,6 +187,10 @@ void to_json(nlohmann::json& j, const ShaderPass& p) {
         inputs.push_back(input);
     }
     j["inputs"] = inputs;
+    
+    if (p.type >= PassType::BufferA && p.type <= PassType::BufferD) {
+        j["buffer"] = p.buffer;
+    }
 }
 
 void from_json(const nlohmann::json& j, ShaderPass& p) {
@@ -194,6 +198,7 @@ void from_json(const nlohmann::json& j, ShaderPass& p) {
     if (j.contains("name")) p.name = j["name"].get<std::string>();
     if (j.contains("code")) p.code = j["code"].get<std::string>();
     if (j.contains("enabled")) p.enabled = j["enabled"].get<bool>();
+    if (j.contains("buffer")) p.buffer = j["buffer"].get<BufferSettings>();
     
     if (j.contains("inputs") && j["inputs"].is_array()) {
         size_t i = 0;
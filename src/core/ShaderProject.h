@@ -5,6 +5,7 @@
 #include <array>
 #include <map>
 #include <nlohmann/json.hpp>
+#include "BufferSettings.h"
 
 namespace shadertoy {
 
@@ -53,6 +54,7 @@ struct ShaderPass {
     std::string code;                   // GLSL代码
     std::array<ChannelConfig, 4> inputs; // iChannel0-3
     bool enabled = true;
+    BufferSettings buffer;              // 渲染目标设置 (仅 Buffer pass)
     
     // 获取类型字符串
     static std::string passTypeToString(PassType type);
@@ -1,10 +1,24 @@
 #include "UniformManager.h"
 #include "Application.h"
+#include "ShaderEngine.h"
+#include "../transpiler/GLSLTranspiler.h"
 
 #include <ctime>
 
 namespace shadertoy {
 
+UniformManager::~UniformManager() {
+    cleanup();
+}
+
+void UniformManager::cleanup() {
+    if (m_ubo != 0) {
+        glDeleteBuffers(1, &m_ubo);
+        m_ubo = 0;
+    }
+    m_blockDirty = true;
+}
+
 void UniformManager::updateFromApp(const Application& app) {
     m_uniforms.iResolution = glm::vec3(
         static_cast<float>(app.getWidth()),
@@ -37,46 +51,54 @@ void UniformManager::updateFromApp(const Application& app) {
     );
     
     m_uniforms.iSampleRate = 44100.0f;
+    m_blockDirty = true;
 }
 
-void UniformManager::applyToProgram(GLuint program) const {
-    glUseProgram(program);
-    
-    GLint loc;
-    
-    loc = glGetUniformLocation(program, "iResolution");
-    if (loc >= 0) glUniform3fv(loc, 1, &m_uniforms.iResolution[0]);
-    
-    loc = glGetUniformLocation(program, "iTime");
-    if (loc >= 0) glUniform1f(loc, m_uniforms.iTime);
-    
-    loc = glGetUniformLocation(program, "iTimeDelta");
-    if (loc >= 0) glUniform1f(loc, m_uniforms.iTimeDelta);
-    
-    loc = glGetUniformLocation(program, "iFrame");
-    if (loc >= 0) glUniform1i(loc, m_uniforms.iFrame);
-    
-    loc = glGetUniformLocation(program, "iMouse");
-    if (loc >= 0) glUniform4fv(loc, 1, &m_uniforms.iMouse[0]);
-    
-    loc = glGetUniformLocation(program, "iDate");
-    if (loc >= 0) glUniform4fv(loc, 1, &m_uniforms.iDate[0]);
+void UniformManager::uploadUniformBuffer() {
+    if (m_ubo == 0) {
+        glGenBuffers(1, &m_ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(ShadertoyInputsBlock), nullptr, GL_DYNAMIC_DRAW);
+        m_blockDirty = true;
+    }
     
-    loc = glGetUniformLocation(program, "iSampleRate");
-    if (loc >= 0) glUniform1f(loc, m_uniforms.iSampleRate);
+    if (m_blockDirty) {
+        ShadertoyInputsBlock block;
+        block.iMouse = m_uniforms.iMouse;
+        block.iDate = m_uniforms.iDate;
+        block.iTime = m_uniforms.iTime;
+        block.iTimeDelta = m_uniforms.iTimeDelta;
+        block.iFrame = m_uniforms.iFrame;
+        block.iSampleRate = m_uniforms.iSampleRate;
+        for (int i = 0; i < 4; i++) {
+            block.iChannelTime[i] = m_uniforms.iChannelTime[i];
+        }
+        
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+        m_blockDirty = false;
+    }
     
-    loc = glGetUniformLocation(program, "iChannelResolution");
-    if (loc >= 0) glUniform3fv(loc, 4, &m_uniforms.iChannelResolution[0][0]);
+    glBindBufferBase(GL_UNIFORM_BUFFER, GLSLTranspiler::INPUTS_BLOCK_BINDING, m_ubo);
+}
+
+void UniformManager::applyToProgram(const ShaderEngine& shader) const {
+    const UniformLocations& loc = shader.getUniformLocations();
     
-    loc = glGetUniformLocation(program, "iChannelTime");
-    if (loc >= 0) glUniform1fv(loc, 4, m_uniforms.iChannelTime);
+    if (loc.iResolution >= 0) glUniform3fv(loc.iResolution, 1, &m_uniforms.iResolution[0]);
+    if (loc.iTime >= 0) glUniform1f(loc.iTime, m_uniforms.iTime);
+    if (loc.iTimeDelta >= 0) glUniform1f(loc.iTimeDelta, m_uniforms.iTimeDelta);
+    if (loc.iFrame >= 0) glUniform1i(loc.iFrame, m_uniforms.iFrame);
+    if (loc.iMouse >= 0) glUniform4fv(loc.iMouse, 1, &m_uniforms.iMouse[0]);
+    if (loc.iDate >= 0) glUniform4fv(loc.iDate, 1, &m_uniforms.iDate[0]);
+    if (loc.iSampleRate >= 0) glUniform1f(loc.iSampleRate, m_uniforms.iSampleRate);
+    if (loc.iChannelTime >= 0) glUniform1fv(loc.iChannelTime, 4, m_uniforms.iChannelTime);
     
-    // 纹理采样器
+    // 各通道分辨率（绑定纹理时会用实际尺寸覆盖）
     for (int i = 0; i < 4; i++) {
-        char name[16];
-        snprintf(name, sizeof(name), "iChannel%d", i);
-        loc = glGetUniformLocation(program, name);
-        if (loc >= 0) glUniform1i(loc, i);
+        if (loc.iChannelResolution[i] >= 0) {
+            glUniform3fv(loc.iChannelResolution[i], 1, &m_uniforms.iChannelResolution[i][0]);
+        }
     }
 }
 
@@ -89,6 +111,7 @@ void UniformManager::setChannelResolution(int channel, const glm::vec3& resoluti
 void UniformManager::setChannelTime(int channel, float time) {
     if (channel >= 0 && channel < 4) {
         m_uniforms.iChannelTime[channel] = time;
+        m_blockDirty = true;
     }
 }
 
@@ -104,6 +127,7 @@ void UniformManager::updateDate() {
         static_cast<float>(tm->tm_mday),         // 日期（1-31）
         static_cast<float>(tm->tm_hour * 3600 + tm->tm_min * 60 + tm->tm_sec)  // 秒数
     );
+    m_blockDirty = true;
 }
 
 } // namespace shadertoy
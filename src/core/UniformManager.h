@@ -6,6 +6,7 @@
 namespace shadertoy {
 
 class Application;
+class ShaderEngine;
 
 // Shadertoy 标准 uniform 结构
 struct ShadertoyUniforms {
@@ -20,31 +21,58 @@ struct ShadertoyUniforms {
     float iChannelTime[4];           // 各通道播放时间
 };
 
+// ShadertoyInputs uniform block 的 std140 内存布局（与 GLSLTranspiler 生成的声明一致）
+struct ShadertoyInputsBlock {
+    glm::vec4 iMouse;                // offset 0
+    glm::vec4 iDate;                 // offset 16
+    float iTime;                     // offset 32
+    float iTimeDelta;                // offset 36
+    int iFrame;                      // offset 40
+    float iSampleRate;               // offset 44
+    float iChannelTime[4];           // offset 48 (GLSL 端为 vec4)
+};
+static_assert(sizeof(ShadertoyInputsBlock) == 64, "ShadertoyInputsBlock must match std140 layout");
+
 class UniformManager {
 public:
     UniformManager() = default;
+    ~UniformManager();
+    
+    // 禁止拷贝（持有 GL buffer）
+    UniformManager(const UniformManager&) = delete;
+    UniformManager& operator=(const UniformManager&) = delete;
     
     // 从 Application 更新 uniform
     void updateFromApp(const Application& app);
     
-    // 应用 uniform 到着色器程序
-    void applyToProgram(GLuint program) const;
-    void applyUniforms(GLuint program) const { applyToProgram(program); }
+    // 应用 uniform 到着色器程序（使用链接时缓存的位置，调用前程序须已绑定）
+    // 对使用 uniform block 的程序，帧全局 uniform 不在位置表中，只会设置 Pass 相关的部分
+    void applyToProgram(const ShaderEngine& shader) const;
+    void applyUniforms(const ShaderEngine& shader) const { applyToProgram(shader); }
+    
+    // 上传 ShadertoyInputs uniform buffer 并绑定到 INPUTS_BLOCK_BINDING
+    // 每帧在渲染所有 Pass 前调用一次；数据未变化时跳过上传
+    void uploadUniformBuffer();
+    
+    // 释放 uniform buffer（需要 GL 上下文仍然有效）
+    void cleanup();
     
     // 获取当前 uniform
     const ShadertoyUniforms& getUniforms() const { return m_uniforms; }
     
     // 单独设置各个 uniform
-    void setTime(float time) { m_uniforms.iTime = time; }
-    void setTimeDelta(float dt) { m_uniforms.iTimeDelta = dt; }
+    void setTime(float time) { m_uniforms.iTime = time; m_blockDirty = true; }
+    void setTimeDelta(float dt) { m_uniforms.iTimeDelta = dt; m_blockDirty = true; }
     void setResolution(float w, float h) { m_uniforms.iResolution = glm::vec3(w, h, 1.0f); }
     void setMouse(float x, float y, float clickX, float clickY) { 
         m_uniforms.iMouse = glm::vec4(x, y, clickX, clickY); 
+        m_blockDirty = true;
     }
-    void setFrame(int frame) { m_uniforms.iFrame = frame; }
+    void setFrame(int frame) { m_uniforms.iFrame = frame; m_blockDirty = true; }
     
     // 更新日期时间 (自动获取当前时间)
     void updateDate();
+    void setDate(const glm::vec4& date) { m_uniforms.iDate = date; m_blockDirty = true; }
     
     // 设置通道分辨率
     void setChannelResolution(int channel, const glm::vec3& resolution);
@@ -54,6 +82,10 @@ public:
 
 private:
     ShadertoyUniforms m_uniforms{};
+    
+    // ShadertoyInputs uniform buffer
+    GLuint m_ubo = 0;
+    bool m_blockDirty = true;
 };
 
 } // namespace shadertoy
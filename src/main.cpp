@@ -10,7 +10,9 @@
 #include "core/UniformManager.h"
 #include "core/ProjectManager.h"
 #include "core/ScreensaverMode.h"
-#include "transpiler/GLSLTranspiler.h"
+#include "core/HeadlessRunner.h"
+#include "core/ProgramCache.h"
+#include "core/ProfileSwitcher.h"
 #include "renderer/Renderer.h"
 #include "renderer/TextureManager.h"
 #include "ui/UIManager.h"
@@ -18,11 +20,15 @@
 #include "utils/FileDialog.h"
 #include "renderer/BufferManager.h"
 #include "renderer/MultiPassRenderer.h"
+#include "renderer/ProfileTransition.h"
+#include "renderer/FrameCapture.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#ifdef _WIN32
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
+#endif
 #include <imgui.h>
 #include <imgui_internal.h>  // 需要 ImGuiTabItemFlags_NoCloseButton
 #include <imgui_impl_glfw.h>
@@ -31,6 +37,8 @@
 
 #include <iostream>
 #include <string>
+#include <cstdio>
+#include <cstring>
 #include <cmath>
 #include <fstream>
 #include <sstream>
@@ -181,6 +189,7 @@ struct PassEditorState {
     ShaderPassType type = ShaderPassType::Image;
     TextEditor editor;
     std::array<int, 4> channels = {-1, -1, -1, -1};  // iChannel 绑定
+    BufferSettings bufferSettings;                    // 渲染目标设置（仅 Buffer）
     bool enabled = true;
     bool needsCompile = false;
     
@@ -196,11 +205,9 @@ struct PassEditorState {
 // 全局状态
 struct AppState {
     ProjectManager projectManager;
-    ShaderEngine shaderEngine;         // 向后兼容的单 Pass 引擎
-    MultiPassRenderer multiPassRenderer; // 新的多 Pass 渲染器
+    MultiPassRenderer multiPassRenderer; // 所有 Pass（包括单 Pass 项目）的编译和渲染
     UniformManager uniformManager;
     Renderer renderer;
-    GLSLTranspiler transpiler;
     
     // Multi-pass 编辑器 (保留单一 editor 用于向后兼容)
     TextEditor editor;  // 当前激活的编辑器引用（指向 passEditors 中的一个）
@@ -215,10 +222,6 @@ struct AppState {
     int frameCount = 0;
     float fpsTimer = 0.0f;
     
-    // iChannel 绑定 (-1 = None, 0+ = 内置纹理索引)
-    // 向后兼容：这是 Image pass 的 channel 绑定
-    int channelBindings[4] = {-1, -1, -1, -1};
-    
     // 屏保配置管理
     bool showProfileManager = false;     // 显示配置管理弹窗
     bool showSaveProfileDialog = false;  // 显示保存配置对话框
@@ -228,6 +231,10 @@ struct AppState {
     // -1 = 关闭, 0 = Buffer A, 1 = Buffer B, 2 = Buffer C, 3 = Buffer D
     int debugBufferIndex = -1;
     
+    // 动态分辨率、Buffer 预热（随 Profile 保存）
+    DynamicResolutionSettings dynamicResolution;
+    WarmUpSettings warmUp;
+    
     // 初始化默认 Pass（至少有 Image）
     void initDefaultPasses() {
         if (passEditors.empty()) {
@@ -293,16 +300,6 @@ struct AppState {
         return "";
     }
     
-    // 同步 channelBindings 到/从 Image pass
-    void syncChannelBindings() {
-        auto* imagePass = getPassEditor(ShaderPassType::Image);
-        if (imagePass) {
-            for (int i = 0; i < 4; i++) {
-                channelBindings[i] = imagePass->channels[i];
-            }
-        }
-    }
-    
     // 将编辑器内容同步到 Profile (用于保存)
     void syncToProfile(ScreensaverProfile& profile) const {
         profile.passes.clear();
@@ -313,9 +310,13 @@ struct AppState {
             passConfig.code = passEditor.editor.GetText();
             passConfig.enabled = true;
             passConfig.channels = passEditor.channels;
+            passConfig.buffer = passEditor.bufferSettings;
             profile.passes.push_back(passConfig);
         }
         
+        profile.dynamicResolution = dynamicResolution;
+        profile.warmUp = warmUp;
+        
         // 同时更新旧格式字段（向后兼容）
         profile.syncToLegacy();
     }
@@ -343,6 +344,11 @@ void loadProfileToEditors(AppState& state, const ScreensaverProfile& profile) {
     // 确保至少有 Image pass
     state.initDefaultPasses();
     
+    state.dynamicResolution = profile.dynamicResolution;
+    state.multiPassRenderer.setDynamicResolution(state.dynamicResolution);
+    state.warmUp = profile.warmUp;
+    state.multiPassRenderer.setWarmUp(state.warmUp);
+    
     // 2. 检查是否有多 Pass 数据
     bool hasMultiPass = false;
     for (const auto& passConfig : profile.passes) {
@@ -365,6 +371,7 @@ void loadProfileToEditors(AppState& state, const ScreensaverProfile& profile) {
             if (passEditor) {
                 passEditor->editor.SetText(passConfig.code);
                 passEditor->channels = passConfig.channels;
+                passEditor->bufferSettings = passConfig.buffer;
             }
         }
     } else {
@@ -378,9 +385,6 @@ void loadProfileToEditors(AppState& state, const ScreensaverProfile& profile) {
         }
     }
     
-    // 3. 同步 channelBindings（向后兼容）
-    state.syncChannelBindings();
-    
     // 4. 触发重编译
     state.needsRecompile = true;
     
@@ -388,27 +392,7 @@ void loadProfileToEditors(AppState& state, const ScreensaverProfile& profile) {
               << (hasMultiPass ? " (multi-pass)" : " (single-pass)") << std::endl;
 }
 
-// 编译shader (向后兼容的单 Pass 编译)
-bool compileCurrentShader(AppState& state, const std::string& code) {
-    // 转译代码
-    std::string transpiledCode = state.transpiler.transpile(code);
-    
-    // 编译
-    std::string error;
-    bool success = state.shaderEngine.compileShader(transpiledCode, error);
-    
-    if (!success) {
-        state.lastError = error;
-        std::cerr << "Shader compilation error:\n" << error << std::endl;
-    } else {
-        state.lastError.clear();
-        std::cout << "Shader compiled successfully!" << std::endl;
-    }
-    
-    return success;
-}
-
-// 多 Pass 编译 - 编译所有启用的 Pass
+// 多 Pass 编译 - 提交所有 Pass 异步编译，结果由 pollAllPasses() 取回
 bool compileAllPasses(AppState& state, int width, int height) {
     // 初始化 MultiPassRenderer（如果尚未初始化）
     if (state.multiPassRenderer.getWidth() != width || 
@@ -416,9 +400,7 @@ bool compileAllPasses(AppState& state, int width, int height) {
         state.multiPassRenderer.init(width, height);
     }
     
-    // 首先设置 Common 代码
     std::string commonCode = state.getCommonCode();
-    state.multiPassRenderer.setCommonCode(commonCode);
     
     // 调试输出
     if (!commonCode.empty()) {
@@ -427,61 +409,36 @@ bool compileAllPasses(AppState& state, int width, int height) {
         std::cout << "No Common code (Common tab not added or empty)" << std::endl;
     }
     
-    bool allSuccess = true;
-    state.lastError.clear();
+    // 收集所有 Pass，空代码的 Pass 由 MultiPassRenderer 在切换时禁用
+    std::vector<PassConfig> passes;
+    for (const auto& passState : state.passEditors) {
+        PassConfig config(passState.type, passState.editor.GetText());
+        config.channels = passState.channels;
+        config.buffer = passState.bufferSettings;
+        passes.push_back(config);
+    }
+    
+    // 源码未变化的 Pass 由 MultiPassRenderer 直接复用，不重新编译
+    return state.multiPassRenderer.beginCompile(passes);
+}
+
+// 轮询异步编译，完成后同步编辑器状态
+// @return 本帧是否完成了编译（新程序已生效）
+bool pollAllPasses(AppState& state) {
+    CompileStatus status = state.multiPassRenderer.pollCompile();
+    if (status == CompileStatus::Idle || status == CompileStatus::Pending) {
+        return false;
+    }
     
-    // 编译每个 Pass
     for (auto& passState : state.passEditors) {
-        // Common 不单独编译
         if (passState.type == ShaderPassType::Common) {
             continue;
         }
-        
-        std::string code = passState.editor.GetText();
-        
-        // 如果代码为空，禁用该 pass
-        if (code.empty() || code.find_first_not_of(" \t\n\r") == std::string::npos) {
-            state.multiPassRenderer.disablePass(passState.type);
-            passState.enabled = false;
-            continue;
-        }
-        
-        // 编译 pass
-        bool success = state.multiPassRenderer.compilePass(
-            passState.type, 
-            code, 
-            passState.channels
-        );
-        
-        if (success) {
-            passState.enabled = true;
-            std::cout << "Pass " << PassConfig::getTypeName(passState.type) 
-                      << " compiled successfully" << std::endl;
-        } else {
-            passState.enabled = false;
-            allSuccess = false;
-            
-            // 收集错误
-            std::string passError = state.multiPassRenderer.getPassError(passState.type);
-            if (!passError.empty()) {
-                if (!state.lastError.empty()) {
-                    state.lastError += "\n\n";
-                }
-                state.lastError += passError;
-            }
-        }
-    }
-    
-    // 同时编译向后兼容的单 Pass (Image)
-    auto* imagePass = state.getPassEditor(ShaderPassType::Image);
-    if (imagePass && !imagePass->editor.GetText().empty()) {
-        std::string fullCode = commonCode.empty() ? 
-            imagePass->editor.GetText() : 
-            commonCode + "\n\n" + imagePass->editor.GetText();
-        compileCurrentShader(state, fullCode);
+        passState.enabled = state.multiPassRenderer.isPassEnabled(passState.type);
     }
     
-    return allSuccess;
+    state.lastError = state.multiPassRenderer.getAllErrors();
+    return true;
 }
 
 // 初始化ImGui
@@ -580,7 +537,7 @@ void renderUI(AppState& state, Application& app) {
                     state.showSaveProfileDialog = true;
                     // 使用项目名称作为默认配置名
                     std::string projectName = state.projectManager.getProjectName();
-                    strncpy_s(state.newProfileName, projectName.c_str(), sizeof(state.newProfileName) - 1);
+                    std::snprintf(state.newProfileName, sizeof(state.newProfileName), "%s", projectName.c_str());
                 }
                 if (ImGui::MenuItem("Manage Profiles...")) {
                     // 加载当前配置
@@ -820,6 +777,9 @@ void renderUI(AppState& state, Application& app) {
                                 ImGui::SetNextItemWidth(80);
                                 
                                 if (ImGui::BeginCombo("##combo", currentName, ImGuiComboFlags_NoArrowButton)) {
+                                    // 即将选择纹理，后台先准备好内置纹理的像素数据
+                                    texMgr.prefetchBuiltinTextures();
+                                    
                                     // None 选项
                                     if (ImGui::Selectable("None", passState.channels[ch] == -1)) {
                                         passState.channels[ch] = -1;
@@ -866,6 +826,62 @@ void renderUI(AppState& state, Application& app) {
                                 ImGui::PopID();
                             }
                             
+                            // Buffer 渲染目标设置（格式 / 分辨率缩放 / 过滤），立即生效
+                            int bufIdx = BufferManager::typeToIndex(passState.type);
+                            if (bufIdx >= 0) {
+                                BufferSettings& bs = passState.bufferSettings;
+                                bool changed = false;
+                                
+                                static const BufferFormat formats[] = {
+                                    BufferFormat::RGBA32F, BufferFormat::RGBA16F,
+                                    BufferFormat::RGBA8, BufferFormat::R32F
+                                };
+                                ImGui::Text("Format:");
+                                ImGui::SameLine();
+                                ImGui::SetNextItemWidth(80);
+                                if (ImGui::BeginCombo("##format", BufferSettings::formatToString(bs.format))) {
+                                    for (BufferFormat f : formats) {
+                                        if (ImGui::Selectable(BufferSettings::formatToString(f), bs.format == f)) {
+                                            bs.format = f;
+                                            changed = true;
+                                        }
+                                    }
+                                    ImGui::EndCombo();
+                                }
+                                
+                                static const float scales[] = {1.0f, 0.5f, 0.25f};
+                                static const char* scaleLabels[] = {"1x", "0.5x", "0.25x"};
+                                const char* currentScale = "custom";
+                                for (int si = 0; si < 3; si++) {
+                                    if (bs.fixedWidth <= 0 && bs.scale == scales[si]) currentScale = scaleLabels[si];
+                                }
+                                if (bs.fixedWidth > 0 && bs.fixedHeight > 0) currentScale = "fixed";
+                                ImGui::SameLine();
+                                ImGui::Text("Scale:");
+                                ImGui::SameLine();
+                                ImGui::SetNextItemWidth(70);
+                                if (ImGui::BeginCombo("##scale", currentScale)) {
+                                    for (int si = 0; si < 3; si++) {
+                                        if (ImGui::Selectable(scaleLabels[si], currentScale == scaleLabels[si])) {
+                                            bs.scale = scales[si];
+                                            bs.fixedWidth = 0;
+                                            bs.fixedHeight = 0;
+                                            changed = true;
+                                        }
+                                    }
+                                    ImGui::EndCombo();
+                                }
+                                
+                                ImGui::SameLine();
+                                changed |= ImGui::Checkbox("Linear", &bs.linearFilter);
+                                ImGui::SameLine();
+                                changed |= ImGui::Checkbox("Repeat", &bs.repeatWrap);
+                                
+                                if (changed) {
+                                    state.multiPassRenderer.setBufferSettings(bufIdx, bs);
+                                }
+                            }
+                            
                             ImGui::Separator();
                         }
                         
@@ -936,14 +952,6 @@ void renderUI(AppState& state, Application& app) {
                 ImGui::EndTabBar();
             }
             
-            // 同步 Image pass 的 channel 到全局 channelBindings（向后兼容）
-            auto* imagePass = state.getPassEditor(ShaderPassType::Image);
-            if (imagePass) {
-                for (int i = 0; i < 4; i++) {
-                    state.channelBindings[i] = imagePass->channels[i];
-                }
-            }
-            
             // 检查是否需要重新编译 (F5)
             if (ImGui::IsKeyPressed(ImGuiKey_F5)) {
                 state.needsRecompile = true;
@@ -973,12 +981,147 @@ void renderUI(AppState& state, Application& app) {
             ImGui::Text("Time: %.2f s", app.getTime());
             ImGui::Text("Frame: %d", app.getFrame());
             ImGui::Text("FPS: %.1f", state.fps);
+            if (state.multiPassRenderer.isCompiling()) {
+                ImGui::TextDisabled("Compiling...");
+            }
             
             ImGui::Separator();
             
             // 分辨率
             ImGui::Text("Resolution: %dx%d", app.getWidth(), app.getHeight());
             
+            // 动态分辨率
+            bool dynamicChanged = ImGui::Checkbox("Dynamic Resolution", &state.dynamicResolution.enabled);
+            if (state.dynamicResolution.enabled) {
+                dynamicChanged |= ImGui::SliderFloat("Target ms", &state.dynamicResolution.targetFrameMs, 4.0f, 50.0f, "%.1f");
+                dynamicChanged |= ImGui::SliderFloat("Min Scale", &state.dynamicResolution.minScale, 0.25f, 1.0f, "%.2f");
+                dynamicChanged |= ImGui::Checkbox("Scale Buffers", &state.dynamicResolution.scaleBuffers);
+                
+                const auto& dynamic = state.multiPassRenderer.getDynamicResolution();
+                ImGui::Text("Render: %dx%d (%.2fx)", state.multiPassRenderer.getRenderWidth(),
+                            state.multiPassRenderer.getRenderHeight(), dynamic.getScale());
+                ImGui::Text("GPU: %.2f ms", dynamic.getLastGpuMs());
+            }
+            if (dynamicChanged) {
+                state.multiPassRenderer.setDynamicResolution(state.dynamicResolution);
+            }
+            
+            // 调整窗口尺寸时保留 Buffer 内容
+            bool preserveBuffers = state.multiPassRenderer.isPreservingBuffersOnResize();
+            if (ImGui::Checkbox("Keep Buffers on Resize", &preserveBuffers)) {
+                state.multiPassRenderer.setPreserveBuffersOnResize(preserveBuffers);
+            }
+            
+            // Buffer 预热（下次 Buffer 被清空时生效）
+            bool warmUpChanged = ImGui::SliderInt("Warm-up Frames", &state.warmUp.frames, 0, 600);
+            if (state.warmUp.frames > 0) {
+                warmUpChanged |= ImGui::SliderFloat("Warm-up Scale", &state.warmUp.scale, 0.125f, 1.0f, "%.3f");
+            }
+            if (warmUpChanged) {
+                state.multiPassRenderer.setWarmUp(state.warmUp);
+            }
+            
+            ImGui::Separator();
+            
+            // Pass 计时
+            bool profiling = state.multiPassRenderer.isProfilingEnabled();
+            if (ImGui::Checkbox("Profile Passes", &profiling)) {
+                state.multiPassRenderer.setProfilingEnabled(profiling);
+            }
+            if (profiling) {
+                const auto& profiler = state.multiPassRenderer.getProfiler();
+                if (ImGui::BeginTable("PassTimings", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+                    ImGui::TableSetupColumn("Pass");
+                    ImGui::TableSetupColumn("GPU ms");
+                    ImGui::TableSetupColumn("Avg");
+                    ImGui::TableSetupColumn("Uniforms");
+                    ImGui::TableHeadersRow();
+                    for (const auto& timing : profiler.getTimings()) {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%s", PassConfig::getTypeName(timing.type));
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", timing.gpuMs);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", timing.gpuAvgMs);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", timing.uniformMs);
+                    }
+                    ImGui::EndTable();
+                }
+                ImGui::Text("GPU total: %.3f ms  CPU frame: %.3f ms",
+                            profiler.getTotalGpuMs(), profiler.getLastFrameCpuMs());
+                ImGui::Text("Last compile: %.1f ms (submit %.1f ms)",
+                            profiler.getLastCompileTotalMs(), profiler.getLastCompileSubmitMs());
+                
+                if (ImGui::Button("Export Trace...")) {
+                    std::string path = FileDialog::saveFile("Export Chrome Trace",
+                        {{"Chrome Trace", "*.json"}, {"All Files", "*.*"}}, "", "trace.json");
+                    if (!path.empty()) {
+                        std::string error;
+                        if (!state.multiPassRenderer.exportTrace(path, error)) {
+                            state.lastError = error;
+                        }
+                    }
+                }
+                ImGui::SameLine();
+                ImGui::TextDisabled("%zu events", profiler.getTraceEventCount());
+            }
+            
+            ImGui::Separator();
+            
+            // 帧序列导出（异步读回，不影响帧率）
+            FrameCapture& capture = state.multiPassRenderer.getCapture();
+            if (capture.isActive()) {
+                CaptureStats stats = capture.getStats();
+                ImGui::Text("Recording: %d captured, %d written, %zu queued",
+                            stats.framesCaptured, stats.framesWritten, stats.queuedFrames);
+                if (stats.framesFailed > 0) {
+                    ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%d failed: %s",
+                                       stats.framesFailed, capture.getLastError().c_str());
+                }
+                if (ImGui::Button("Stop Recording")) {
+                    state.multiPassRenderer.stopCapture();
+                }
+            } else {
+                static const CaptureFormat recordFormats[] = {
+                    CaptureFormat::PNG, CaptureFormat::EXR, CaptureFormat::Raw
+                };
+                static const char* sourceLabels[] = {"Image", "Buffer A", "Buffer B", "Buffer C", "Buffer D"};
+                static CaptureSettings recordSettings;
+                
+                ImGui::SetNextItemWidth(80);
+                if (ImGui::BeginCombo("##recordFormat", CaptureSettings::formatToString(recordSettings.format))) {
+                    for (CaptureFormat f : recordFormats) {
+                        if (ImGui::Selectable(CaptureSettings::formatToString(f), recordSettings.format == f)) {
+                            recordSettings.format = f;
+                        }
+                    }
+                    ImGui::EndCombo();
+                }
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                if (ImGui::BeginCombo("##recordSource", sourceLabels[recordSettings.source + 1])) {
+                    for (int src = -1; src < BufferManager::MAX_BUFFERS; src++) {
+                        if (ImGui::Selectable(sourceLabels[src + 1], recordSettings.source == src)) {
+                            recordSettings.source = src;
+                        }
+                    }
+                    ImGui::EndCombo();
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Record...")) {
+                    std::string folder = FileDialog::selectFolder("Select Output Folder");
+                    if (!folder.empty()) {
+                        recordSettings.outputDir = folder;
+                        std::string error;
+                        if (!state.multiPassRenderer.startCapture(recordSettings, error)) {
+                            state.lastError = error;
+                        }
+                    }
+                }
+            }
+            
             // 鼠标状态
             const auto& mouse = app.getMouseState();
             ImGui::Text("Mouse: (%.0f, %.0f)", mouse.x, mouse.y);
@@ -1126,7 +1269,7 @@ void renderUI(AppState& state, Application& app) {
             
             if (ImGui::Selectable(label.c_str(), selectedProfile == i)) {
                 selectedProfile = i;
-                strncpy_s(renameBuffer, profile.name.c_str(), sizeof(renameBuffer) - 1);
+                std::snprintf(renameBuffer, sizeof(renameBuffer), "%s", profile.name.c_str());
             }
             
             ImGui::PopID();
@@ -1201,6 +1344,29 @@ void renderUI(AppState& state, Application& app) {
             ScreensaverMode::saveConfig(g_scrConfig);
         }
         
+        // 切换过渡效果
+        ImGui::SetNextItemWidth(150);
+        if (ImGui::BeginCombo("Transition", TransitionSettings::typeToString(g_scrConfig.transition.type))) {
+            for (int t = 0; t < static_cast<int>(TransitionType::Count); t++) {
+                TransitionType type = static_cast<TransitionType>(t);
+                bool selected = (g_scrConfig.transition.type == type);
+                if (ImGui::Selectable(TransitionSettings::typeToString(type), selected)) {
+                    g_scrConfig.transition.type = type;
+                    ScreensaverMode::saveConfig(g_scrConfig);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        float transitionSec = g_scrConfig.transition.duration;
+        ImGui::SetNextItemWidth(150);
+        if (ImGui::SliderFloat("Transition (sec)", &transitionSec, 0.0f, 5.0f, "%.1f")) {
+            g_scrConfig.transition.duration = transitionSec;
+            ScreensaverMode::saveConfig(g_scrConfig);
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("0 = hard cut");
+        }
+        
         ImGui::Separator();
         if (ImGui::Button("Close", ImVec2(120, 0))) {
             selectedProfile = -1;
@@ -1244,6 +1410,34 @@ void renderUI(AppState& state, Application& app) {
 // ============================================================================
 // 屏保模式运行
 // ============================================================================
+// 随机选择下一个 Profile 并在后台预加载（避开正在播放的和预加载失败过的，
+// 每次重新读取候选以支持运行时配置变化）
+static void preloadNextRandomProfile(ProfileSwitcher& switcher) {
+    // Profile 列表变化后失败记录的索引不再对应
+    static size_t s_profileCount = 0;
+    if (g_scrConfig.profiles.size() != s_profileCount) {
+        s_profileCount = g_scrConfig.profiles.size();
+        switcher.clearFailedProfiles();
+    }
+    
+    std::vector<int> candidates;
+    for (int i = 0; i < static_cast<int>(g_scrConfig.profiles.size()); i++) {
+        if (g_scrConfig.profiles[static_cast<size_t>(i)].includeInRandom && i != switcher.getActiveIndex() &&
+            !switcher.isProfileFailed(i)) {
+            candidates.push_back(i);
+        }
+    }
+    
+    // 需要至少 1 个其他候选才能切换，否则一直播放当前 Profile
+    if (candidates.empty()) {
+        switcher.cancelPreload();
+        return;
+    }
+    
+    int newIndex = candidates[static_cast<size_t>(rand() % static_cast<int>(candidates.size()))];
+    switcher.preload(g_scrConfig.profiles[static_cast<size_t>(newIndex)], newIndex);
+}
+
 int runScreensaverMode() {
     // 初始化内置 shaders (必须在加载配置前初始化，因为配置迁移可能需要)
     ScreensaverMode::initBuiltinShaders();
@@ -1291,149 +1485,36 @@ int runScreensaverMode() {
     g_state = &state;
     state.renderer.init();
     TextureManager::instance().init();
+    TextureManager::instance().setUserTextureBudget(static_cast<size_t>(g_scrConfig.textureBudgetMB) * 1024 * 1024);
+    
+    // 程序二进制缓存：再次启动时跳过 shader 编译
+    ProgramCache::instance().init(ProgramCache::getDefaultDirectory());
     
-    // 初始化多 Pass 渲染器
-    state.multiPassRenderer.init(app.getWidth(), app.getHeight());
+    // 初始化多 Pass 渲染器（随机播放时下一个 Profile 在后台渲染器上预加载）
+    ProfileSwitcher switcher;
+    switcher.init(app.getWidth(), app.getHeight());
+    MultiPassRenderer& initialRenderer = switcher.getActive();
     
     // 获取内置 shaders（确保已初始化）
     const auto& builtins = ScreensaverMode::getBuiltinShaders();
     
-    // 辅助函数：从 Profile 加载多 Pass 到 MultiPassRenderer
-    auto loadProfileToMultiPass = [&state](const ScreensaverProfile& profile) -> bool {
-        // 清理旧的 buffer 数据
-        state.multiPassRenderer.getBufferManager().clearAll();
-        
-        // 清除 Common 代码（防止旧的 Common 污染新 Profile）
-        state.multiPassRenderer.setCommonCode("");
-        
-        // 禁用所有 Buffer Pass（防止旧 Pass 残留）
-        state.multiPassRenderer.disablePass(ShaderPassType::BufferA);
-        state.multiPassRenderer.disablePass(ShaderPassType::BufferB);
-        state.multiPassRenderer.disablePass(ShaderPassType::BufferC);
-        state.multiPassRenderer.disablePass(ShaderPassType::BufferD);
-        state.multiPassRenderer.disablePass(ShaderPassType::Common);
-        
-        // 检查是否有有效的多 Pass 配置
-        // passes 可能包含空的默认 Pass，需要检查是否有实际代码
-        bool hasMultiPassCode = false;
-        for (const auto& pass : profile.passes) {
-            if (!pass.code.empty()) {
-                hasMultiPassCode = true;
-                break;
-            }
-        }
-        
-        if (hasMultiPassCode) {
-            // 使用多 Pass 配置
-            std::string imageCode;
-            std::map<int, std::string> bufferCodes;   // bufferIndex -> code
-            std::map<int, std::array<int, 4>> bufferChannels;  // bufferIndex -> channels
-            
-            std::cout << "[Screensaver] Loading multi-pass profile: " << profile.name << std::endl;
-            std::cout << "[Screensaver] Profile has " << profile.passes.size() << " passes" << std::endl;
-            
-            // 解析所有 Pass
-            for (const auto& pass : profile.passes) {
-                std::cout << "[Screensaver]   Pass type=" << static_cast<int>(pass.type) 
-                          << " code_size=" << pass.code.size() << std::endl;
-                if (pass.type == ShaderPassType::Common) {
-                    // 设置 Common 代码到 MultiPassRenderer（它会在编译时自动合并）
-                    state.multiPassRenderer.setCommonCode(pass.code);
-                } else if (pass.type == ShaderPassType::Image) {
-                    imageCode = pass.code;
-                    // 设置 Image Pass 的 channel 绑定
-                    for (int ch = 0; ch < 4; ch++) {
-                        state.multiPassRenderer.setChannelBinding(ch, pass.channels[ch]);
-                    }
-                } else if (pass.type == ShaderPassType::BufferA) {
-                    bufferCodes[0] = pass.code;
-                    bufferChannels[0] = pass.channels;
-                } else if (pass.type == ShaderPassType::BufferB) {
-                    bufferCodes[1] = pass.code;
-                    bufferChannels[1] = pass.channels;
-                } else if (pass.type == ShaderPassType::BufferC) {
-                    bufferCodes[2] = pass.code;
-                    bufferChannels[2] = pass.channels;
-                } else if (pass.type == ShaderPassType::BufferD) {
-                    bufferCodes[3] = pass.code;
-                    bufferChannels[3] = pass.channels;
-                }
-            }
-            
-            // 设置 Buffer 的 channel 绑定
-            for (const auto& [bufferIndex, channels] : bufferChannels) {
-                for (int ch = 0; ch < 4; ch++) {
-                    state.multiPassRenderer.setBufferChannelBinding(bufferIndex, ch, channels[ch]);
-                }
-            }
-            
-            // 编译所有 Pass
-            bool success = true;
-            
-            // 编译 Buffer Passes（不需要手动合并 common code，MultiPassRenderer 会自动处理）
-            for (const auto& [bufferIndex, code] : bufferCodes) {
-                if (!code.empty()) {
-                    std::string error;
-                    if (!state.multiPassRenderer.compileBufferPass(bufferIndex, code, error)) {
-                        std::cerr << "[Screensaver] Failed to compile Buffer " << (char)('A' + bufferIndex) << ": " << error << std::endl;
-                        success = false;
-                    } else {
-                        std::cout << "[Screensaver] Compiled Buffer " << (char)('A' + bufferIndex) << " OK" << std::endl;
-                    }
-                }
-            }
-            
-            // 编译 Image Pass（不需要手动合并 common code，MultiPassRenderer 会自动处理）
-            if (!imageCode.empty()) {
-                std::string error;
-                if (!state.multiPassRenderer.compileMainPass(imageCode, error)) {
-                    std::cerr << "[Screensaver] Failed to compile Image pass: " << error << std::endl;
-                    success = false;
-                } else {
-                    std::cout << "[Screensaver] Compiled Image pass OK" << std::endl;
-                }
-            } else {
-                std::cerr << "[Screensaver] WARNING: Image pass code is empty!" << std::endl;
-            }
-            
-            std::cout << "[Screensaver] hasValidMainPass = " << state.multiPassRenderer.hasValidMainPass() << std::endl;
-            
-            return success;
-        } else {
-            // 兼容旧的单 Pass 配置（shaderCode）
-            if (!profile.shaderCode.empty()) {
-                std::string error;
-                if (!state.multiPassRenderer.compileMainPass(profile.shaderCode, error)) {
-                    std::cerr << "[Screensaver] Failed to compile shader: " << error << std::endl;
-                    return false;
-                }
-                // 设置 channel 绑定
-                for (int ch = 0; ch < 4; ch++) {
-                    state.multiPassRenderer.setChannelBinding(ch, profile.channelBindings[ch]);
-                }
-                return true;
-            }
-            return false;
-        }
-    };
-    
     // 加载初始 Profile
     float timeScale = 1.0f;
     const ScreensaverProfile* activeProfile = g_scrConfig.getActiveProfile();
     
     if (activeProfile) {
-        loadProfileToMultiPass(*activeProfile);
+        initialRenderer.loadProfile(*activeProfile);
         timeScale = activeProfile->timeScale;
     } else if (!g_scrConfig.profiles.empty() && g_scrConfig.activeProfileIndex >= 0) {
         size_t idx = static_cast<size_t>(g_scrConfig.activeProfileIndex);
         if (idx < g_scrConfig.profiles.size()) {
-            loadProfileToMultiPass(g_scrConfig.profiles[idx]);
+            initialRenderer.loadProfile(g_scrConfig.profiles[idx]);
             timeScale = g_scrConfig.profiles[idx].timeScale;
         }
     }
     
     // 如果没有加载成功，使用回退逻辑
-    if (!state.multiPassRenderer.hasValidMainPass()) {
+    if (!initialRenderer.hasValidMainPass()) {
         std::string fallbackCode;
         if (g_scrConfig.useBuiltinShader && g_scrConfig.selectedBuiltinIndex >= 0 
             && g_scrConfig.selectedBuiltinIndex < static_cast<int>(builtins.size())) {
@@ -1446,14 +1527,14 @@ int runScreensaverMode() {
         
         if (!fallbackCode.empty()) {
             std::string error;
-            state.multiPassRenderer.compileMainPass(fallbackCode, error);
+            initialRenderer.compileMainPass(fallbackCode, error);
         }
         
         timeScale = g_scrConfig.timeScale;
         if (timeScale <= 0.0f) timeScale = 1.0f;
         
         for (int i = 0; i < 4; i++) {
-            state.multiPassRenderer.setChannelBinding(i, g_scrConfig.channelBindings[i]);
+            initialRenderer.setChannelBinding(i, g_scrConfig.channelBindings[i]);
         }
     }
     
@@ -1482,62 +1563,69 @@ int runScreensaverMode() {
         int candidateIdx = rand() % static_cast<int>(randomCandidates.size());
         g_currentRandomIndex = randomCandidates[static_cast<size_t>(candidateIdx)];
         const auto& profile = g_scrConfig.profiles[static_cast<size_t>(g_currentRandomIndex)];
-        loadProfileToMultiPass(profile);
+        initialRenderer.loadProfile(profile);
         timeScale = profile.timeScale;
     }
+    switcher.setActiveIndex(g_currentRandomIndex);
+    
+    // 提前选定下一个 Profile 并在后台编译，到期时直接切换
+    ProfileTransition transition;
+    if (effectiveRandomMode) {
+        preloadNextRandomProfile(switcher);
+        if (g_scrConfig.transition.duration > 0.0f) {
+            transition.prepare(g_scrConfig.transition.type, app.getWidth(), app.getHeight());
+        }
+    }
     
     // 可变的时间缩放（用于随机切换后更新）
     float currentTimeScale = timeScale;
     
     // 设置 update callback（处理随机切换）
-    app.setUpdateCallback([&state, &app, &loadProfileToMultiPass, effectiveRandomMode, randomInterval, &currentTimeScale](float deltaTime) {
-        // 随机切换逻辑
-        if (effectiveRandomMode) {
-            g_randomTimer += deltaTime;
+    app.setUpdateCallback([&switcher, &transition, &app, effectiveRandomMode, randomInterval,
+                           &currentTimeScale](float deltaTime) {
+        if (!effectiveRandomMode) {
+            return;
+        }
+        
+        // 推进后台预加载；预加载的 Profile 不可用时另选一个（失败过的不再选中）
+        switcher.update();
+        if (switcher.isPreloadFailed()) {
+            preloadNextRandomProfile(switcher);
+        }
+        
+        // 过渡结束：两个渲染器恢复直接输出，旧渲染器空出来预加载下一个 Profile
+        if (transition.update(deltaTime)) {
+            switcher.getActive().setOutputFramebuffer(0);
+            switcher.getStandby().setOutputFramebuffer(0);
+            preloadNextRandomProfile(switcher);
+        }
+        
+        // 到期后切换；预加载尚未完成时继续播放当前 Profile，完成后立即切换
+        g_randomTimer += deltaTime;
+        if (!transition.isActive() && g_randomTimer >= randomInterval && switcher.swap()) {
+            // 旧 Profile 在过渡期间继续按自己的时钟播放
+            float fromTime = app.getTime() * currentTimeScale;
+            int fromFrame = app.getFrame();
+            float fromTimeScale = currentTimeScale;
             
-            if (g_randomTimer >= randomInterval) {
-                g_randomTimer = 0.0f;
-                
-                // 重新构建候选列表（支持运行时配置变化）
-                std::vector<int> candidates;
-                for (int i = 0; i < static_cast<int>(g_scrConfig.profiles.size()); i++) {
-                    if (g_scrConfig.profiles[static_cast<size_t>(i)].includeInRandom) {
-                        candidates.push_back(i);
-                    }
-                }
-                
-                // 需要至少 2 个候选才能切换
-                if (candidates.size() > 1) {
-                    // 选择下一个随机 profile（避免选择当前正在播放的）
-                    int newIndex;
-                    int candidateCount = static_cast<int>(candidates.size());
-                    do {
-                        int candidateIdx = rand() % candidateCount;
-                        newIndex = candidates[static_cast<size_t>(candidateIdx)];
-                    } while (newIndex == g_currentRandomIndex && candidateCount > 1);
-                    
-                    g_currentRandomIndex = newIndex;
-                    
-                    // 加载新的 profile（支持多 Pass）
-                    const auto& profile = g_scrConfig.profiles[static_cast<size_t>(g_currentRandomIndex)];
-                    bool loadSuccess = loadProfileToMultiPass(profile);
-                    
-                    std::cout << "[Screensaver] Random switch to profile [" << newIndex << "] '" 
-                              << profile.name << "' - " << (loadSuccess ? "SUCCESS" : "FAILED") << std::endl;
-                    
-                    // ========== 重置所有系统变量 ==========
-                    // 1. 重置时间（iTime 从 0 开始）
-                    app.resetTime();
-                    
-                    // 2. 清除所有 Buffer 内容（防止历史数据影响新 shader）
-                    state.multiPassRenderer.getBufferManager().clearAll();
-                    
-                    std::cout << "[Screensaver] Reset: time, frame, buffers cleared" << std::endl;
-                    
-                    // 更新时间缩放
-                    currentTimeScale = profile.timeScale;
-                    if (currentTimeScale <= 0.0f) currentTimeScale = 1.0f;
-                }
+            g_randomTimer = 0.0f;
+            g_currentRandomIndex = switcher.getActiveIndex();
+            const auto& profile = g_scrConfig.profiles[static_cast<size_t>(g_currentRandomIndex)];
+            
+            std::cout << "[Screensaver] Random switch to profile [" << g_currentRandomIndex << "] '" 
+                      << profile.name << "'" << std::endl;
+            
+            // 重置时间（iTime 从 0 开始），新渲染器的 Buffer 在编译完成时已清除
+            app.resetTime();
+            
+            // 更新时间缩放
+            currentTimeScale = profile.timeScale;
+            if (currentTimeScale <= 0.0f) currentTimeScale = 1.0f;
+            
+            // 过渡期间后台渲染器仍在播放旧 Profile，结束后再预加载
+            if (!transition.begin(g_scrConfig.transition, app.getWidth(), app.getHeight(),
+                                  fromTime, fromFrame, fromTimeScale)) {
+                preloadNextRandomProfile(switcher);
             }
         }
     });
@@ -1556,7 +1644,7 @@ int runScreensaverMode() {
     });
     
     // 渲染回调 - 使用多 Pass 渲染器
-    app.setRenderCallback([&state, &app, &currentTimeScale]() {
+    app.setRenderCallback([&state, &app, &switcher, &transition, &currentTimeScale]() {
         // 检测鼠标移动
         double mouseX, mouseY;
         glfwGetCursorPos(app.getWindow(), &mouseX, &mouseY);
@@ -1581,25 +1669,53 @@ int runScreensaverMode() {
         // 检查窗口尺寸变化并调整 buffer 大小
         int width = app.getWidth();
         int height = app.getHeight();
-        state.multiPassRenderer.resize(width, height);
+        switcher.resize(width, height);
         
-        // 渲染多 Pass shader
-        if (state.multiPassRenderer.hasValidMainPass()) {
-            // 设置 uniforms
-            state.uniformManager.setTime(app.getTime() * currentTimeScale);
+        // 每帧 uniform（过渡期间两个 Profile 各用自己的时钟）
+        auto setFrameUniforms = [&state, &app, width, height](float time, int frame) {
+            state.uniformManager.setTime(time);
             state.uniformManager.setResolution(static_cast<float>(width), 
                                                 static_cast<float>(height));
             state.uniformManager.setMouse(0, 0, 0, 0);
-            state.uniformManager.setFrame(app.getFrame());
+            state.uniformManager.setFrame(frame);
             state.uniformManager.setTimeDelta(app.getDeltaTime());
             state.uniformManager.updateDate();  // 更新日期时间
+        };
+        
+        // 推进异步纹理上传（每帧有字节预算）
+        TextureManager::instance().update();
+        
+        // 切换过渡：两个 Profile 分别渲染到 FBO，再混合输出到窗口
+        if (transition.isActive()) {
+            transition.resize(width, height);
+            
+            MultiPassRenderer& outgoing = switcher.getStandby();
+            setFrameUniforms(transition.getFromTime(), transition.getFromFrame());
+            outgoing.setOutputFramebuffer(transition.getFromFramebuffer());
+            outgoing.render(state.uniformManager, state.renderer);
+            
+            MultiPassRenderer& incoming = switcher.getActive();
+            setFrameUniforms(app.getTime() * currentTimeScale, app.getFrame());
+            incoming.setOutputFramebuffer(transition.getToFramebuffer());
+            incoming.render(state.uniformManager, state.renderer);
+            
+            transition.composite(state.renderer);
+            return;
+        }
+        
+        // 渲染多 Pass shader
+        MultiPassRenderer& renderer = switcher.getActive();
+        if (renderer.hasValidMainPass()) {
+            setFrameUniforms(app.getTime() * currentTimeScale, app.getFrame());
             
             // 执行多 Pass 渲染
-            state.multiPassRenderer.render(state.uniformManager, state.renderer);
+            renderer.render(state.uniformManager, state.renderer);
         }
     });
     
     app.run();
+    transition.cleanup();
+    switcher.cleanup();
     return 0;
 }
 
@@ -1668,12 +1784,16 @@ int runEditorMode() {
                   << " builtin textures" << std::endl;
     }
     
+    // 初始化程序二进制缓存
+    ProgramCache::instance().init(ProgramCache::getDefaultDirectory());
+    
     // 初始化ImGui
     initImGui(app.getWindow());
     
     // 加载屏保配置 (如果存在)
     ScreensaverMode::initBuiltinShaders();
     bool configLoaded = ScreensaverMode::loadConfig(g_scrConfig);
+    TextureManager::instance().setUserTextureBudget(static_cast<size_t>(g_scrConfig.textureBudgetMB) * 1024 * 1024);
     
     // 初始化 Multi-pass 编辑器 - 确保 Image Tab 存在
     state.initDefaultPasses();
@@ -1715,24 +1835,23 @@ int runEditorMode() {
             state.fpsTimer = 0.0f;
         }
         
-        // 检查是否需要重新编译
+        // 检查是否需要重新编译（提交后旧程序继续渲染，直到新程序就绪）
         if (state.needsRecompile) {
             // 使用多 Pass 编译
             compileAllPasses(state, app.getWidth(), app.getHeight());
-            
-            // 重置时间和帧计数器
+            state.needsRecompile = false;
+        }
+        
+        // 新程序就绪后切换
+        if (state.multiPassRenderer.isCompiling() && pollAllPasses(state)) {
+            // 重置时间和帧计数器（Buffer 内容已在切换时清除）
             app.resetTime();
             
-            // 清除 Buffer 内容（避免上一个 shader 的残留）
-            state.multiPassRenderer.getBufferManager().clearAll();
-            
             // 同步 Image pass 代码到项目
             auto* imagePass = state.getPassEditor(ShaderPassType::Image);
             if (imagePass) {
                 state.projectManager.getProject().setImageCode(imagePass->editor.GetText());
             }
-            
-            state.needsRecompile = false;
         }
     });
     
@@ -1742,134 +1861,38 @@ int runEditorMode() {
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
         
-        auto& texMgr = TextureManager::instance();
-        const auto& builtins = texMgr.getBuiltinTextures();
+        // 每帧设置一次 uniform，共享 uniform buffer 由渲染器上传
+        const auto& mouse = app.getMouseState();
+        state.uniformManager.setTime(app.getTime());
+        state.uniformManager.setResolution(
+            static_cast<float>(app.getWidth()), 
+            static_cast<float>(app.getHeight()));
+        state.uniformManager.setMouse(
+            mouse.x, mouse.y, 
+            mouse.leftPressed ? mouse.clickX : 0.0f,
+            mouse.leftPressed ? mouse.clickY : 0.0f);
+        state.uniformManager.setFrame(app.getFrame());
+        state.uniformManager.setTimeDelta(app.getDeltaTime());
+        state.uniformManager.updateDate();  // 更新日期时间
         
-        // 检查是否有启用的 Multi-pass 渲染
-        bool hasMultiPass = state.multiPassRenderer.isPassEnabled(ShaderPassType::Image) ||
-                            state.multiPassRenderer.isPassEnabled(ShaderPassType::BufferA) ||
-                            state.multiPassRenderer.isPassEnabled(ShaderPassType::BufferB) ||
-                            state.multiPassRenderer.isPassEnabled(ShaderPassType::BufferC) ||
-                            state.multiPassRenderer.isPassEnabled(ShaderPassType::BufferD);
+        // 推进异步纹理上传（每帧有字节预算）
+        TextureManager::instance().update();
         
-        if (hasMultiPass) {
-            // 使用 Multi-pass 渲染器
-            state.multiPassRenderer.render(
-                // Uniform 设置回调
-                [&state, &app](GLuint program, ShaderPassType passType) {
-                    (void)passType;  // 可用于 pass 特定的 uniform
-                    
-                    const auto& mouse = app.getMouseState();
-                    state.uniformManager.setTime(app.getTime());
-                    state.uniformManager.setResolution(
-                        static_cast<float>(app.getWidth()), 
-                        static_cast<float>(app.getHeight()));
-                    state.uniformManager.setMouse(
-                        mouse.x, mouse.y, 
-                        mouse.leftPressed ? mouse.clickX : 0.0f,
-                        mouse.leftPressed ? mouse.clickY : 0.0f);
-                    state.uniformManager.setFrame(app.getFrame());
-                    state.uniformManager.setTimeDelta(app.getDeltaTime());
-                    state.uniformManager.updateDate();  // 更新日期时间
-                    state.uniformManager.applyUniforms(program);
-                },
-                // 纹理绑定回调 (用于非 Buffer 类型的纹理)
-                [&builtins](GLuint program, int channel, int binding) {
-                    glActiveTexture(GL_TEXTURE0 + channel);
-                    
-                    if (binding >= 0 && binding < static_cast<int>(builtins.size())) {
-                        size_t idx = static_cast<size_t>(binding);
-                        glBindTexture(GL_TEXTURE_2D, builtins[idx].id);
-                        
-                        // 设置 iChannelResolution
-                        std::string resName = "iChannelResolution[" + std::to_string(channel) + "]";
-                        GLint loc = glGetUniformLocation(program, resName.c_str());
-                        if (loc >= 0) {
-                            glUniform3f(loc, 
-                                static_cast<float>(builtins[idx].width),
-                                static_cast<float>(builtins[idx].height),
-                                1.0f);
-                        }
-                    } else {
-                        glBindTexture(GL_TEXTURE_2D, 0);
-                    }
-                    
-                    // 设置 iChannel uniform
-                    std::string channelName = "iChannel" + std::to_string(channel);
-                    GLint channelLoc = glGetUniformLocation(program, channelName.c_str());
-                    if (channelLoc >= 0) {
-                        glUniform1i(channelLoc, channel);
-                    }
-                },
-                // 渲染四边形回调
-                [&state]() {
-                    state.renderer.renderFullscreenQuad();
-                }
-            );
-        } else if (state.shaderEngine.isValid()) {
-            // 回退到旧的单 Pass 渲染（兼容性）
-            state.shaderEngine.use();
-            GLuint program = state.shaderEngine.getProgram();
-            
-            for (int ch = 0; ch < 4; ch++) {
-                glActiveTexture(GL_TEXTURE0 + ch);
-                
-                if (state.channelBindings[ch] >= 0 && 
-                    state.channelBindings[ch] < static_cast<int>(builtins.size())) {
-                    size_t idx = static_cast<size_t>(state.channelBindings[ch]);
-                    glBindTexture(GL_TEXTURE_2D, builtins[idx].id);
-                    
-                    std::string resName = "iChannelResolution[" + std::to_string(ch) + "]";
-                    GLint loc = glGetUniformLocation(program, resName.c_str());
-                    if (loc >= 0) {
-                        glUniform3f(loc, 
-                            static_cast<float>(builtins[idx].width),
-                            static_cast<float>(builtins[idx].height),
-                            1.0f);
-                    }
-                } else {
-                    glBindTexture(GL_TEXTURE_2D, 0);
-                }
-                
-                std::string channelName = "iChannel" + std::to_string(ch);
-                GLint channelLoc = glGetUniformLocation(program, channelName.c_str());
-                if (channelLoc >= 0) {
-                    glUniform1i(channelLoc, ch);
-                }
-            }
-            
-            const auto& mouse = app.getMouseState();
-            state.uniformManager.setTime(app.getTime());
-            state.uniformManager.setResolution(
-                static_cast<float>(app.getWidth()), 
-                static_cast<float>(app.getHeight()));
-            state.uniformManager.setMouse(
-                mouse.x, mouse.y, 
-                mouse.leftPressed ? mouse.clickX : 0.0f,
-                mouse.leftPressed ? mouse.clickY : 0.0f);
-            state.uniformManager.setFrame(app.getFrame());
-            state.uniformManager.setTimeDelta(app.getDeltaTime());
-            state.uniformManager.updateDate();  // 更新日期时间
-            state.uniformManager.applyUniforms(program);
-            
-            state.renderer.renderFullscreenQuad();
-        }
+        // 单 Pass 和多 Pass 项目使用同一条渲染路径
+        state.multiPassRenderer.render(state.uniformManager, state.renderer);
         
         // 渲染UI
         renderUI(state, app);
     });
     
     // 设置窗口大小改变回调
-    app.setResizeCallback([&state, &app](int width, int height) {
+    app.setResizeCallback([&state](int width, int height) {
         glViewport(0, 0, width, height);
         
         // 调整多 Pass 渲染器的 FBO 大小
+        // Buffer 在尺寸稳定后重建并保留内容，时间不重置，模拟不会因拖动窗口而中断
         if (width > 0 && height > 0) {
-            state.multiPassRenderer.resize(width, height);
-            
-            // 分辨率变化时重置时间和清除 Buffer
-            app.resetTime();
-            state.multiPassRenderer.getBufferManager().clearAll();
+            state.multiPassRenderer.resize(width, height, true);
         }
     });
     
@@ -1885,19 +1908,44 @@ int runEditorMode() {
     return 0;
 }
 
+// ============================================================================
+// 无窗口批量渲染模式
+// ============================================================================
+int runHeadlessMode(int argc, char* argv[]) {
+    HeadlessOptions options;
+    std::string error;
+    if (!HeadlessRunner::parseArguments(argc, argv, options, error)) {
+        std::cerr << "Error: " << error << std::endl << std::endl;
+        HeadlessRunner::printUsage();
+        return 1;
+    }
+    
+    HeadlessRunner runner;
+    return runner.run(options);
+}
+
 // ============================================================================
 // 主入口点
 // ============================================================================
 int main(int argc, char* argv[]) {
-    // 初始化 GLFW（需要在解析参数前初始化，因为屏保模式需要查询显示器）
+    // 解析命令行参数
+    g_runMode = ScreensaverMode::parseCommandLine(argc, argv, g_previewHwnd);
+    
+    // Headless 模式自行创建上下文，不需要窗口系统
+    if (g_runMode == ScreensaverRunMode::Headless) {
+        return runHeadlessMode(argc, argv);
+    }
+    
+    // 初始化 GLFW（屏保模式需要查询显示器）
     if (!glfwInit()) {
+#ifdef _WIN32
         MessageBoxA(nullptr, "Failed to initialize GLFW!", "Error", MB_OK | MB_ICONERROR);
+#else
+        std::cerr << "Failed to initialize GLFW!" << std::endl;
+#endif
         return -1;
     }
     
-    // 解析命令行参数
-    g_runMode = ScreensaverMode::parseCommandLine(argc, argv, g_previewHwnd);
-    
     int result = 0;
     
     switch (g_runMode) {
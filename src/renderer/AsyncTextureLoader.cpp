@@ -0,0 +1,373 @@
+#include "AsyncTextureLoader.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace shadertoy {
+
+namespace {
+
+void getTextureFormat(int channels, GLenum& format, GLenum& internalFormat) {
+    switch (channels) {
+        case 1:
+            format = GL_RED;
+            internalFormat = GL_R8;
+            break;
+        case 2:
+            format = GL_RG;
+            internalFormat = GL_RG8;
+            break;
+        case 3:
+            format = GL_RGB;
+            internalFormat = GL_RGB8;
+            break;
+        case 4:
+        default:
+            format = GL_RGBA;
+            internalFormat = GL_RGBA8;
+            break;
+    }
+}
+
+int getLevelCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+} // namespace
+
+AsyncTextureLoader::AsyncTextureLoader(TextureRegistry* registry, int decodeThreads)
+    : m_registry(registry)
+    , m_decodeThreads(std::max(1, decodeThreads)) {
+}
+
+AsyncTextureLoader::~AsyncTextureLoader() {
+    stopWorkers();
+}
+
+bool AsyncTextureLoader::init() {
+    if (!m_placeholder) {
+        const unsigned char black[4] = {0, 0, 0, 255};
+        glGenTextures(1, &m_placeholder);
+        glBindTexture(GL_TEXTURE_2D, m_placeholder);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, black);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (!m_uploadBuffer) {
+        glGenBuffers(1, &m_uploadBuffer);
+    }
+    return m_placeholder != 0 && m_uploadBuffer != 0;
+}
+
+void AsyncTextureLoader::cleanup() {
+    stopWorkers();
+
+    for (auto& pair : m_entries) {
+        releaseTexture(*pair.second);
+    }
+    m_entries.clear();
+    m_handlesByKey.clear();
+    m_decodeQueue.clear();
+    m_uploadQueue.clear();
+
+    if (m_placeholder) {
+        glDeleteTextures(1, &m_placeholder);
+        m_placeholder = 0;
+    }
+    if (m_uploadBuffer) {
+        glDeleteBuffers(1, &m_uploadBuffer);
+        m_uploadBuffer = 0;
+    }
+}
+
+AsyncTextureLoader::Handle AsyncTextureLoader::load(const std::string& path, const UserTextureOptions& options) {
+    std::string key = TextureRegistry::makeKey(path, options);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_handlesByKey.find(key);
+    if (it != m_handlesByKey.end()) {
+        m_entries[it->second]->refCount++;
+        return it->second;
+    }
+
+    Handle handle = m_nextHandle++;
+    auto entry = std::make_unique<Entry>();
+    entry->path = path;
+    entry->key = key;
+    entry->options = options;
+    entry->refCount = 1;
+
+    // 注册表中已有（包括其他 Profile 用过、尚未被淘汰的）纹理时直接复用
+    GLuint resident = m_registry ? m_registry->acquire(key) : 0;
+    if (resident) {
+        entry->texture = resident;
+        entry->state = State::Ready;
+        m_registry->getSize(resident, entry->width, entry->height);
+        m_entries[handle] = std::move(entry);
+        m_handlesByKey[key] = handle;
+        return handle;
+    }
+
+    m_entries[handle] = std::move(entry);
+    m_handlesByKey[key] = handle;
+    m_decodeQueue.push_back(handle);
+
+    if (m_workers.empty()) {
+        startWorkers();
+    }
+    m_queueCv.notify_one();
+    return handle;
+}
+
+void AsyncTextureLoader::release(Handle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(handle);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    Entry& entry = *it->second;
+    if (--entry.refCount > 0) {
+        return;
+    }
+
+    // 仍在队列中的解码任务会在取出时发现条目已不存在而跳过
+    releaseTexture(entry);
+    m_uploadQueue.erase(std::remove(m_uploadQueue.begin(), m_uploadQueue.end(), handle), m_uploadQueue.end());
+    // 解码失败的条目已不在表中，同一路径可能已被重新加载
+    auto keyIt = m_handlesByKey.find(entry.key);
+    if (keyIt != m_handlesByKey.end() && keyIt->second == handle) {
+        m_handlesByKey.erase(keyIt);
+    }
+    m_entries.erase(it);
+}
+
+void AsyncTextureLoader::releaseTexture(Entry& entry) {
+    if (!entry.texture) {
+        return;
+    }
+    // 已登记的纹理交还注册表（进入 LRU），上传中途的纹理直接删除
+    if (!(entry.state == State::Ready && m_registry && m_registry->release(entry.texture))) {
+        glDeleteTextures(1, &entry.texture);
+    }
+    entry.texture = 0;
+}
+
+void AsyncTextureLoader::update(size_t budgetBytes) {
+    if (!init()) {
+        return;
+    }
+
+    size_t remaining = budgetBytes;
+    while (remaining > 0) {
+        // 解码线程只在入队前写条目，出队后的条目只由 GL 线程访问
+        Entry* entry = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_uploadQueue.empty()) {
+                break;
+            }
+            entry = m_entries[m_uploadQueue.front()].get();
+        }
+
+        if (!entry->texture) {
+            createStorage(*entry);
+        }
+        remaining -= std::min(remaining, uploadRows(*entry, remaining));
+
+        if (entry->uploadedRows >= entry->height) {
+            glBindTexture(GL_TEXTURE_2D, entry->texture);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            if (m_registry) {
+                m_registry->insert(entry->key, entry->texture, entry->width, entry->height, entry->channels);
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            entry->pixels.reset();
+            entry->state = State::Ready;
+            m_uploadQueue.pop_front();
+            std::cout << "AsyncTextureLoader: Loaded " << entry->path << " (" << entry->width << "x"
+                      << entry->height << ")" << std::endl;
+        }
+    }
+}
+
+GLuint AsyncTextureLoader::getTexture(Handle handle) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(handle);
+    if (it == m_entries.end() || it->second->state != State::Ready) {
+        return m_placeholder;
+    }
+    return it->second->texture;
+}
+
+AsyncTextureLoader::State AsyncTextureLoader::getState(Handle handle) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(handle);
+    return it != m_entries.end() ? it->second->state : State::Invalid;
+}
+
+bool AsyncTextureLoader::getSize(Handle handle, int& widthOut, int& heightOut) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(handle);
+    if (it == m_entries.end() || it->second->width == 0) {
+        return false;
+    }
+    widthOut = it->second->width;
+    heightOut = it->second->height;
+    return true;
+}
+
+std::string AsyncTextureLoader::getError(Handle handle) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(handle);
+    return it != m_entries.end() ? it->second->error : std::string();
+}
+
+void AsyncTextureLoader::startWorkers() {
+    m_stop = false;
+    for (int i = 0; i < m_decodeThreads; i++) {
+        m_workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+    }
+}
+
+void AsyncTextureLoader::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_queueCv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void AsyncTextureLoader::workerLoop() {
+    while (true) {
+        Handle handle;
+        std::string path;
+        bool flipY = true;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queueCv.wait(lock, [this]() { return m_stop || !m_decodeQueue.empty(); });
+            if (m_stop) {
+                return;
+            }
+            handle = m_decodeQueue.front();
+            m_decodeQueue.pop_front();
+
+            auto it = m_entries.find(handle);
+            if (it == m_entries.end()) {
+                continue;   // 解码前已释放
+            }
+            path = it->second->path;
+            flipY = it->second->options.flipY;
+        }
+
+        // 翻转标志是线程局部的，不影响其他线程的 stbi_load
+        stbi_set_flip_vertically_on_load_thread(flipY ? 1 : 0);
+
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+        std::string error = data ? std::string() : std::string(stbi_failure_reason());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(handle);
+        if (it == m_entries.end()) {
+            stbi_image_free(data);
+            continue;
+        }
+
+        Entry& entry = *it->second;
+        if (!data) {
+            entry.state = State::Failed;
+            entry.error = error;
+            // 从去重表中移除，之后再次 load 同一路径时重新解码（文件可能已修复）
+            m_handlesByKey.erase(entry.key);
+            std::cerr << "AsyncTextureLoader: Failed to load texture: " << path << " (" << error << ")"
+                      << std::endl;
+            continue;
+        }
+
+        entry.width = width;
+        entry.height = height;
+        entry.channels = channels;
+        entry.pixels = std::unique_ptr<unsigned char, void (*)(void*)>(data, stbi_image_free);
+        entry.state = State::Uploading;
+        m_uploadQueue.push_back(handle);
+    }
+}
+
+void AsyncTextureLoader::createStorage(Entry& entry) {
+    GLenum format;
+    GLenum internalFormat;
+    getTextureFormat(entry.channels, format, internalFormat);
+
+    glGenTextures(1, &entry.texture);
+    glBindTexture(GL_TEXTURE_2D, entry.texture);
+    glTexStorage2D(GL_TEXTURE_2D, getLevelCount(entry.width, entry.height), internalFormat,
+                   entry.width, entry.height);
+    TextureRegistry::applySampler(entry.options);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    entry.uploadedRows = 0;
+}
+
+size_t AsyncTextureLoader::uploadRows(Entry& entry, size_t budgetBytes) {
+    GLenum format;
+    GLenum internalFormat;
+    getTextureFormat(entry.channels, format, internalFormat);
+
+    // 预算不足一行时也至少上传一行，保证进度
+    const size_t rowBytes = static_cast<size_t>(entry.width) * entry.channels;
+    int rows = static_cast<int>(std::max<size_t>(1, budgetBytes / rowBytes));
+    rows = std::min(rows, entry.height - entry.uploadedRows);
+    const size_t bytes = rowBytes * rows;
+    const unsigned char* src = entry.pixels.get() + rowBytes * entry.uploadedRows;
+
+    // 每段重新分配（orphan）PBO 存储，驱动可以在上一段的 DMA 未完成时直接给出新内存
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    const void* pixels = nullptr;
+    if (dst) {
+        std::memcpy(dst, src, bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    } else {
+        // 映射失败时退回客户端内存上传
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        pixels = src;
+    }
+
+    // 3 通道等情况下行宽不是 4 的倍数
+    GLint previousAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glBindTexture(GL_TEXTURE_2D, entry.texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, entry.uploadedRows, entry.width, rows, format, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    entry.uploadedRows += rows;
+    return bytes;
+}
+
+} // namespace shadertoy
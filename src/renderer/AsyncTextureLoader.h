@@ -0,0 +1,144 @@
+/**
+ * AsyncTextureLoader - 用户图片的异步加载
+ *
+ * 解码（stbi_load）在后台线程完成，GL 线程每帧调用 update() 经 PBO 分块上传，
+ * 单帧上传量受预算限制，大图分摊到多帧，不会卡住渲染
+ * 句柄在纹理就绪前解析为占位纹理（1x1 黑色），同一路径的并发请求共享同一句柄
+ * 指定 TextureRegistry 时，上传完成的纹理登记到注册表，已驻留的纹理直接复用而不再解码
+ */
+
+#pragma once
+
+#include "TextureRegistry.h"
+
+#include <glad/glad.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace shadertoy {
+
+class AsyncTextureLoader {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = 0;
+
+    // 默认每帧最多上传的字节数
+    static constexpr size_t DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
+    enum class State {
+        Invalid,        // 句柄无效或已释放
+        Pending,        // 排队 / 解码中
+        Uploading,      // 解码完成，正在分块上传
+        Ready,
+        Failed
+    };
+
+    /**
+     * @param registry 共享的纹理注册表（可为空，此时释放即删除纹理）
+     * @param decodeThreads 解码线程数，首次 load() 时才启动
+     */
+    explicit AsyncTextureLoader(TextureRegistry* registry = nullptr, int decodeThreads = 2);
+    ~AsyncTextureLoader();
+
+    // 禁止拷贝
+    AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+    /**
+     * 创建占位纹理和上传用的 PBO（GL 线程）
+     */
+    bool init();
+
+    /**
+     * 释放所有纹理和 GL 对象，丢弃未完成的请求（GL 线程）
+     */
+    void cleanup();
+
+    /**
+     * 请求加载图片，立即返回（GL 线程）
+     * 同一路径和选项已在加载或已加载时返回同一句柄并增加引用计数
+     */
+    Handle load(const std::string& path, const UserTextureOptions& options = UserTextureOptions());
+
+    /**
+     * 释放一次引用，引用计数归零时删除纹理（GL 线程）
+     */
+    void release(Handle handle);
+
+    /**
+     * 推进上传：把解码完成的图像经 PBO 上传，本次最多 budgetBytes 字节（GL 线程，每帧调用）
+     */
+    void update(size_t budgetBytes = DEFAULT_UPLOAD_BUDGET);
+
+    /**
+     * 当前可用的纹理：就绪前（或失败时）返回占位纹理
+     */
+    GLuint getTexture(Handle handle) const;
+
+    State getState(Handle handle) const;
+
+    /**
+     * 图片尺寸，解码完成前返回 false
+     */
+    bool getSize(Handle handle, int& widthOut, int& heightOut) const;
+
+    /**
+     * 加载失败的原因
+     */
+    std::string getError(Handle handle) const;
+
+private:
+    struct Entry {
+        std::string path;
+        std::string key;                // TextureRegistry::makeKey
+        UserTextureOptions options;
+        int refCount = 0;
+        State state = State::Pending;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::unique_ptr<unsigned char, void (*)(void*)> pixels{nullptr, nullptr};
+        GLuint texture = 0;
+        int uploadedRows = 0;
+        std::string error;
+    };
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+
+    // 释放条目持有的纹理（交还注册表或直接删除）
+    void releaseTexture(Entry& entry);
+
+    // 创建纹理存储（完整 mip 链，数据稍后分块上传）
+    void createStorage(Entry& entry);
+
+    // 上传 entry 的下一段行，返回本次上传的字节数
+    size_t uploadRows(Entry& entry, size_t budgetBytes);
+
+    TextureRegistry* const m_registry;
+    const int m_decodeThreads;
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queueCv;
+    std::deque<Handle> m_decodeQueue;
+    std::deque<Handle> m_uploadQueue;
+    std::unordered_map<Handle, std::unique_ptr<Entry>> m_entries;
+    std::unordered_map<std::string, Handle> m_handlesByKey;
+    Handle m_nextHandle = 1;
+    bool m_stop = false;
+
+    GLuint m_placeholder = 0;
+    GLuint m_uploadBuffer = 0;
+};
+
+} // namespace shadertoy
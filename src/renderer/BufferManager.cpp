@@ -3,6 +3,8 @@
  */
 
 #include "BufferManager.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace shadertoy {
@@ -47,14 +49,19 @@ bool BufferManager::initBuffer(int index, int width, int height) {
     m_buffers[static_cast<size_t>(index)].cleanup();
     
     // 创建新的
-    if (!m_buffers[static_cast<size_t>(index)].create(width, height)) {
+    int scaledWidth = 0, scaledHeight = 0;
+    getScaledSize(width, height, scaledWidth, scaledHeight);
+    if (!m_buffers[static_cast<size_t>(index)].create(scaledWidth, scaledHeight)) {
         std::cerr << "BufferManager: Failed to create Buffer " 
                   << static_cast<char>('A' + index) << std::endl;
         return false;
     }
     
+    const BufferPass& buffer = m_buffers[static_cast<size_t>(index)];
     std::cout << "BufferManager: Created Buffer " << static_cast<char>('A' + index)
-              << " (" << width << "x" << height << ")" << std::endl;
+              << " (" << buffer.getWidth() << "x" << buffer.getHeight() << " "
+              << BufferSettings::formatToString(buffer.settings.format) << ", "
+              << buffer.getFramebufferCount() << " FBO)" << std::endl;
     
     return true;
 }
@@ -76,12 +83,60 @@ void BufferManager::initFromPasses(const std::vector<PassConfig>& passes, int wi
         if (pass.enabled) {
             int idx = typeToIndex(pass.type);
             if (idx >= 0) {
+                m_buffers[static_cast<size_t>(idx)].settings = pass.buffer;
                 initBuffer(idx, width, height);
             }
         }
     }
 }
 
+void BufferManager::setBufferSettings(int index, const BufferSettings& settings) {
+    if (index < 0 || index >= MAX_BUFFERS) {
+        return;
+    }
+    
+    BufferPass& buffer = m_buffers[static_cast<size_t>(index)];
+    if (buffer.settings == settings) {
+        return;
+    }
+    
+    buffer.settings = settings;
+    if (buffer.enabled && m_width > 0 && m_height > 0) {
+        initBuffer(index, m_width, m_height);
+    }
+}
+
+const BufferSettings* BufferManager::getBufferSettings(int index) const {
+    if (index >= 0 && index < MAX_BUFFERS) {
+        return &m_buffers[static_cast<size_t>(index)].settings;
+    }
+    return nullptr;
+}
+
+int BufferManager::getBufferWidth(int index) const {
+    if (index >= 0 && index < MAX_BUFFERS && m_buffers[static_cast<size_t>(index)].enabled) {
+        return m_buffers[static_cast<size_t>(index)].getWidth();
+    }
+    return 0;
+}
+
+int BufferManager::getBufferHeight(int index) const {
+    if (index >= 0 && index < MAX_BUFFERS && m_buffers[static_cast<size_t>(index)].enabled) {
+        return m_buffers[static_cast<size_t>(index)].getHeight();
+    }
+    return 0;
+}
+
+size_t BufferManager::getMemoryBytes() const {
+    size_t total = 0;
+    for (const auto& buffer : m_buffers) {
+        if (buffer.enabled) {
+            total += buffer.getMemoryBytes();
+        }
+    }
+    return total;
+}
+
 // ============================================================================
 // Buffer 禁用
 // ============================================================================
@@ -101,19 +156,46 @@ void BufferManager::disableBuffer(ShaderPassType type) {
 // 调整大小 & 清理
 // ============================================================================
 
-void BufferManager::resize(int width, int height) {
+void BufferManager::resize(int width, int height, bool preserveContent) {
     if (width == m_width && height == m_height) return;
     
     m_width = width;
     m_height = height;
     
+    int scaledWidth = 0, scaledHeight = 0;
+    getScaledSize(width, height, scaledWidth, scaledHeight);
     for (auto& buffer : m_buffers) {
         if (buffer.enabled) {
-            buffer.resize(width, height);
+            buffer.resize(scaledWidth, scaledHeight, preserveContent);
         }
     }
 }
 
+void BufferManager::setResolutionScale(float scale, bool preserveContent) {
+    if (scale <= 0.0f || scale == m_resolutionScale) return;
+    
+    m_resolutionScale = scale;
+    if (m_width <= 0 || m_height <= 0) return;
+    
+    int scaledWidth = 0, scaledHeight = 0;
+    getScaledSize(m_width, m_height, scaledWidth, scaledHeight);
+    for (auto& buffer : m_buffers) {
+        if (buffer.enabled) {
+            buffer.resize(scaledWidth, scaledHeight, preserveContent);
+        }
+    }
+    
+    // 重建的纹理内容未定义
+    if (!preserveContent) {
+        clearAll();
+    }
+}
+
+void BufferManager::getScaledSize(int width, int height, int& widthOut, int& heightOut) const {
+    widthOut = std::max(1, static_cast<int>(std::lround(width * m_resolutionScale)));
+    heightOut = std::max(1, static_cast<int>(std::lround(height * m_resolutionScale)));
+}
+
 void BufferManager::cleanup() {
     for (auto& buffer : m_buffers) {
         buffer.cleanup();
@@ -204,23 +286,67 @@ void BufferManager::swapAll() {
     }
 }
 
+void BufferManager::finishRender(int index) {
+    if (index >= 0 && index < MAX_BUFFERS && m_buffers[static_cast<size_t>(index)].enabled) {
+        m_buffers[static_cast<size_t>(index)].finishRender();
+    }
+}
+
+void BufferManager::setPingPong(int index, bool enabled) {
+    if (index < 0 || index >= MAX_BUFFERS) {
+        return;
+    }
+    
+    BufferPass& buffer = m_buffers[static_cast<size_t>(index)];
+    if (buffer.pingPong == enabled) {
+        return;
+    }
+    
+    if (!buffer.setPingPong(enabled)) {
+        std::cerr << "BufferManager: Failed to allocate second framebuffer for Buffer "
+                  << static_cast<char>('A' + index) << std::endl;
+        return;
+    }
+    
+    if (buffer.enabled) {
+        std::cout << "BufferManager: Buffer " << static_cast<char>('A' + index)
+                  << (enabled ? " -> ping-pong (2 FBOs)" : " -> single FBO") << std::endl;
+    }
+}
+
+bool BufferManager::isPingPong(int index) const {
+    if (index >= 0 && index < MAX_BUFFERS) {
+        return m_buffers[static_cast<size_t>(index)].pingPong;
+    }
+    return false;
+}
+
 void BufferManager::clearAll() {
     // 清除所有启用的 Buffer 内容（设置为黑色）
-    for (auto& buffer : m_buffers) {
-        if (buffer.enabled) {
-            // 清除 front buffer
-            if (buffer.front) {
-                buffer.front->bind();
-                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-                glClear(GL_COLOR_BUFFER_BIT);
-            }
-            // 清除 back buffer
-            if (buffer.back) {
-                buffer.back->bind();
-                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-                glClear(GL_COLOR_BUFFER_BIT);
-            }
-        }
+    for (int i = 0; i < MAX_BUFFERS; i++) {
+        clearBuffer(i);
+    }
+}
+
+void BufferManager::clearBuffer(int index) {
+    if (index < 0 || index >= MAX_BUFFERS) {
+        return;
+    }
+    auto& buffer = m_buffers[static_cast<size_t>(index)];
+    if (!buffer.enabled) {
+        return;
+    }
+    
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    // 清除 front buffer
+    if (buffer.front) {
+        buffer.front->bind();
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    // 清除 back buffer
+    if (buffer.back) {
+        buffer.back->bind();
+        glClear(GL_COLOR_BUFFER_BIT);
     }
     // 恢复默认帧缓冲
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
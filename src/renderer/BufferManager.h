@@ -1,12 +1,14 @@
 /**
  * BufferManager - 管理 Multi-pass 渲染的 FBO
  * 
- * 支持 Buffer A/B/C/D，每个 Buffer 使用双缓冲 (ping-pong) 实现反馈循环
+ * 支持 Buffer A/B/C/D；读取自身上一帧的 Buffer 使用双缓冲 (ping-pong) 实现反馈循环，
+ * 其余 Buffer 只分配一个 FBO，直接渲染到可读纹理（由 RenderGraph 决定）
  */
 
 #pragma once
 
 #include "Framebuffer.h"
+#include "../core/BufferSettings.h"
 #include "../core/ScreensaverMode.h"
 #include <array>
 #include <memory>
@@ -15,25 +17,76 @@
 namespace shadertoy {
 
 /**
- * 单个 Buffer 的双缓冲管理
+ * 单个 Buffer 的 FBO 管理（单缓冲或 ping-pong 双缓冲）
  */
 struct BufferPass {
-    std::unique_ptr<Framebuffer> front;  // 当前帧渲染目标
-    std::unique_ptr<Framebuffer> back;   // 上一帧结果（可作为输入）
+    std::unique_ptr<Framebuffer> front;  // ping-pong 时的渲染目标（单缓冲时为空）
+    std::unique_ptr<Framebuffer> back;   // 最近一次渲染的结果（可作为输入）
     bool enabled = false;
+    bool pingPong = false;               // false 时直接渲染到 back，不交换
+    BufferSettings settings;             // 格式 / 分辨率缩放 / 过滤 / 环绕
     
     BufferPass() = default;
     
-    // 创建双缓冲
-    bool create(int width, int height) {
-        front = std::make_unique<Framebuffer>();
+    // 创建 FBO（ping-pong 时创建两个），尺寸由 settings 根据窗口尺寸决定
+    bool create(int windowWidth, int windowHeight) {
+        int width = 0, height = 0;
+        settings.resolveSize(windowWidth, windowHeight, width, height);
+        
         back = std::make_unique<Framebuffer>();
-        if (!front->create(width, height)) return false;
-        if (!back->create(width, height)) return false;
+        if (!createTarget(*back, width, height)) return false;
+        if (pingPong) {
+            front = std::make_unique<Framebuffer>();
+            if (!createTarget(*front, width, height)) return false;
+        }
         enabled = true;
         return true;
     }
     
+    bool createTarget(Framebuffer& fb, int width, int height) const {
+        return fb.create(width, height, getInternalFormat(settings.format),
+                         settings.linearFilter ? GL_LINEAR : GL_NEAREST,
+                         settings.repeatWrap ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+    }
+    
+    static GLenum getInternalFormat(BufferFormat format) {
+        switch (format) {
+            case BufferFormat::RGBA16F: return GL_RGBA16F;
+            case BufferFormat::RGBA8: return GL_RGBA8;
+            case BufferFormat::R32F: return GL_R32F;
+            default: return GL_RGBA32F;
+        }
+    }
+    
+    // 切换单缓冲 / ping-pong，按需创建或释放第二个 FBO
+    // back 中的内容保留，反馈效果不会因切换而中断
+    bool setPingPong(bool enable) {
+        pingPong = enable;
+        if (!enabled || !back) return true;
+        
+        if (enable && !front) {
+            front = std::make_unique<Framebuffer>();
+            if (!createTarget(*front, back->getWidth(), back->getHeight())) {
+                front.reset();
+                pingPong = false;
+                return false;
+            }
+            front->bind();
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            front->unbind();
+        } else if (!enable && front) {
+            front->cleanup();
+            front.reset();
+        }
+        return true;
+    }
+    
+    // 分配的 FBO 数量
+    int getFramebufferCount() const {
+        return (front ? 1 : 0) + (back ? 1 : 0);
+    }
+    
     // 清理
     void cleanup() {
         if (front) front->cleanup();
@@ -43,35 +96,73 @@ struct BufferPass {
         enabled = false;
     }
     
-    // 调整大小
-    void resize(int width, int height) {
+    // 按新的窗口尺寸调整大小（固定尺寸的 Buffer 不变）
+    // preserveContent 时把最近一次的结果缩放 blit 到新的 back，否则内容未定义
+    void resize(int windowWidth, int windowHeight, bool preserveContent = false) {
+        int width = 0, height = 0;
+        settings.resolveSize(windowWidth, windowHeight, width, height);
+        if (!preserveContent || !back || (back->getWidth() == width && back->getHeight() == height)) {
+            if (front) front->resize(width, height);
+            if (back) back->resize(width, height);
+            return;
+        }
+        
+        std::unique_ptr<Framebuffer> old = std::move(back);
+        back = std::make_unique<Framebuffer>();
+        if (!createTarget(*back, width, height)) {
+            back = std::move(old);
+            return;
+        }
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, old->getFBO());
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, back->getFBO());
+        glBlitFramebuffer(0, 0, old->getWidth(), old->getHeight(), 0, 0, width, height,
+                          GL_COLOR_BUFFER_BIT, settings.linearFilter ? GL_LINEAR : GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        old->cleanup();
+        
+        // front 在读取前总会被重新渲染
         if (front) front->resize(width, height);
-        if (back) back->resize(width, height);
     }
     
-    // 交换前后缓冲（每帧渲染后调用）
+    // 实际渲染尺寸
+    int getWidth() const { return back ? back->getWidth() : 0; }
+    int getHeight() const { return back ? back->getHeight() : 0; }
+    
+    // 占用的显存（字节）
+    size_t getMemoryBytes() const {
+        return static_cast<size_t>(getWidth()) * static_cast<size_t>(getHeight()) *
+               static_cast<size_t>(settings.getBytesPerPixel()) * static_cast<size_t>(getFramebufferCount());
+    }
+    
+    // 交换前后缓冲
     void swap() {
         std::swap(front, back);
     }
     
-    // 获取可读取的纹理（上一帧结果）
+    // 本 Pass 渲染完成后调用：ping-pong 时交换，使 back 成为最新结果
+    void finishRender() {
+        if (pingPong && front) swap();
+    }
+    
+    // 获取可读取的纹理（最近一次渲染的结果）
     GLuint getReadTexture() const {
         return back ? back->getTexture() : 0;
     }
     
-    // 获取当前渲染目标纹理（用于调试）
+    // 获取 ping-pong 的另一张纹理（用于调试）
     GLuint getFrontTexture() const {
         return front ? front->getTexture() : 0;
     }
     
     // 绑定为渲染目标
     void bindForRender() {
-        if (front) front->bind();
+        Framebuffer* target = (pingPong && front) ? front.get() : back.get();
+        if (target) target->bind();
     }
     
     // 解绑
     void unbind() {
-        if (front) front->unbind();
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 };
 
@@ -103,6 +194,31 @@ public:
      */
     void initFromPasses(const std::vector<PassConfig>& passes, int width, int height);
     
+    /**
+     * 设置 Buffer 的格式 / 分辨率缩放 / 过滤 / 环绕
+     * 已创建的 Buffer 在设置变化时重新创建（内容被清除）
+     */
+    void setBufferSettings(int index, const BufferSettings& settings);
+    const BufferSettings* getBufferSettings(int index) const;
+    
+    /**
+     * 获取 Buffer 的实际渲染尺寸（未启用时返回 0）
+     */
+    int getBufferWidth(int index) const;
+    int getBufferHeight(int index) const;
+    
+    /**
+     * 全局分辨率缩放（动态分辨率、Buffer 预热使用），作用于窗口尺寸，之后再应用各 Buffer 的设置
+     * 变化时所有 Buffer 被重建；preserveContent 时旧内容缩放到新尺寸，否则清空
+     */
+    void setResolutionScale(float scale, bool preserveContent = false);
+    float getResolutionScale() const { return m_resolutionScale; }
+    
+    /**
+     * 所有 Buffer 占用的显存（字节）
+     */
+    size_t getMemoryBytes() const;
+    
     /**
      * 禁用指定 Buffer
      */
@@ -111,8 +227,9 @@ public:
     
     /**
      * 调整所有 Buffer 大小
+     * preserveContent 时旧内容缩放 blit 到新尺寸（反馈效果不中断），否则内容未定义
      */
-    void resize(int width, int height);
+    void resize(int width, int height, bool preserveContent = false);
     
     /**
      * 清理所有资源
@@ -155,11 +272,28 @@ public:
      */
     void swapAll();
     
+    /**
+     * 指定 Buffer 渲染完成（ping-pong 时交换）
+     */
+    void finishRender(int index);
+    
+    /**
+     * 设置 Buffer 是否使用 ping-pong（只有读取自身上一帧的 Buffer 需要）
+     * 已创建的 Buffer 会立即分配或释放第二个 FBO
+     */
+    void setPingPong(int index, bool enabled);
+    bool isPingPong(int index) const;
+    
     /**
      * 清除所有 Buffer 内容（用于重置状态）
      */
     void clearAll();
     
+    /**
+     * 清除指定 Buffer 的内容（未启用时忽略）
+     */
+    void clearBuffer(int index);
+    
     /**
      * 检查 Buffer 是否启用
      */
@@ -167,7 +301,7 @@ public:
     bool isEnabled(ShaderPassType type) const;
     
     /**
-     * 获取渲染分辨率
+     * 获取窗口分辨率（各 Buffer 的实际尺寸见 getBufferWidth/Height）
      */
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
@@ -184,9 +318,13 @@ public:
     static ShaderPassType indexToType(int index);
 
 private:
+    // 应用全局缩放后的窗口尺寸
+    void getScaledSize(int width, int height, int& widthOut, int& heightOut) const;
+    
     std::array<BufferPass, MAX_BUFFERS> m_buffers;
     int m_width = 0;
     int m_height = 0;
+    float m_resolutionScale = 1.0f;
 };
 
 } // namespace shadertoy
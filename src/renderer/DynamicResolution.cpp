@@ -0,0 +1,68 @@
+/**
+ * DynamicResolution 实现
+ */
+
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace shadertoy {
+
+namespace {
+
+const double KP = 0.3;              // 比例增益（结果有 1-3 帧延迟，取保守值）
+const double KI = 0.02;             // 积分增益
+const double DEADBAND = 0.03;       // 对数误差死区（约 ±6% 帧时间）
+const double INTEGRAL_LIMIT = 2.0;  // 积分限幅，防止饱和后长时间回不来
+
+} // namespace
+
+void DynamicResolution::configure(const DynamicResolutionSettings& settings) {
+    m_settings = settings;
+    m_settings.minScale = std::clamp(m_settings.minScale, 0.1f, 1.0f);
+    m_settings.maxScale = std::clamp(m_settings.maxScale, m_settings.minScale, 1.0f);
+    if (m_settings.targetFrameMs <= 0.0f) {
+        m_settings.targetFrameMs = 16.0f;
+    }
+    reset();
+}
+
+void DynamicResolution::reset() {
+    m_scale = m_settings.maxScale;
+    m_integral = 0.0;
+    m_lastGpuMs = 0.0;
+}
+
+void DynamicResolution::update(double gpuMs) {
+    m_lastGpuMs = gpuMs;
+    if (!m_settings.enabled || gpuMs <= 0.0) {
+        return;
+    }
+
+    // 帧时间 ∝ scale²，取 0.5 * ln 得到每轴缩放的误差
+    double error = 0.5 * std::log(static_cast<double>(m_settings.targetFrameMs) / gpuMs);
+    if (std::abs(error) < DEADBAND) {
+        m_integral *= 0.9;  // 稳定时缓慢释放积分
+        return;
+    }
+
+    double integral = std::clamp(m_integral + error, -INTEGRAL_LIMIT, INTEGRAL_LIMIT);
+    double adjust = std::exp(KP * error + KI * integral);
+
+    float newScale = static_cast<float>(m_scale * adjust);
+    newScale = std::clamp(newScale, m_settings.minScale, m_settings.maxScale);
+
+    // 到达边界时不再累积积分（anti-windup）
+    if (newScale > m_settings.minScale && newScale < m_settings.maxScale) {
+        m_integral = integral;
+    }
+    m_scale = newScale;
+}
+
+void DynamicResolution::computeSize(int width, int height, int& widthOut, int& heightOut) const {
+    float s = m_settings.enabled ? m_scale : 1.0f;
+    widthOut = std::max(1, static_cast<int>(std::lround(width * s)));
+    heightOut = std::max(1, static_cast<int>(std::lround(height * s)));
+}
+
+} // namespace shadertoy
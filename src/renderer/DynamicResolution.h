@@ -0,0 +1,58 @@
+/**
+ * DynamicResolution - 根据 GPU 帧时间自动调节渲染分辨率
+ *
+ * GPU 时间近似与像素数（即缩放的平方）成正比，控制器在对数域做 PI 调节：
+ *   e = 0.5 * ln(target / measured)
+ *   scale *= exp(Kp * e + Ki * ∫e)
+ * 误差在死区内时保持不变，避免分辨率来回抖动
+ */
+
+#pragma once
+
+#include "../core/ScreensaverMode.h"
+
+namespace shadertoy {
+
+class DynamicResolution {
+public:
+    /**
+     * 应用设置（缩放重置为 maxScale）
+     */
+    void configure(const DynamicResolutionSettings& settings);
+    const DynamicResolutionSettings& getSettings() const { return m_settings; }
+
+    bool isEnabled() const { return m_settings.enabled; }
+
+    /**
+     * 重置控制器状态（切换 shader 后调用）
+     */
+    void reset();
+
+    /**
+     * 输入一次测得的 GPU 帧时间，更新缩放
+     */
+    void update(double gpuMs);
+
+    /**
+     * 当前每轴缩放
+     */
+    float getScale() const { return m_scale; }
+
+    /**
+     * 最近一次测得的 GPU 帧时间（毫秒）
+     */
+    double getLastGpuMs() const { return m_lastGpuMs; }
+
+    /**
+     * 按当前缩放计算渲染尺寸（至少 1x1）
+     */
+    void computeSize(int width, int height, int& widthOut, int& heightOut) const;
+
+private:
+    DynamicResolutionSettings m_settings;
+    float m_scale = 1.0f;
+    double m_integral = 0.0;
+    double m_lastGpuMs = 0.0;
+};
+
+} // namespace shadertoy
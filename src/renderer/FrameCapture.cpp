@@ -0,0 +1,582 @@
+#include "FrameCapture.h"
+
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace shadertoy {
+
+namespace {
+
+// 阻塞等待 fence 时单次等待的超时（纳秒），超时后继续等
+constexpr GLuint64 FENCE_WAIT_NS = 100000000;
+
+void appendBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+template <typename T>
+void appendValue(std::vector<uint8_t>& out, T value) {
+    appendBytes(out, &value, sizeof(T));  // EXR 为小端，与目标平台一致
+}
+
+void appendString(std::vector<uint8_t>& out, const char* str) {
+    appendBytes(out, str, std::strlen(str) + 1);
+}
+
+// EXR 头部属性：名称、类型、大小、值
+void appendAttribute(std::vector<uint8_t>& out, const char* name, const char* type,
+                     const std::vector<uint8_t>& value) {
+    appendString(out, name);
+    appendString(out, type);
+    appendValue<int32_t>(out, static_cast<int32_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// 单层扫描线 OpenEXR，32 位浮点 RGBA，无压缩
+// pixels 为 GL 行序（自下而上）的 RGBA float
+bool writeExr(const std::string& path, int width, int height, const float* pixels,
+              std::vector<uint8_t>& buffer) {
+    buffer.clear();
+    appendValue<int32_t>(buffer, 20000630);  // magic
+    appendValue<int32_t>(buffer, 2);         // 版本 2，单层扫描线
+
+    // 通道按名称字母序排列
+    static const char* const CHANNELS[] = {"A", "B", "G", "R"};
+    static const int CHANNEL_OFFSETS[] = {3, 2, 1, 0};
+
+    std::vector<uint8_t> value;
+    for (const char* channel : CHANNELS) {
+        appendString(value, channel);
+        appendValue<int32_t>(value, 2);      // FLOAT
+        appendValue<uint8_t>(value, 0);      // pLinear
+        appendValue<uint8_t>(value, 0);      // reserved
+        appendValue<uint8_t>(value, 0);
+        appendValue<uint8_t>(value, 0);
+        appendValue<int32_t>(value, 1);      // xSampling
+        appendValue<int32_t>(value, 1);      // ySampling
+    }
+    appendValue<uint8_t>(value, 0);
+    appendAttribute(buffer, "channels", "chlist", value);
+
+    value.clear();
+    appendValue<uint8_t>(value, 0);          // NO_COMPRESSION
+    appendAttribute(buffer, "compression", "compression", value);
+
+    value.clear();
+    appendValue<int32_t>(value, 0);
+    appendValue<int32_t>(value, 0);
+    appendValue<int32_t>(value, width - 1);
+    appendValue<int32_t>(value, height - 1);
+    appendAttribute(buffer, "dataWindow", "box2i", value);
+    appendAttribute(buffer, "displayWindow", "box2i", value);
+
+    value.clear();
+    appendValue<uint8_t>(value, 0);          // INCREASING_Y
+    appendAttribute(buffer, "lineOrder", "lineOrder", value);
+
+    value.clear();
+    appendValue<float>(value, 1.0f);
+    appendAttribute(buffer, "pixelAspectRatio", "float", value);
+    appendAttribute(buffer, "screenWindowWidth", "float", value);
+
+    value.clear();
+    appendValue<float>(value, 0.0f);
+    appendValue<float>(value, 0.0f);
+    appendAttribute(buffer, "screenWindowCenter", "v2f", value);
+
+    appendValue<uint8_t>(buffer, 0);         // 头部结束
+
+    // 行偏移表，之后每个块为：y、数据大小、按通道排列的一行
+    const size_t lineBytes = static_cast<size_t>(width) * 4 * sizeof(float);
+    const uint64_t tableEnd = buffer.size() + static_cast<size_t>(height) * sizeof(uint64_t);
+    for (int y = 0; y < height; y++) {
+        appendValue<uint64_t>(buffer, tableEnd + static_cast<uint64_t>(y) * (8 + lineBytes));
+    }
+
+    buffer.reserve(buffer.size() + static_cast<size_t>(height) * (8 + lineBytes));
+    for (int y = 0; y < height; y++) {
+        appendValue<int32_t>(buffer, y);
+        appendValue<int32_t>(buffer, static_cast<int32_t>(lineBytes));
+
+        const float* row = pixels + static_cast<size_t>(height - 1 - y) * width * 4;
+        for (int c = 0; c < 4; c++) {
+            for (int x = 0; x < width; x++) {
+                appendValue<float>(buffer, row[x * 4 + CHANNEL_OFFSETS[c]]);
+            }
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// GL 行序的 RGBA8 -> 自上而下的 RGB8（Shadertoy 画布忽略 alpha）
+void toTopDownRgb(const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out) {
+    out.resize(static_cast<size_t>(width) * height * 3);
+    uint8_t* dst = out.data();
+    for (int y = height - 1; y >= 0; y--) {
+        const uint8_t* src = rgba + static_cast<size_t>(y) * width * 4;
+        for (int x = 0; x < width; x++) {
+            *dst++ = src[x * 4 + 0];
+            *dst++ = src[x * 4 + 1];
+            *dst++ = src[x * 4 + 2];
+        }
+    }
+}
+
+// GL 行序的 RGBA8 -> 自上而下的 Y / Cb / Cr 三个平面（BT.601 有限范围，4:4:4）
+void toTopDownYuv444(const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out) {
+    const size_t planeSize = static_cast<size_t>(width) * height;
+    out.resize(planeSize * 3);
+    uint8_t* yPlane = out.data();
+    uint8_t* uPlane = yPlane + planeSize;
+    uint8_t* vPlane = uPlane + planeSize;
+
+    size_t i = 0;
+    for (int y = height - 1; y >= 0; y--) {
+        const uint8_t* src = rgba + static_cast<size_t>(y) * width * 4;
+        for (int x = 0; x < width; x++, i++) {
+            int r = src[x * 4 + 0];
+            int g = src[x * 4 + 1];
+            int b = src[x * 4 + 2];
+            yPlane[i] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            uPlane[i] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[i] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+// GL 行序的 RGBA8 -> 自上而下的 RGBA8
+void toTopDownRgba(const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out) {
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    out.resize(rowBytes * height);
+    for (int y = 0; y < height; y++) {
+        std::memcpy(out.data() + static_cast<size_t>(y) * rowBytes,
+                    rgba + static_cast<size_t>(height - 1 - y) * rowBytes, rowBytes);
+    }
+}
+
+bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+const char* getExtension(CaptureFormat format) {
+    switch (format) {
+        case CaptureFormat::EXR: return "exr";
+        case CaptureFormat::Raw: return "rgba";
+        case CaptureFormat::PNG:
+        default: return "png";
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// CaptureSettings
+// ============================================================================
+
+const char* CaptureSettings::formatToString(CaptureFormat format) {
+    switch (format) {
+        case CaptureFormat::EXR: return "exr";
+        case CaptureFormat::Raw: return "raw";
+        case CaptureFormat::Y4M: return "y4m";
+        case CaptureFormat::RawStream: return "rgba";
+        case CaptureFormat::PNG:
+        default: return "png";
+    }
+}
+
+CaptureFormat CaptureSettings::stringToFormat(const std::string& str) {
+    if (str == "exr") return CaptureFormat::EXR;
+    if (str == "raw") return CaptureFormat::Raw;
+    if (str == "y4m") return CaptureFormat::Y4M;
+    if (str == "rgba") return CaptureFormat::RawStream;
+    if (str == "png") return CaptureFormat::PNG;
+    return CaptureFormat::Count;
+}
+
+// ============================================================================
+// 开始 / 结束
+// ============================================================================
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+bool FrameCapture::start(const CaptureSettings& settings, std::string& errorOut) {
+    stop();
+
+    if (settings.format == CaptureFormat::Count) {
+        errorOut = "Unknown capture format";
+        return false;
+    }
+    if (settings.every < 1 || settings.ringSize < 1 || settings.maxQueuedFrames < 1) {
+        errorOut = "Capture interval, ring size and queue size must be positive";
+        return false;
+    }
+
+    m_settings = settings;
+    m_settings.ringSize = std::min(settings.ringSize, MAX_RING_SIZE);
+
+    if (CaptureSettings::isStream(m_settings.format)) {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        std::cout.flush();
+        m_stream = stdout;
+        m_savedCoutBuf = std::cout.rdbuf(std::cerr.rdbuf());
+    } else {
+        std::error_code ec;
+        fs::create_directories(m_settings.outputDir, ec);
+        if (ec) {
+            errorOut = "Cannot create " + m_settings.outputDir + ": " + ec.message();
+            return false;
+        }
+    }
+
+    m_slots.resize(static_cast<size_t>(m_settings.ringSize));
+    for (auto& slot : m_slots) {
+        glGenBuffers(1, &slot.pbo);
+    }
+
+    m_frameCounter = 0;
+    m_forceNext = false;
+    m_streamWidth = 0;
+    m_streamHeight = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats = CaptureStats();
+        m_lastError.clear();
+        m_stopWriter = false;
+    }
+    m_writer = std::thread(&FrameCapture::writerLoop, this);
+    m_active = true;
+
+    std::cout << "FrameCapture: Started " << CaptureSettings::formatToString(m_settings.format) << " capture";
+    if (m_stream) {
+        std::cout << " to stdout";
+    } else {
+        std::cout << " to " << m_settings.outputDir;
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+void FrameCapture::stop() {
+    if (!m_active) {
+        return;
+    }
+
+    // 按帧序等待剩余的读回
+    while (Slot* slot = oldestPending()) {
+        retire(*slot, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopWriter = true;
+    }
+    m_queueCv.notify_all();
+    m_spaceCv.notify_all();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+
+    for (auto& slot : m_slots) {
+        if (slot.pbo) {
+            glDeleteBuffers(1, &slot.pbo);
+        }
+    }
+    m_slots.clear();
+    m_freeBuffers.clear();
+    m_active = false;
+
+    if (m_stream) {
+        std::fflush(m_stream);
+        m_stream = nullptr;
+        std::cout.rdbuf(m_savedCoutBuf);
+        m_savedCoutBuf = nullptr;
+    }
+
+    CaptureStats stats = getStats();
+    std::cout << "FrameCapture: Stopped, " << stats.framesWritten << " frames written";
+    if (stats.framesFailed > 0) {
+        std::cout << ", " << stats.framesFailed << " failed";
+    }
+    std::cout << std::endl;
+}
+
+// ============================================================================
+// 读回（GL 线程）
+// ============================================================================
+
+bool FrameCapture::shouldCapture() const {
+    return m_active && (m_forceNext || m_frameCounter % m_settings.every == 0);
+}
+
+bool FrameCapture::capture(GLuint fbo, int width, int height) {
+    if (!m_active) {
+        return false;
+    }
+
+    collect();
+
+    bool wanted = shouldCapture() && width > 0 && height > 0;
+    int frame = m_frameCounter++;
+    if (!wanted) {
+        return false;
+    }
+    m_forceNext = false;
+
+    Slot* slot = acquireSlot();
+    size_t size = static_cast<size_t>(width) * static_cast<size_t>(height) * bytesPerPixel();
+
+    GLint previousReadFbo = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFbo);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    if (slot->capacity < size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+        slot->capacity = size;
+    }
+
+    // 读到 PBO 时 glReadPixels 只提交复制命令，不等待渲染完成
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, isFloat() ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previousReadFbo));
+
+    slot->frame = frame;
+    slot->width = width;
+    slot->height = height;
+    slot->pending = true;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.framesCaptured++;
+    return true;
+}
+
+void FrameCapture::collect() {
+    while (Slot* slot = oldestPending()) {
+        if (!retire(*slot, false)) {
+            break;
+        }
+    }
+}
+
+FrameCapture::Slot* FrameCapture::oldestPending() {
+    Slot* oldest = nullptr;
+    for (auto& slot : m_slots) {
+        if (slot.pending && (!oldest || slot.frame < oldest->frame)) {
+            oldest = &slot;
+        }
+    }
+    return oldest;
+}
+
+FrameCapture::Slot* FrameCapture::acquireSlot() {
+    for (auto& slot : m_slots) {
+        if (!slot.pending) {
+            return &slot;
+        }
+    }
+
+    // GPU 落后超过环的长度：先扩展，到上限后才等待最旧的读回
+    if (static_cast<int>(m_slots.size()) < MAX_RING_SIZE) {
+        m_slots.emplace_back();
+        glGenBuffers(1, &m_slots.back().pbo);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.ringGrowths++;
+        return &m_slots.back();
+    }
+
+    Slot* oldest = oldestPending();
+    retire(*oldest, true);
+    return oldest;
+}
+
+bool FrameCapture::retire(Slot& slot, bool wait) {
+    GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? FENCE_WAIT_NS : 0);
+    while (wait && result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(slot.fence, 0, FENCE_WAIT_NS);
+    }
+    if (result == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    slot.pending = false;
+
+    Frame frame;
+    frame.index = slot.frame;
+    frame.width = slot.width;
+    frame.height = slot.height;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_freeBuffers.empty()) {
+            frame.pixels = std::move(m_freeBuffers.back());
+            m_freeBuffers.pop_back();
+        }
+    }
+
+    size_t size = static_cast<size_t>(slot.width) * static_cast<size_t>(slot.height) * bytesPerPixel();
+    bool mapped = false;
+    if (result != GL_WAIT_FAILED) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+        if (data) {
+            frame.pixels.resize(size);
+            std::memcpy(frame.pixels.data(), data, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            mapped = true;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!mapped) {
+        m_stats.framesFailed++;
+        m_lastError = "Failed to read back frame " + std::to_string(frame.index);
+        m_freeBuffers.push_back(std::move(frame.pixels));
+        return true;
+    }
+
+    // 写出跟不上时等待（磁盘瓶颈），不丢帧
+    if (m_queue.size() >= static_cast<size_t>(m_settings.maxQueuedFrames)) {
+        m_stats.writerWaits++;
+        m_spaceCv.wait(lock, [this]() {
+            return m_stopWriter || m_queue.size() < static_cast<size_t>(m_settings.maxQueuedFrames);
+        });
+    }
+    m_queue.push_back(std::move(frame));
+    lock.unlock();
+    m_queueCv.notify_one();
+    return true;
+}
+
+CaptureStats FrameCapture::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CaptureStats stats = m_stats;
+    stats.queuedFrames = m_queue.size();
+    return stats;
+}
+
+std::string FrameCapture::getLastError() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+// ============================================================================
+// 写出线程
+// ============================================================================
+
+void FrameCapture::writerLoop() {
+    while (true) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queueCv.wait(lock, [this]() { return m_stopWriter || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            break;  // 停止且已写完
+        }
+        Frame frame = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        m_spaceCv.notify_one();
+
+        std::string error;
+        bool ok = writeFrame(frame, error);
+
+        lock.lock();
+        if (ok) {
+            m_stats.framesWritten++;
+        } else {
+            m_stats.framesFailed++;
+            m_lastError = error;
+        }
+        m_freeBuffers.push_back(std::move(frame.pixels));
+    }
+}
+
+bool FrameCapture::writeFrame(Frame& frame, std::string& errorOut) {
+    const int width = frame.width;
+    const int height = frame.height;
+
+    // 流格式：尺寸在第一帧确定
+    if (m_stream) {
+        if (m_streamWidth == 0) {
+            m_streamWidth = width;
+            m_streamHeight = height;
+            if (m_settings.format == CaptureFormat::Y4M) {
+                std::fprintf(m_stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n",
+                             width, height, std::max(1, m_settings.fps));
+            }
+        } else if (width != m_streamWidth || height != m_streamHeight) {
+            errorOut = "Frame " + std::to_string(frame.index) + " size changed, dropped from stream";
+            return false;
+        }
+
+        if (m_settings.format == CaptureFormat::Y4M) {
+            std::fputs("FRAME\n", m_stream);
+            toTopDownYuv444(frame.pixels.data(), width, height, m_scratch);
+        } else {
+            toTopDownRgba(frame.pixels.data(), width, height, m_scratch);
+        }
+        if (std::fwrite(m_scratch.data(), 1, m_scratch.size(), m_stream) != m_scratch.size()) {
+            errorOut = "Failed to write frame " + std::to_string(frame.index) + " to stdout";
+            return false;
+        }
+        return true;
+    }
+
+    char name[256];
+    std::snprintf(name, sizeof(name), "%s_%05d.%s", m_settings.prefix.c_str(), frame.index,
+                  getExtension(m_settings.format));
+    std::string path = (fs::path(m_settings.outputDir) / name).string();
+
+    bool ok = false;
+    switch (m_settings.format) {
+        case CaptureFormat::EXR:
+            ok = writeExr(path, width, height, reinterpret_cast<const float*>(frame.pixels.data()), m_scratch);
+            break;
+        case CaptureFormat::Raw:
+            toTopDownRgba(frame.pixels.data(), width, height, m_scratch);
+            ok = writeFile(path, m_scratch);
+            break;
+        case CaptureFormat::PNG:
+        default:
+            toTopDownRgb(frame.pixels.data(), width, height, m_scratch);
+            ok = stbi_write_png(path.c_str(), width, height, 3, m_scratch.data(), width * 3) != 0;
+            break;
+    }
+
+    if (!ok) {
+        errorOut = "Failed to write " + path;
+    }
+    return ok;
+}
+
+} // namespace shadertoy
@@ -0,0 +1,187 @@
+/**
+ * FrameCapture - 异步帧读回与序列导出
+ *
+ * 每帧的 glReadPixels 写入一个 PBO 环中的下一个 PBO 并插入 fence，立即返回；
+ * 之后的帧轮询 fence，GPU 完成的 PBO 才映射拷贝，交给写出线程编码，渲染循环不等待读回
+ * 支持 PNG / EXR / 原始 RGBA 序列，以及向 stdout 输出 Y4M / 原始 RGBA 视频流
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace shadertoy {
+
+/**
+ * 导出格式
+ */
+enum class CaptureFormat {
+    PNG,            // 8 位 RGB，每帧一个文件
+    EXR,            // 32 位浮点 RGBA，无压缩，每帧一个文件（适合读取浮点 Buffer）
+    Raw,            // 8 位 RGBA，自上而下，无文件头，每帧一个文件
+    Y4M,            // YUV 4:4:4 视频流写到 stdout（如 | ffmpeg -i - out.mp4）
+    RawStream,      // 8 位 RGBA 视频流写到 stdout（ffmpeg -f rawvideo -pix_fmt rgba）
+    Count
+};
+
+/**
+ * 导出设置
+ */
+struct CaptureSettings {
+    CaptureFormat format = CaptureFormat::PNG;
+    std::string outputDir = "capture";  // 序列格式的输出目录
+    std::string prefix = "frame";       // 文件名 <prefix>_00000.<ext>
+    int source = -1;                    // -1 = Image 输出，0-3 = Buffer A-D
+    int every = 1;                      // 每 N 帧读回一次
+    int fps = 60;                       // Y4M 文件头中的帧率
+    int ringSize = 3;                   // PBO 数量（读回在 GPU 上的最大延迟帧数）
+    int maxQueuedFrames = 16;           // 写出线程积压上限，超过时等待写出（导出不丢帧）
+
+    static const char* formatToString(CaptureFormat format);
+    static CaptureFormat stringToFormat(const std::string& str);
+
+    // 写到 stdout 的流格式
+    static bool isStream(CaptureFormat format) {
+        return format == CaptureFormat::Y4M || format == CaptureFormat::RawStream;
+    }
+};
+
+/**
+ * 导出统计
+ */
+struct CaptureStats {
+    int framesCaptured = 0;     // 已发起读回
+    int framesWritten = 0;      // 已写出
+    int framesFailed = 0;       // 写出失败或尺寸不符被丢弃
+    int ringGrowths = 0;        // PBO 不够用时追加的次数
+    int writerWaits = 0;        // 写出线程积压导致的等待次数
+    size_t queuedFrames = 0;    // 当前等待写出的帧数
+};
+
+class FrameCapture {
+public:
+    // PBO 环最多扩展到的数量
+    static constexpr int MAX_RING_SIZE = 8;
+
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    // 禁止拷贝
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * 开始导出：创建输出目录（序列格式）并启动写出线程（GL 线程）
+     * 流格式期间 std::cout 被重定向到 stderr，stdout 只包含视频数据
+     */
+    bool start(const CaptureSettings& settings, std::string& errorOut);
+
+    /**
+     * 结束导出：等待所有读回完成并写出，停止写出线程，释放 PBO（GL 线程）
+     */
+    void stop();
+
+    bool isActive() const { return m_active; }
+    const CaptureSettings& getSettings() const { return m_settings; }
+
+    /**
+     * 本帧是否需要读回（按 every 计数；forceNext() 后的下一帧总是读回）
+     */
+    bool shouldCapture() const;
+
+    /**
+     * 下一帧无论 every 如何都读回
+     */
+    void forceNext() { m_forceNext = true; }
+
+    /**
+     * 从 fbo 异步读回 width x height，并回收已完成的读回（GL 线程，每帧渲染后调用）
+     * 不需要读回的帧只回收，返回 false
+     */
+    bool capture(GLuint fbo, int width, int height);
+
+    /**
+     * 回收 GPU 已完成的读回，交给写出线程（GL 线程，不阻塞）
+     */
+    void collect();
+
+    CaptureStats getStats() const;
+
+    /**
+     * 最近一次写出错误
+     */
+    std::string getLastError() const;
+
+private:
+    // PBO 环中的一个槽
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        size_t capacity = 0;
+        int frame = -1;
+        int width = 0;
+        int height = 0;
+        bool pending = false;
+    };
+
+    // 交给写出线程的一帧（行序为 GL 的自下而上）
+    struct Frame {
+        int index = 0;
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    // 读回格式
+    bool isFloat() const { return m_settings.format == CaptureFormat::EXR; }
+    size_t bytesPerPixel() const { return isFloat() ? 4 * sizeof(float) : 4; }
+
+    // 等待槽的 fence 完成并交给写出线程（wait=false 时未完成直接返回 false）
+    bool retire(Slot& slot, bool wait);
+
+    // 帧号最小的未完成槽（没有时返回 nullptr）
+    Slot* oldestPending();
+
+    // 取一个空闲槽，环满时追加，达到上限时等待最旧的槽
+    Slot* acquireSlot();
+
+    void writerLoop();
+    bool writeFrame(Frame& frame, std::string& errorOut);
+
+    CaptureSettings m_settings;
+    bool m_active = false;
+    bool m_forceNext = false;
+    int m_frameCounter = 0;     // start() 以来渲染的帧数，也是文件编号
+
+    std::vector<Slot> m_slots;
+
+    // 写出线程
+    std::thread m_writer;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queueCv;      // 有新帧 / 停止
+    std::condition_variable m_spaceCv;      // 积压减少
+    std::deque<Frame> m_queue;
+    std::vector<std::vector<uint8_t>> m_freeBuffers;  // 复用的像素内存
+    std::vector<uint8_t> m_scratch;                   // 格式转换（仅写出线程使用）
+    bool m_stopWriter = false;
+    CaptureStats m_stats;
+    std::string m_lastError;
+
+    // 流格式
+    std::FILE* m_stream = nullptr;
+    int m_streamWidth = 0;
+    int m_streamHeight = 0;
+    std::streambuf* m_savedCoutBuf = nullptr;
+};
+
+} // namespace shadertoy
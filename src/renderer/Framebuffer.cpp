@@ -6,9 +6,16 @@ Framebuffer::~Framebuffer() {
     cleanup();
 }
 
-bool Framebuffer::create(int width, int height) {
+bool Framebuffer::create(int width, int height, GLenum internalFormat, GLenum filter, GLenum wrap) {
     m_width = width;
     m_height = height;
+    m_internalFormat = internalFormat;
+    m_filter = filter;
+    m_wrap = wrap;
+    
+    // 单通道格式使用 GL_RED 作为像素格式（data 为空，仅影响参数校验）
+    GLenum pixelFormat = (internalFormat == GL_R32F || internalFormat == GL_R16F || internalFormat == GL_R8) 
+                         ? GL_RED : GL_RGBA;
 
     glGenFramebuffers(1, &m_fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
@@ -16,11 +23,12 @@ bool Framebuffer::create(int width, int height) {
     // 创建纹理
     glGenTextures(1, &m_texture);
     glBindTexture(GL_TEXTURE_2D, m_texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0, 
+                 pixelFormat, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(filter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(filter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLint>(wrap));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLint>(wrap));
 
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
 
@@ -45,7 +53,7 @@ void Framebuffer::unbind() {
 void Framebuffer::resize(int width, int height) {
     if (width == m_width && height == m_height) return;
     cleanup();
-    create(width, height);
+    create(width, height, m_internalFormat, m_filter, m_wrap);
 }
 
 void Framebuffer::cleanup() {
@@ -9,21 +9,28 @@ public:
     Framebuffer() = default;
     ~Framebuffer();
 
-    bool create(int width, int height);
+    // 默认 RGBA32F + 线性过滤 + Clamp，与 Shadertoy 的 Buffer 一致
+    bool create(int width, int height, GLenum internalFormat = GL_RGBA32F,
+                GLenum filter = GL_LINEAR, GLenum wrap = GL_CLAMP_TO_EDGE);
     void bind();
     void unbind();
     void resize(int width, int height);
     void cleanup();
 
     GLuint getTexture() const { return m_texture; }
+    GLuint getFBO() const { return m_fbo; }
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
+    GLenum getInternalFormat() const { return m_internalFormat; }
 
 private:
     GLuint m_fbo = 0;
     GLuint m_texture = 0;
     int m_width = 0;
     int m_height = 0;
+    GLenum m_internalFormat = GL_RGBA32F;
+    GLenum m_filter = GL_LINEAR;
+    GLenum m_wrap = GL_CLAMP_TO_EDGE;
 };
 
 } // namespace shadertoy
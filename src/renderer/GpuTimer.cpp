@@ -0,0 +1,88 @@
+/**
+ * GpuTimer 实现
+ */
+
+#include "GpuTimer.h"
+
+namespace shadertoy {
+
+void GpuTimer::cleanup() {
+    if (m_created) {
+        glDeleteQueries(QUERY_COUNT, m_queries);
+        for (auto& q : m_queries) q = 0;
+        m_created = false;
+    }
+    m_writeIndex = 0;
+    m_pending = 0;
+    m_active = false;
+    m_lastMs = 0.0;
+}
+
+void GpuTimer::begin(int64_t tag) {
+    if (!m_created) {
+        glGenQueries(QUERY_COUNT, m_queries);
+        m_created = true;
+    }
+
+    // 环形队列已满：GPU 落后太多，本次不计时
+    if (m_pending >= QUERY_COUNT) {
+        m_active = false;
+        return;
+    }
+
+    m_tags[m_writeIndex] = tag;
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_writeIndex]);
+    m_active = true;
+}
+
+void GpuTimer::end() {
+    if (!m_active) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_writeIndex = (m_writeIndex + 1) % QUERY_COUNT;
+    m_pending++;
+    m_active = false;
+}
+
+bool GpuTimer::poll(double& msOut) {
+    bool gotResult = false;
+    double ms = 0.0;
+    int64_t tag = 0;
+
+    while (pollNext(ms, tag)) {
+        gotResult = true;
+    }
+
+    if (gotResult) {
+        msOut = m_lastMs;
+    }
+    return gotResult;
+}
+
+bool GpuTimer::pollNext(double& msOut, int64_t& tagOut) {
+    if (m_pending == 0) {
+        return false;
+    }
+
+    // 按提交顺序取回，最早的未完成时不再检查后面的
+    int oldest = (m_writeIndex - m_pending + QUERY_COUNT) % QUERY_COUNT;
+
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(m_queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(m_queries[oldest], GL_QUERY_RESULT, &elapsedNs);
+    m_lastMs = static_cast<double>(elapsedNs) / 1.0e6;
+    m_pending--;
+
+    msOut = m_lastMs;
+    tagOut = m_tags[oldest];
+    return true;
+}
+
+} // namespace shadertoy
@@ -0,0 +1,72 @@
+/**
+ * GpuTimer - 非阻塞的 GPU 计时（GL_TIME_ELAPSED）
+ *
+ * 使用环形队列保存多个查询对象，结果在若干帧后取回，避免 CPU 等待 GPU
+ * 注意：同一时刻只能有一个 GL_TIME_ELAPSED 查询处于活动状态，不能嵌套
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+
+namespace shadertoy {
+
+class GpuTimer {
+public:
+    static constexpr int QUERY_COUNT = 4;  // 最多允许 N-1 帧延迟
+
+    GpuTimer() = default;
+    ~GpuTimer() { cleanup(); }
+
+    // 禁止拷贝（持有 GL 查询对象）
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    /**
+     * 释放查询对象
+     */
+    void cleanup();
+
+    /**
+     * 开始 / 结束计时（首次调用时创建查询对象）
+     * 所有查询结果都未取回时跳过本次计时，不会阻塞
+     * @param tag 随结果一起返回的标记（如帧号）
+     */
+    void begin(int64_t tag = 0);
+    void end();
+
+    /**
+     * 取回所有已完成的结果（不阻塞）
+     * @param msOut 最近完成的一次计时（毫秒）
+     * @return 是否取回了新结果
+     */
+    bool poll(double& msOut);
+
+    /**
+     * 按提交顺序取回一个已完成的结果（不阻塞）
+     * @return 最早的查询尚未完成时返回 false
+     */
+    bool pollNext(double& msOut, int64_t& tagOut);
+
+    /**
+     * 最近一次取回的结果（毫秒），尚无结果时为 0
+     */
+    double getLastMs() const { return m_lastMs; }
+
+    /**
+     * 是否有已提交但未取回的查询
+     */
+    bool hasPending() const { return m_pending > 0; }
+
+private:
+    GLuint m_queries[QUERY_COUNT] = {};
+    int64_t m_tags[QUERY_COUNT] = {};
+    bool m_created = false;
+    int m_writeIndex = 0;   // 下一个要使用的查询
+    int m_pending = 0;      // 已提交未取回的数量
+    bool m_active = false;  // begin() 成功，等待 end()
+    double m_lastMs = 0.0;
+};
+
+} // namespace shadertoy
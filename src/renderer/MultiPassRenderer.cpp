@@ -3,6 +3,10 @@
  */
 
 #include "MultiPassRenderer.h"
+#include "TextureManager.h"
+#include "../utils/Hash.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
@@ -15,29 +19,67 @@ namespace shadertoy {
 void MultiPassRenderer::init(int width, int height) {
     m_width = width;
     m_height = height;
+    m_renderWidth = width;
+    m_renderHeight = height;
     
     // 预创建 Image pass（始终存在）
     getOrCreatePass(ShaderPassType::Image);
     
+    // 允许驱动在后台线程编译 shader
+    ShaderEngine::enableParallelCompile();
+    
     std::cout << "MultiPassRenderer: Initialized (" << width << "x" << height << ")" << std::endl;
 }
 
-void MultiPassRenderer::resize(int width, int height) {
+void MultiPassRenderer::resize(int width, int height, bool coalesce) {
     if (width == m_width && height == m_height) return;
     
     m_width = width;
     m_height = height;
     
-    // 调整所有 Buffer 大小
-    m_bufferManager.resize(width, height);
+    // 拖动窗口时每帧都有新尺寸，Buffer 等尺寸稳定后再重建
+    m_bufferResizePending = true;
+    m_lastResizeTime = std::chrono::steady_clock::now();
+    if (!coalesce) {
+        applyBufferResize(true);
+    }
+    
+    // 缩放 FBO 在下一帧按新尺寸重建
+    m_scaledTarget.reset();
+    m_renderWidth = width;
+    m_renderHeight = height;
     
     std::cout << "MultiPassRenderer: Resized to " << width << "x" << height << std::endl;
 }
 
+void MultiPassRenderer::applyBufferResize(bool force) {
+    if (!m_bufferResizePending) return;
+    
+    auto elapsed = std::chrono::steady_clock::now() - m_lastResizeTime;
+    if (!force && elapsed < std::chrono::milliseconds(RESIZE_SETTLE_MS)) return;
+    
+    m_bufferResizePending = false;
+    m_bufferManager.resize(m_width, m_height, m_preserveBuffersOnResize);
+    
+    // 不保留内容时从干净的 Buffer 重新开始（并重新预热）
+    if (!m_preserveBuffersOnResize) {
+        m_bufferManager.clearAll();
+        m_warmUpPending = m_warmUp.frames > 0;
+    }
+}
+
 void MultiPassRenderer::cleanup() {
+    cancelCompile();
+    m_capture.stop();
     m_bufferManager.cleanup();
     m_passes.clear();
     m_commonCode.clear();
+    m_graph.clear();
+    m_graphDirty = true;
+    m_frameTimer.cleanup();
+    m_profiler.cleanup();
+    m_scaledTarget.reset();
+    m_bufferResizePending = false;
 }
 
 // ============================================================================
@@ -66,6 +108,7 @@ bool MultiPassRenderer::compilePass(ShaderPassType type, const std::string& code
     
     PassRenderState& pass = getOrCreatePass(type);
     pass.channels = channels;
+    m_graphDirty = true;
     
     // 如果代码为空，禁用该 pass
     if (code.empty()) {
@@ -80,34 +123,37 @@ bool MultiPassRenderer::compilePass(ShaderPassType type, const std::string& code
         return true;
     }
     
-    // 组合 Common 代码和 Pass 代码
-    std::string fullCode;
-    if (!m_commonCode.empty()) {
-        fullCode = m_commonCode + "\n\n// ========== Pass Code ==========\n\n" + code;
-    } else {
-        fullCode = code;
+    // 源码未变化时沿用已编译的程序
+    uint64_t sourceHash = computeSourceHash(m_commonCode, code);
+    if (isPassUpToDate(type, sourceHash)) {
+        return true;
     }
     
-    // 转译代码
-    std::string transpiledCode = m_transpiler.transpile(fullCode);
+    // 组合 Common 代码并转译
+    std::string transpiledCode = buildPassSource(m_commonCode, code);
     
     // 确保 shader engine 存在
     if (!pass.shader) {
         pass.shader = std::make_unique<ShaderEngine>();
     }
     
-    // 编译
+    // 编译（同步，提交耗时等于总耗时）
     std::string error;
+    double compileStartUs = m_profiler.nowUs();
     bool success = pass.shader->compileShader(transpiledCode, error);
+    double compileUs = m_profiler.nowUs() - compileStartUs;
+    m_profiler.recordCompile(1, compileStartUs, compileUs, compileUs);
     
     if (success) {
         pass.enabled = true;
         pass.compiled = true;
         pass.lastError.clear();
+        pass.sourceHash = sourceHash;
         
-        // 如果是 Buffer 类型，确保 FBO 已创建
+        // 如果是 Buffer 类型，确保 FBO 已创建（先应用推迟的尺寸变化，所有 Buffer 尺寸一致）
         int bufIdx = BufferManager::typeToIndex(type);
         if (bufIdx >= 0 && m_width > 0 && m_height > 0) {
+            applyBufferResize(true);
             if (!m_bufferManager.isEnabled(bufIdx)) {
                 m_bufferManager.initBuffer(bufIdx, m_width, m_height);
             }
@@ -118,6 +164,7 @@ bool MultiPassRenderer::compilePass(ShaderPassType type, const std::string& code
     } else {
         pass.enabled = false;
         pass.compiled = false;
+        pass.sourceHash = 0;
         pass.lastError = "[" + std::string(PassConfig::getTypeName(type)) + "] " + error;
         
         std::cerr << "MultiPassRenderer: Failed to compile " 
@@ -127,7 +174,255 @@ bool MultiPassRenderer::compilePass(ShaderPassType type, const std::string& code
     return success;
 }
 
+std::string MultiPassRenderer::buildPassSource(const std::string& commonCode, const std::string& code) const {
+    std::string fullCode;
+    if (!commonCode.empty()) {
+        fullCode = commonCode + "\n\n// ========== Pass Code ==========\n\n" + code;
+    } else {
+        fullCode = code;
+    }
+    return m_transpiler.transpile(fullCode, m_useUniformBuffer);
+}
+
+uint64_t MultiPassRenderer::computeSourceHash(const std::string& commonCode, const std::string& code) const {
+    uint64_t hash = Hash::combine(Hash::FNV_OFFSET, std::to_string(GLSLTranspiler::VERSION) +
+                                                    (m_useUniformBuffer ? ":ubo" : ":uniforms"));
+    hash = Hash::combine(hash, commonCode);
+    hash = Hash::combine(hash, code);
+    return hash != 0 ? hash : 1;
+}
+
+bool MultiPassRenderer::isPassUpToDate(ShaderPassType type, uint64_t sourceHash) const {
+    auto it = m_passes.find(type);
+    if (it == m_passes.end()) {
+        return false;
+    }
+    const PassRenderState& pass = it->second;
+    return pass.compiled && pass.enabled && pass.sourceHash == sourceHash &&
+           pass.shader && pass.shader->isValid();
+}
+
+// ============================================================================
+// 异步编译
+// ============================================================================
+
+bool MultiPassRenderer::beginCompile(const std::vector<PassConfig>& passes) {
+    cancelCompile();
+    m_compileStartUs = m_profiler.nowUs();
+    
+    // Common 代码先确定，所有 Pass 使用同一份
+    m_pendingCommonCode.clear();
+    for (const auto& pass : passes) {
+        if (pass.type == ShaderPassType::Common) {
+            m_pendingCommonCode = pass.code;
+        }
+    }
+    
+    // 一次性提交所有源码有变化的 Pass，驱动可并行编译
+    // Common 变化时所有 Pass 的哈希都会变化，全部重新编译
+    for (const auto& pass : passes) {
+        if (pass.type == ShaderPassType::Common || !pass.enabled) continue;
+        if (pass.code.find_first_not_of(" \t\n\r") == std::string::npos) continue;
+        
+        PendingPass pending;
+        pending.type = pass.type;
+        pending.channels = pass.channels;
+        pending.bufferSettings = pass.buffer;
+        pending.sourceHash = computeSourceHash(m_pendingCommonCode, pass.code);
+        
+        if (isPassUpToDate(pass.type, pending.sourceHash)) {
+            pending.reused = true;
+            pending.status = CompileStatus::Ready;
+            m_pendingPasses.push_back(std::move(pending));
+            continue;
+        }
+        
+        pending.shader = std::make_unique<ShaderEngine>();
+        std::string source = buildPassSource(m_pendingCommonCode, pass.code);
+        if (!pending.shader->beginCompile(source, pending.error)) {
+            pending.status = CompileStatus::Failed;
+        }
+        m_pendingPasses.push_back(std::move(pending));
+    }
+    
+    m_compileSubmitUs = m_profiler.nowUs() - m_compileStartUs;
+    m_compileInFlight = true;
+    return true;
+}
+
+CompileStatus MultiPassRenderer::pollCompile(bool wait) {
+    if (!m_compileInFlight) {
+        return CompileStatus::Idle;
+    }
+    
+    bool allDone = true;
+    for (auto& pending : m_pendingPasses) {
+        if (pending.status != CompileStatus::Pending) continue;
+        
+        pending.status = pending.shader->pollCompile(pending.error, wait);
+        if (pending.status == CompileStatus::Pending) {
+            allDone = false;
+        }
+    }
+    
+    if (!allDone) {
+        return CompileStatus::Pending;
+    }
+    
+    return applyPendingCompile();
+}
+
+CompileStatus MultiPassRenderer::applyPendingCompile() {
+    m_commonCode = m_pendingCommonCode;
+    
+    // Buffer 在切换后被清空，推迟的尺寸变化直接应用，新建的 Buffer 与已有的尺寸一致
+    applyBufferResize(true);
+    
+    // 本次未编译的 Pass 全部禁用
+    for (ShaderPassType type : RENDER_PASSES) {
+        bool included = false;
+        for (const auto& pending : m_pendingPasses) {
+            if (pending.type == type) {
+                included = true;
+                break;
+            }
+        }
+        if (!included) {
+            disablePass(type);
+        }
+    }
+    
+    bool allSuccess = true;
+    int compiledCount = 0;
+    std::vector<int> recompiledBuffers;
+    for (auto& pending : m_pendingPasses) {
+        PassRenderState& pass = getOrCreatePass(pending.type);
+        pass.channels = pending.channels;
+        const char* typeName = PassConfig::getTypeName(pending.type);
+        
+        if (pending.reused) {
+            // 程序不变，只更新绑定和渲染目标设置
+            int bufIdx = BufferManager::typeToIndex(pending.type);
+            if (bufIdx >= 0) {
+                m_bufferManager.setBufferSettings(bufIdx, pending.bufferSettings);
+            }
+            std::cout << "MultiPassRenderer: " << typeName << " unchanged, skipped compile" << std::endl;
+            continue;
+        }
+        
+        compiledCount++;
+        if (int bufIdx = BufferManager::typeToIndex(pending.type); bufIdx >= 0) {
+            recompiledBuffers.push_back(bufIdx);
+        }
+        if (pending.status == CompileStatus::Ready && pending.shader->commitCompile()) {
+            pass.shader = std::move(pending.shader);
+            pass.enabled = true;
+            pass.compiled = true;
+            pass.lastError.clear();
+            pass.sourceHash = pending.sourceHash;
+            
+            // 如果是 Buffer 类型，应用渲染目标设置并确保 FBO 已创建
+            int bufIdx = BufferManager::typeToIndex(pending.type);
+            if (bufIdx >= 0) {
+                m_bufferManager.setBufferSettings(bufIdx, pending.bufferSettings);
+            }
+            if (bufIdx >= 0 && m_width > 0 && m_height > 0) {
+                if (!m_bufferManager.isEnabled(bufIdx)) {
+                    m_bufferManager.initBuffer(bufIdx, m_width, m_height);
+                }
+            }
+            
+            std::cout << "MultiPassRenderer: Compiled " << typeName << " successfully" << std::endl;
+        } else {
+            pass.enabled = false;
+            pass.compiled = false;
+            pass.sourceHash = 0;
+            pass.lastError = "[" + std::string(typeName) + "] " + pending.error;
+            allSuccess = false;
+            
+            std::cerr << "MultiPassRenderer: Failed to compile " 
+                      << typeName << ":\n" << pending.error << std::endl;
+        }
+    }
+    
+    m_pendingPasses.clear();
+    m_pendingCommonCode.clear();
+    m_compileInFlight = false;
+    m_graphDirty = true;
+    
+    m_profiler.recordCompile(compiledCount, m_compileStartUs,
+                             m_compileSubmitUs, m_profiler.nowUs() - m_compileStartUs);
+    
+    bool profileLoad = m_hasPendingProfileSettings;
+    if (m_hasPendingProfileSettings) {
+        setDynamicResolution(m_pendingDynamicResolution);
+        m_warmUp = m_pendingWarmUp;
+        m_hasPendingProfileSettings = false;
+    } else if (compiledCount > 0 && m_dynamicResolution.isEnabled()) {
+        // 新 shader 的开销未知，从最大缩放重新收敛
+        m_dynamicResolution.reset();
+    }
+    
+    // 新 Profile 从干净的 Buffer 开始；编辑时只清除重新编译的 Pass 的 Buffer，
+    // 未改动的 Pass 保留各自的模拟状态，没有重新编译任何 Pass 时不重新预热
+    if (profileLoad) {
+        m_bufferManager.clearAll();
+    } else {
+        for (int bufIdx : recompiledBuffers) {
+            m_bufferManager.clearBuffer(bufIdx);
+        }
+    }
+    if (profileLoad || compiledCount > 0) {
+        m_warmUpPending = m_warmUp.frames > 0;
+        m_warmUpFrameOffset = 0;
+        m_warmUpTimeOffset = 0.0f;
+    }
+    
+    return allSuccess ? CompileStatus::Ready : CompileStatus::Failed;
+}
+
+void MultiPassRenderer::cancelCompile() {
+    m_pendingPasses.clear();  // ShaderEngine 析构时删除挂起的 GL 对象
+    m_pendingCommonCode.clear();
+    m_compileInFlight = false;
+    m_hasPendingProfileSettings = false;
+}
+
+bool MultiPassRenderer::beginLoadProfile(const ScreensaverProfile& profile) {
+    // passes 可能包含空的默认 Pass，需要检查是否有实际代码
+    bool hasMultiPassCode = false;
+    for (const auto& pass : profile.passes) {
+        if (!pass.code.empty()) {
+            hasMultiPassCode = true;
+            break;
+        }
+    }
+    
+    std::cout << "MultiPassRenderer: Loading profile '" << profile.name << "' ("
+              << profile.passes.size() << " passes)" << std::endl;
+    
+    bool submitted = false;
+    if (hasMultiPassCode) {
+        submitted = beginCompile(profile.passes);
+    } else if (!profile.shaderCode.empty()) {
+        // 兼容旧的单 Pass 配置（shaderCode）
+        PassConfig imagePass(ShaderPassType::Image, profile.shaderCode);
+        for (int ch = 0; ch < 4; ch++) {
+            imagePass.channels[static_cast<size_t>(ch)] = profile.channelBindings[ch];
+        }
+        submitted = beginCompile({imagePass});
+    }
+    
+    if (submitted) {
+        m_pendingDynamicResolution = profile.dynamicResolution;
+        m_pendingWarmUp = profile.warmUp;
+        m_hasPendingProfileSettings = true;
+    }
+    return submitted;
+}
+
 void MultiPassRenderer::disablePass(ShaderPassType type) {
+    m_graphDirty = true;
     auto it = m_passes.find(type);
     if (it != m_passes.end()) {
         it->second.enabled = false;
@@ -174,57 +469,337 @@ std::string MultiPassRenderer::getAllErrors() const {
 // ============================================================================
 
 void MultiPassRenderer::render(
-    std::function<void(GLuint, ShaderPassType)> uniforms,
-    std::function<void(GLuint, int, int)> bindTextures,
+    std::function<void(const ShaderEngine&, ShaderPassType)> uniforms,
+    std::function<void(const ShaderEngine&, int, int)> bindTextures,
     std::function<void()> renderQuad)
 {
-    static int frameCount = 0;
-    frameCount++;
-    bool shouldLog = (frameCount % 300 == 1); // 每 5 秒日志一次（假设 60fps）
-    
-    // 按顺序渲染：Buffer A -> B -> C -> D -> Image
-    for (ShaderPassType type : RENDER_ORDER) {
-        // 如果是 Debug Buffer 模式且这是 Image pass，使用 Debug Shader
-        if (type == ShaderPassType::Image && m_debugBufferIndex >= 0) {
-            renderDebugBuffer(uniforms, renderQuad);
+    if (m_graphDirty) {
+        updateRenderGraph();
+    }
+    applyBufferResize(false);
+    
+    // 动态分辨率：取回之前帧的 GPU 时间并调整缩放，然后开始本帧计时
+    // 开启 Pass 计时时由各 Pass 的查询代替整帧查询
+    bool gotPassTimings = m_profiler.beginFrame();
+    bool dynamicResolution = m_dynamicResolution.isEnabled();
+    bool frameTimer = dynamicResolution && !m_profiler.isEnabled();
+    if (dynamicResolution) {
+        if (gotPassTimings) {
+            m_dynamicResolution.update(m_profiler.getTotalGpuMs());
+        }
+        updateDynamicResolution();
+    }
+    
+    // 帧全局 uniform 每帧上传一次，所有 Pass 共享（在 beginFrame 之后上传，计时归入本帧）
+    if (m_frameUniforms) {
+        double uploadStartUs = m_profiler.isEnabled() ? m_profiler.nowUs() : 0.0;
+        m_frameUniforms->uploadUniformBuffer();
+        if (m_profiler.isEnabled()) {
+            m_profiler.recordCpu("Uniform buffer", uploadStartUs, m_profiler.nowUs() - uploadStartUs);
+        }
+        m_frameUniforms = nullptr;
+    }
+    
+    if (frameTimer) {
+        m_frameTimer.begin();
+    }
+    
+    // 单 Pass 快速路径：没有 Buffer 需要调度和交换
+    if (m_imageOnly) {
+        renderPass(m_passes[ShaderPassType::Image], uniforms, bindTextures, renderQuad);
+        finishFrame(dynamicResolution, frameTimer);
+        return;
+    }
+    
+    // 按依赖图顺序渲染 Buffer，每个 Buffer 渲染后立即交换
+    bool imageScheduled = false;
+    for (ShaderPassType type : m_graph.getSchedule()) {
+        if (type == ShaderPassType::Image) {
+            imageScheduled = true;
             continue;
         }
         
         auto it = m_passes.find(type);
         if (it == m_passes.end()) {
-            if (shouldLog && type == ShaderPassType::Image) {
-                std::cout << "[Render] Image pass not found in m_passes!" << std::endl;
-            }
             continue;
         }
-        if (!it->second.enabled) {
-            if (shouldLog && type == ShaderPassType::Image) {
-                std::cout << "[Render] Image pass found but NOT enabled!" << std::endl;
+        
+        renderPass(it->second, uniforms, bindTextures, renderQuad);
+        m_bufferManager.finishRender(BufferManager::typeToIndex(type));
+    }
+    
+    // Image Pass 总是最后执行（没有 Pass 读取它）
+    // Debug Buffer 模式下用 Debug Shader 代替
+    if (m_debugBufferIndex >= 0) {
+        m_profiler.beginPass(ShaderPassType::Image);
+        renderDebugBuffer(uniforms, renderQuad);
+        m_profiler.endPass();
+    } else if (imageScheduled) {
+        renderPass(m_passes[ShaderPassType::Image], uniforms, bindTextures, renderQuad);
+    }
+    
+    finishFrame(dynamicResolution, frameTimer);
+}
+
+void MultiPassRenderer::prepare() {
+    if (m_graphDirty) {
+        updateRenderGraph();
+    }
+}
+
+void MultiPassRenderer::runWarmUp(
+    UniformManager& uniformManager,
+    std::function<void(const ShaderEngine&, ShaderPassType)>& uniforms,
+    std::function<void(const ShaderEngine&, int, int)>& bindTextures,
+    std::function<void()>& renderQuad)
+{
+    prepare();
+    applyBufferResize(true);
+    m_warmUpPending = false;
+    
+    int frames = m_warmUp.frames;
+    if (frames <= 0 || m_imageOnly) {
+        return;
+    }
+    
+    double startUs = m_profiler.nowUs();
+    
+    // 低分辨率预热，结束后放大到原尺寸（动态分辨率已经缩小了 Buffer 时不再改变）
+    float baseScale = m_bufferManager.getResolutionScale();
+    float warmUpScale = std::clamp(m_warmUp.scale, 0.125f, 1.0f);
+    bool scaled = warmUpScale < baseScale;
+    if (scaled) {
+        m_bufferManager.setResolutionScale(warmUpScale);
+    }
+    
+    // 预热帧使用固定步长，iFrame 从 0 开始，初始化逻辑照常执行
+    ShadertoyUniforms saved = uniformManager.getUniforms();
+    for (int frame = 0; frame < frames; frame++) {
+        uniformManager.setFrame(frame);
+        uniformManager.setTime(static_cast<float>(frame) * WARM_UP_TIME_STEP);
+        uniformManager.setTimeDelta(WARM_UP_TIME_STEP);
+        uniformManager.uploadUniformBuffer();
+        
+        for (ShaderPassType type : m_graph.getSchedule()) {
+            if (type == ShaderPassType::Image) {
+                continue;
             }
-            continue;
+            auto it = m_passes.find(type);
+            if (it == m_passes.end()) {
+                continue;
+            }
+            renderPass(it->second, uniforms, bindTextures, renderQuad);
+            m_bufferManager.finishRender(BufferManager::typeToIndex(type));
+        }
+    }
+    
+    if (scaled) {
+        m_bufferManager.setResolutionScale(baseScale, true);
+    }
+    
+    m_warmUpFrameOffset = frames;
+    m_warmUpTimeOffset = static_cast<float>(frames) * WARM_UP_TIME_STEP;
+    uniformManager.setFrame(saved.iFrame);
+    uniformManager.setTime(saved.iTime);
+    uniformManager.setTimeDelta(saved.iTimeDelta);
+    
+    std::cout << "MultiPassRenderer: Warmed up buffers for " << frames << " frames";
+    if (scaled) {
+        std::cout << " at " << warmUpScale << "x";
+    }
+    std::cout << " (" << (m_profiler.nowUs() - startUs) / 1000.0 << " ms submit)" << std::endl;
+}
+
+void MultiPassRenderer::finishFrame(bool dynamicResolution, bool frameTimer) {
+    if (dynamicResolution) {
+        m_profiler.beginUpscale();
+        blitScaledTarget();
+        m_profiler.endPass();
+    }
+    if (frameTimer) {
+        m_frameTimer.end();
+    }
+    m_profiler.endFrame();
+    
+    if (m_capture.isActive()) {
+        captureFrame();
+    }
+}
+
+bool MultiPassRenderer::startCapture(const CaptureSettings& settings, std::string& errorOut) {
+    if (settings.source >= BufferManager::MAX_BUFFERS) {
+        errorOut = "Invalid capture source";
+        return false;
+    }
+    if (settings.source >= 0 && !m_bufferManager.isEnabled(settings.source)) {
+        errorOut = std::string("Buffer ") + static_cast<char>('A' + settings.source) + " is not enabled";
+        return false;
+    }
+    return m_capture.start(settings, errorOut);
+}
+
+void MultiPassRenderer::captureFrame() {
+    int source = m_capture.getSettings().source;
+    if (source < 0) {
+        m_capture.capture(m_outputFramebuffer, m_width, m_height);
+        return;
+    }
+    
+    // Buffer 的 back 为本帧最新结果
+    const BufferPass* buffer = m_bufferManager.getBuffer(source);
+    if (!buffer || !buffer->enabled || !buffer->back) {
+        m_capture.collect();
+        return;
+    }
+    m_capture.capture(buffer->back->getFBO(), buffer->getWidth(), buffer->getHeight());
+}
+
+void MultiPassRenderer::setProfilingEnabled(bool enabled) {
+    if (enabled && !m_profiler.isEnabled()) {
+        m_profiler.reset();
+    }
+    // 两种 GL_TIME_ELAPSED 查询不能同时使用，切换时丢弃未取回的整帧查询
+    m_frameTimer.cleanup();
+    m_profiler.setEnabled(enabled);
+}
+
+bool MultiPassRenderer::exportTrace(const std::string& path, std::string& errorOut) const {
+    if (m_profiler.getTraceEventCount() == 0) {
+        errorOut = "No profiling data recorded";
+        return false;
+    }
+    return m_profiler.writeChromeTrace(path, errorOut);
+}
+
+void MultiPassRenderer::setDynamicResolution(const DynamicResolutionSettings& settings) {
+    m_dynamicResolution.configure(settings);
+    m_frameTimer.cleanup();
+    
+    if (!settings.enabled) {
+        m_scaledTarget.reset();
+        m_renderWidth = m_width;
+        m_renderHeight = m_height;
+        m_bufferManager.setResolutionScale(1.0f);
+    }
+    m_bufferScaleCandidate = m_bufferManager.getResolutionScale();
+    m_bufferScaleHeldFrames = 0;
+    
+    std::cout << "MultiPassRenderer: Dynamic resolution "
+              << (settings.enabled ? "enabled" : "disabled");
+    if (settings.enabled) {
+        std::cout << " (target " << settings.targetFrameMs << " ms, scale "
+                  << settings.minScale << "-" << settings.maxScale << ")";
+    }
+    std::cout << std::endl;
+}
+
+void MultiPassRenderer::updateDynamicResolution() {
+    double gpuMs = 0.0;
+    if (m_frameTimer.poll(gpuMs)) {
+        m_dynamicResolution.update(gpuMs);
+    }
+    
+    m_dynamicResolution.computeSize(m_width, m_height, m_renderWidth, m_renderHeight);
+    
+    // 缩放 FBO 按最大缩放分配一次，缩放变化时只改变使用的区域
+    float maxScale = m_dynamicResolution.getSettings().maxScale;
+    int maxWidth = std::max(1, static_cast<int>(std::lround(m_width * maxScale)));
+    int maxHeight = std::max(1, static_cast<int>(std::lround(m_height * maxScale)));
+    if (!m_scaledTarget || m_scaledTarget->getWidth() != maxWidth || m_scaledTarget->getHeight() != maxHeight) {
+        m_scaledTarget = std::make_unique<Framebuffer>();
+        if (!m_scaledTarget->create(maxWidth, maxHeight, GL_RGBA8)) {
+            std::cerr << "MultiPassRenderer: Failed to create dynamic resolution target" << std::endl;
+            m_scaledTarget.reset();
+            m_renderWidth = m_width;
+            m_renderHeight = m_height;
         }
-        if (!it->second.compiled) {
-            if (shouldLog && type == ShaderPassType::Image) {
-                std::cout << "[Render] Image pass found but NOT compiled!" << std::endl;
+    }
+    m_renderWidth = std::min(m_renderWidth, maxWidth);
+    m_renderHeight = std::min(m_renderHeight, maxHeight);
+    
+    // Buffer 按 1/8 级别缩放，新级别稳定后才重建，并把旧内容缩放到新目标（反馈效果不中断）
+    if (m_dynamicResolution.getSettings().scaleBuffers) {
+        float step = std::clamp(std::ceil(m_dynamicResolution.getScale() * 8.0f) / 8.0f, 0.125f, 1.0f);
+        float current = m_bufferManager.getResolutionScale();
+        if (step == current) {
+            m_bufferScaleHeldFrames = 0;
+        } else {
+            if (step != m_bufferScaleCandidate) {
+                m_bufferScaleCandidate = step;
+                m_bufferScaleHeldFrames = 0;
+            }
+            m_bufferScaleHeldFrames++;
+            
+            // 跨越一级以上说明负载明显变化，立即调整
+            bool largeChange = std::abs(step - current) > 0.125f + 1e-4f;
+            if (largeChange || m_bufferScaleHeldFrames >= BUFFER_SCALE_HOLD_FRAMES) {
+                m_bufferManager.setResolutionScale(step, true);
+                m_bufferScaleHeldFrames = 0;
             }
-            continue;
         }
+    }
+}
+
+void MultiPassRenderer::blitScaledTarget() {
+    if (!m_scaledTarget) {
+        return;
+    }
+    
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_scaledTarget->getFBO());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_outputFramebuffer);
+    glBlitFramebuffer(0, 0, m_renderWidth, m_renderHeight,
+                      0, 0, m_width, m_height,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_outputFramebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void MultiPassRenderer::updateRenderGraph() {
+    std::vector<RenderGraph::PassInput> inputs;
+    for (ShaderPassType type : RENDER_PASSES) {
+        auto it = m_passes.find(type);
+        if (it == m_passes.end()) continue;
         
-        if (shouldLog) {
-            std::cout << "[Render] Rendering pass: " << PassConfig::getTypeName(type) << std::endl;
-        }
+        const PassRenderState& pass = it->second;
+        if (!pass.enabled || !pass.compiled || !pass.shader || !pass.shader->isValid()) continue;
         
-        renderPass(it->second, uniforms, bindTextures, renderQuad);
+        inputs.push_back({type, pass.channels});
+    }
+    
+    std::vector<ShaderPassType> roots = {ShaderPassType::Image};
+    if (m_debugBufferIndex >= 0 && m_debugBufferIndex < BufferManager::MAX_BUFFERS) {
+        roots.push_back(BufferManager::indexToType(m_debugBufferIndex));
+    }
+    
+    m_graph.build(inputs, roots);
+    
+    // 内置纹理按需创建：在这里为参与调度的 Pass 准备好，避免首帧渲染中途生成
+    auto& texMgr = TextureManager::instance();
+    const auto& builtins = texMgr.getBuiltinTextures();
+    for (ShaderPassType type : m_graph.getSchedule()) {
+        for (int binding : m_passes[type].channels) {
+            if (binding >= 0 && binding < static_cast<int>(builtins.size())) {
+                texMgr.getBuiltinTexture(builtins[static_cast<size_t>(binding)].type);
+            }
+        }
     }
     
-    // 在所有 Pass 渲染完成后，交换所有 Buffer
-    m_bufferManager.swapAll();
+    // 只有 Image Pass 时走快速路径（单 Pass 项目）
+    const auto& schedule = m_graph.getSchedule();
+    m_imageOnly = schedule.size() == 1 && schedule[0] == ShaderPassType::Image && m_debugBufferIndex < 0;
+    
+    for (int i = 0; i < BufferManager::MAX_BUFFERS; i++) {
+        m_bufferManager.setPingPong(i, m_graph.needsPingPong(i));
+    }
+    
+    m_graphDirty = false;
+    std::cout << "MultiPassRenderer: Render graph: " << m_graph.describe() << std::endl;
 }
 
 void MultiPassRenderer::renderPass(
     PassRenderState& pass,
-    std::function<void(GLuint, ShaderPassType)>& uniforms,
-    std::function<void(GLuint, int, int)>& bindTextures,
+    std::function<void(const ShaderEngine&, ShaderPassType)>& uniforms,
+    std::function<void(const ShaderEngine&, int, int)>& bindTextures,
     std::function<void()>& renderQuad)
 {
     if (!pass.shader || !pass.shader->isValid()) {
@@ -237,11 +812,28 @@ void MultiPassRenderer::renderPass(
         m_bufferManager.bindBuffer(bufIdx);
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT);
+    } else {
+        // Image Pass 输出到窗口或外部指定的 FBO
+        bindOutputFramebuffer();
     }
     
+    m_profiler.beginPass(pass.type);
+    
     // 使用 shader
     pass.shader->use();
-    GLuint program = pass.shader->getProgram();
+    const ShaderEngine& shader = *pass.shader;
+    
+    // 设置 uniforms（先于纹理绑定，使通道分辨率能被实际纹理尺寸覆盖）
+    double uniformStartUs = m_profiler.isEnabled() ? m_profiler.nowUs() : 0.0;
+    uniforms(shader, pass.type);
+    
+    // iResolution 为实际渲染尺寸（缩放/固定尺寸的 Buffer、动态分辨率下的 Image）
+    GLint resLoc = shader.getUniformLocations().iResolution;
+    if (resLoc >= 0) {
+        int targetWidth = bufIdx >= 0 ? m_bufferManager.getBufferWidth(bufIdx) : m_renderWidth;
+        int targetHeight = bufIdx >= 0 ? m_bufferManager.getBufferHeight(bufIdx) : m_renderHeight;
+        glUniform3f(resLoc, static_cast<float>(targetWidth), static_cast<float>(targetHeight), 1.0f);
+    }
     
     // 绑定纹理
     for (int ch = 0; ch < 4; ch++) {
@@ -250,18 +842,20 @@ void MultiPassRenderer::renderPass(
         // 检查是否是 Buffer 绑定
         if (binding >= ChannelBind::BufferA && binding <= ChannelBind::BufferD) {
             // 绑定 Buffer 纹理
-            bindBufferTexture(program, ch, binding);
+            bindBufferTexture(shader, ch, binding);
         } else {
             // 使用外部回调绑定纹理
-            bindTextures(program, ch, binding);
+            bindTextures(shader, ch, binding);
         }
     }
     
-    // 设置 uniforms
-    uniforms(program, pass.type);
+    if (m_profiler.isEnabled()) {
+        m_profiler.recordUniformUpload(pass.type, uniformStartUs, m_profiler.nowUs() - uniformStartUs);
+    }
     
     // 渲染
     renderQuad();
+    m_profiler.endPass();
     
     // 解绑 FBO
     if (bufIdx >= 0) {
@@ -269,7 +863,7 @@ void MultiPassRenderer::renderPass(
     }
 }
 
-void MultiPassRenderer::bindBufferTexture(GLuint program, int channel, int binding) {
+void MultiPassRenderer::bindBufferTexture(const ShaderEngine& shader, int channel, int binding) {
     int bufIdx = binding - ChannelBind::BufferA;
     
     glActiveTexture(GL_TEXTURE0 + channel);
@@ -281,24 +875,50 @@ void MultiPassRenderer::bindBufferTexture(GLuint program, int channel, int bindi
         glBindTexture(GL_TEXTURE_2D, 0);
     }
     
-    // 设置 iChannel uniform
-    std::string channelName = "iChannel" + std::to_string(channel);
-    GLint channelLoc = glGetUniformLocation(program, channelName.c_str());
-    if (channelLoc >= 0) {
-        glUniform1i(channelLoc, channel);
-    }
-    
-    // 设置 iChannelResolution（使用 Buffer 分辨率）
-    std::string resName = "iChannelResolution[" + std::to_string(channel) + "]";
-    GLint resLoc = glGetUniformLocation(program, resName.c_str());
+    // 设置 iChannelResolution（使用 Buffer 实际分辨率）
+    GLint resLoc = shader.getUniformLocations().iChannelResolution[channel];
     if (resLoc >= 0) {
         glUniform3f(resLoc, 
-            static_cast<float>(m_width),
-            static_cast<float>(m_height),
+            static_cast<float>(m_bufferManager.getBufferWidth(bufIdx)),
+            static_cast<float>(m_bufferManager.getBufferHeight(bufIdx)),
             1.0f);
     }
 }
 
+void MultiPassRenderer::bindBuiltinTexture(const ShaderEngine& shader, int channel, int binding) {
+    auto& texMgr = TextureManager::instance();
+    const auto& builtins = texMgr.getBuiltinTextures();
+    
+    if (binding >= 0 && binding < static_cast<int>(builtins.size())) {
+        const TextureInfo& info = builtins[static_cast<size_t>(binding)];
+        GLuint textureId = texMgr.getBuiltinTexture(info.type);
+        
+        glActiveTexture(GL_TEXTURE0 + channel);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        
+        GLint resLoc = shader.getUniformLocations().iChannelResolution[channel];
+        if (resLoc >= 0) {
+            glUniform3f(resLoc,
+                static_cast<float>(info.width),
+                static_cast<float>(info.height),
+                1.0f);
+        }
+    } else {
+        glActiveTexture(GL_TEXTURE0 + channel);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void MultiPassRenderer::bindOutputFramebuffer() {
+    if (m_dynamicResolution.isEnabled() && m_scaledTarget) {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_scaledTarget->getFBO());
+        glViewport(0, 0, m_renderWidth, m_renderHeight);
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, m_outputFramebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
 GLuint MultiPassRenderer::getBufferTexture(ShaderPassType type) const {
     int bufIdx = BufferManager::typeToIndex(type);
     if (bufIdx < 0) {
@@ -309,11 +929,8 @@ GLuint MultiPassRenderer::getBufferTexture(ShaderPassType type) const {
         return 0;  // Buffer 未启用
     }
     
-    // 返回 front 纹理
-    // 在 swapAll() 之后：front = 交换前的 back = Image pass 实际读取的纹理
-    // 这确保 Debug 面板显示的和 Image pass 看到的一致
-    const BufferPass* buffer = m_bufferManager.getBuffer(bufIdx);
-    return buffer ? buffer->getFrontTexture() : 0;
+    // 返回最近一次渲染的结果，与本帧 Image pass 读取的纹理一致
+    return m_bufferManager.getReadTexture(bufIdx);
 }
 
 // ============================================================================
@@ -321,6 +938,9 @@ GLuint MultiPassRenderer::getBufferTexture(ShaderPassType type) const {
 // ============================================================================
 
 void MultiPassRenderer::setDebugBuffer(int bufferIndex) {
+    if (bufferIndex != m_debugBufferIndex) {
+        m_graphDirty = true;  // 被查看的 Buffer 成为根节点
+    }
     m_debugBufferIndex = bufferIndex;
     
     // 首次使用时编译 Debug Shader
@@ -352,7 +972,7 @@ void mainImage(out vec4 fragColor, in vec2 fragCoord) {
     }
     
     // 转译代码
-    std::string transpiledCode = m_transpiler.transpile(debugShaderCode);
+    std::string transpiledCode = m_transpiler.transpile(debugShaderCode, m_useUniformBuffer);
     
     // 编译
     std::string error;
@@ -369,7 +989,7 @@ void mainImage(out vec4 fragColor, in vec2 fragCoord) {
 }
 
 void MultiPassRenderer::renderDebugBuffer(
-    std::function<void(GLuint, ShaderPassType)>& uniforms,
+    std::function<void(const ShaderEngine&, ShaderPassType)>& uniforms,
     std::function<void()>& renderQuad)
 {
     // 检查 Debug Shader 是否可用
@@ -390,38 +1010,36 @@ void MultiPassRenderer::renderDebugBuffer(
     }
     
     // 使用 Debug Shader
+    bindOutputFramebuffer();
     m_debugShader->use();
-    GLuint program = m_debugShader->getProgram();
+    
+    // 设置基本 uniforms（iResolution 等）
+    uniforms(*m_debugShader, ShaderPassType::Image);
+    GLint outResLoc = m_debugShader->getUniformLocations().iResolution;
+    if (outResLoc >= 0) {
+        glUniform3f(outResLoc, static_cast<float>(m_renderWidth), static_cast<float>(m_renderHeight), 1.0f);
+    }
     
     // 绑定目标 Buffer 到 iChannel0
     glActiveTexture(GL_TEXTURE0);
     GLuint texId = m_bufferManager.getReadTexture(m_debugBufferIndex);
     glBindTexture(GL_TEXTURE_2D, texId);
     
-    // 设置 iChannel0 uniform
-    GLint channelLoc = glGetUniformLocation(program, "iChannel0");
-    if (channelLoc >= 0) {
-        glUniform1i(channelLoc, 0);
-    }
-    
     // 设置 iChannelResolution[0]
-    GLint resLoc = glGetUniformLocation(program, "iChannelResolution[0]");
+    GLint resLoc = m_debugShader->getUniformLocations().iChannelResolution[0];
     if (resLoc >= 0) {
         glUniform3f(resLoc,
-            static_cast<float>(m_width),
-            static_cast<float>(m_height),
+            static_cast<float>(m_bufferManager.getBufferWidth(m_debugBufferIndex)),
+            static_cast<float>(m_bufferManager.getBufferHeight(m_debugBufferIndex)),
             1.0f);
     }
     
-    // 设置基本 uniforms（iResolution 等）
-    uniforms(program, ShaderPassType::Image);
-    
     // 渲染
     renderQuad();
 }
 
 // 静态成员定义
-constexpr ShaderPassType MultiPassRenderer::RENDER_ORDER[];
+constexpr ShaderPassType MultiPassRenderer::RENDER_PASSES[];
 
 // ============================================================================
 // 简化接口方法（用于屏保模式等）
@@ -477,6 +1095,7 @@ void MultiPassRenderer::setChannelBinding(int channel, int binding) {
     
     PassRenderState& pass = getOrCreatePass(ShaderPassType::Image);
     pass.channels[channel] = binding;
+    m_graphDirty = true;
 }
 
 void MultiPassRenderer::setBufferChannelBinding(int bufferIndex, int channel, int binding) {
@@ -486,25 +1105,51 @@ void MultiPassRenderer::setBufferChannelBinding(int bufferIndex, int channel, in
     ShaderPassType type = BufferManager::indexToType(bufferIndex);
     PassRenderState& pass = getOrCreatePass(type);
     pass.channels[channel] = binding;
+    m_graphDirty = true;
+}
+
+void MultiPassRenderer::setBufferSettings(int bufferIndex, const BufferSettings& settings) {
+    if (bufferIndex < 0 || bufferIndex > 3) return;
+    m_bufferManager.setBufferSettings(bufferIndex, settings);
+}
+
+bool MultiPassRenderer::loadProfile(const ScreensaverProfile& profile) {
+    if (!beginLoadProfile(profile)) {
+        return false;
+    }
+    return pollCompile(true) == CompileStatus::Ready;
 }
 
 void MultiPassRenderer::render(UniformManager& uniformManager, Renderer& renderer) {
     // 包装回调函数
-    auto uniformsCallback = [&uniformManager](GLuint program, ShaderPassType type) {
-        (void)type;  // 所有 Pass 使用相同的 uniforms
-        uniformManager.applyUniforms(program);
-    };
+    std::function<void(const ShaderEngine&, ShaderPassType)> uniformsCallback =
+        [&uniformManager](const ShaderEngine& shader, ShaderPassType type) {
+            (void)type;  // 所有 Pass 使用相同的 uniforms
+            uniformManager.applyUniforms(shader);
+        };
     
-    auto bindTexturesCallback = [this](GLuint program, int channel, int binding) {
-        // 绑定 Buffer 或 Texture 到 channel
-        bindBufferTexture(program, channel, binding);
-    };
+    std::function<void(const ShaderEngine&, int, int)> bindTexturesCallback =
+        [this](const ShaderEngine& shader, int channel, int binding) {
+            // Buffer 绑定已在 renderPass 中处理，这里只处理内置纹理
+            bindBuiltinTexture(shader, channel, binding);
+        };
     
-    auto renderQuadCallback = [&renderer]() {
+    std::function<void()> renderQuadCallback = [&renderer]() {
         renderer.renderFullscreenQuad();
     };
     
-    // 调用主渲染函数
+    // Buffer 刚被清空：先预热，再渲染第一帧
+    if (m_warmUpPending) {
+        runWarmUp(uniformManager, uniformsCallback, bindTexturesCallback, renderQuadCallback);
+    }
+    if (m_warmUpFrameOffset > 0) {
+        const ShadertoyUniforms& current = uniformManager.getUniforms();
+        uniformManager.setFrame(current.iFrame + m_warmUpFrameOffset);
+        uniformManager.setTime(current.iTime + m_warmUpTimeOffset);
+    }
+    
+    // 调用主渲染函数（uniform buffer 在其中 beginFrame 之后上传）
+    m_frameUniforms = &uniformManager;
     render(uniformsCallback, bindTexturesCallback, renderQuadCallback);
 }
 
@@ -2,21 +2,28 @@
  * MultiPassRenderer - 多 Pass 渲染管理器
  * 
  * 管理多个 Shader Pass 的编译和渲染
- * 支持 Buffer A/B/C/D -> Image 的渲染管线
+ * 支持 Buffer A/B/C/D -> Image 的渲染管线，执行顺序由 RenderGraph 根据 Channel 绑定决定
  */
 
 #pragma once
 
 #include "BufferManager.h"
+#include "DynamicResolution.h"
+#include "FrameCapture.h"
+#include "GpuTimer.h"
+#include "PassProfiler.h"
+#include "RenderGraph.h"
 #include "Renderer.h"
 #include "../core/ShaderEngine.h"
 #include "../core/UniformManager.h"
 #include "../core/ScreensaverMode.h"
 #include "../transpiler/GLSLTranspiler.h"
 #include <array>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include <functional>
 
 namespace shadertoy {
@@ -31,6 +38,7 @@ struct PassRenderState {
     bool enabled = false;
     bool compiled = false;
     std::string lastError;
+    uint64_t sourceHash = 0;  // 已编译程序的源码哈希（Common + Pass 代码 + 转译器版本），0 = 无
     
     PassRenderState() = default;
     PassRenderState(ShaderPassType t) : type(t) {
@@ -55,8 +63,18 @@ public:
     
     /**
      * 调整渲染分辨率
+     * @param coalesce 合并连续的尺寸变化（窗口拖动）：Image Pass 立即使用新尺寸，
+     *        Buffer 的重建推迟到尺寸稳定 RESIZE_SETTLE_MS 之后，不会每帧重新分配；
+     *        期间 Buffer 保持旧尺寸，按归一化坐标采样的结果只是被拉伸
      */
-    void resize(int width, int height);
+    void resize(int width, int height, bool coalesce = false);
+    
+    /**
+     * Buffer 重建时是否保留内容（默认开启）：新尺寸的目标创建后先把旧内容缩放 blit 过去再释放，
+     * 模拟类效果不会因调整窗口而重置。关闭时 Buffer 被清空并重新预热
+     */
+    void setPreserveBuffersOnResize(bool enabled) { m_preserveBuffersOnResize = enabled; }
+    bool isPreservingBuffersOnResize() const { return m_preserveBuffersOnResize; }
     
     /**
      * 清理所有资源
@@ -100,15 +118,16 @@ public:
     
     /**
      * 渲染所有 Pass
-     * 顺序: Buffer A -> B -> C -> D -> Image
+     * 按 RenderGraph 的拓扑顺序执行，跳过输出不被使用的 Buffer；
+     * 每个 Buffer 渲染后立即交换，之后的 Pass 读到本帧结果
      * 
-     * @param uniforms Uniform 设置回调 (program, passType)
-     * @param bindTextures 纹理绑定回调 (program, channel, channelBinding)
+     * @param uniforms Uniform 设置回调 (shader, passType)，在纹理绑定前调用
+     * @param bindTextures 纹理绑定回调 (shader, channel, channelBinding)，仅用于非 Buffer 绑定
      * @param renderQuad 渲染四边形回调
      */
     void render(
-        std::function<void(GLuint, ShaderPassType)> uniforms,
-        std::function<void(GLuint, int, int)> bindTextures,
+        std::function<void(const ShaderEngine&, ShaderPassType)> uniforms,
+        std::function<void(const ShaderEngine&, int, int)> bindTextures,
         std::function<void()> renderQuad
     );
     
@@ -125,6 +144,11 @@ public:
      */
     GLuint getBufferTexture(ShaderPassType type) const;
     
+    /**
+     * 获取当前的渲染依赖图（Pass 或绑定变化后在下一次 render() 时重建）
+     */
+    const RenderGraph& getRenderGraph() const { return m_graph; }
+    
     /**
      * 获取当前宽高
      */
@@ -163,11 +187,134 @@ public:
      */
     void setBufferChannelBinding(int bufferIndex, int channel, int binding);
     
+    /**
+     * 设置 Buffer Pass 的渲染目标（格式 / 分辨率缩放 / 过滤 / 环绕），立即生效
+     * 设置变化时该 Buffer 被重新创建，内容清空
+     */
+    void setBufferSettings(int bufferIndex, const BufferSettings& settings);
+    
     /**
      * 简化版渲染（使用 UniformManager 和 Renderer）
      */
     void render(UniformManager& uniformManager, Renderer& renderer);
     
+    /**
+     * 异步编译一组 Pass：所有 shader 同时提交给驱动，不等待结果
+     * 编译期间继续使用旧程序渲染，全部完成后在 pollCompile() 中一次性切换
+     * 切换时未列出（或代码为空）的 Pass 被禁用，Buffer 内容被清除
+     * @param passes 完整的 Pass 列表（Common 代码也从这里读取）
+     * @return 是否成功提交
+     */
+    bool beginCompile(const std::vector<PassConfig>& passes);
+    
+    /**
+     * 轮询异步编译
+     * @param wait true 时阻塞直到所有 Pass 编译完成
+     * @return Pending=仍在编译, Ready=已切换且全部成功, Failed=已切换但有 Pass 失败, Idle=无编译
+     */
+    CompileStatus pollCompile(bool wait = false);
+    
+    /**
+     * 是否有进行中的异步编译
+     */
+    bool isCompiling() const { return m_compileInFlight; }
+    
+    /**
+     * 丢弃进行中的异步编译（当前程序不受影响）
+     */
+    void cancelCompile();
+    
+    /**
+     * 异步加载屏保 Profile（兼容旧的单 Pass shaderCode 格式）
+     * @return 是否成功提交
+     */
+    bool beginLoadProfile(const ScreensaverProfile& profile);
+    
+    /**
+     * 从屏保 Profile 加载所有 Pass（Common / Buffer A-D / Image），阻塞直到编译完成
+     * 各 Pass 仍并行编译
+     * @return 是否全部编译成功
+     */
+    bool loadProfile(const ScreensaverProfile& profile);
+    
+    /**
+     * 提前完成首帧前的准备：重建渲染依赖图并创建被绑定的内置纹理
+     * 后台预加载的渲染器在切换前调用，切换后的第一帧没有额外开销
+     */
+    void prepare();
+    
+    /**
+     * 是否将帧全局 uniform 放入共享的 ShadertoyInputs uniform buffer（默认开启）
+     * 开启时调用方需在每帧渲染前调用 UniformManager::uploadUniformBuffer()
+     * 修改后对之后编译的 Pass 生效
+     */
+    void setUseUniformBuffer(bool enabled) { m_useUniformBuffer = enabled; }
+    bool isUsingUniformBuffer() const { return m_useUniformBuffer; }
+    
+    /**
+     * 设置动态分辨率：Image Pass（可选包括 Buffer）渲染到缩放后的 FBO，
+     * 用 GL_TIME_ELAPSED 测量 GPU 帧时间并自动调节缩放，最后放大 blit 到输出目标
+     * iResolution 始终等于实际渲染尺寸
+     */
+    void setDynamicResolution(const DynamicResolutionSettings& settings);
+    const DynamicResolution& getDynamicResolution() const { return m_dynamicResolution; }
+    
+    /**
+     * 设置 Buffer 预热（加载 Profile 时随 Profile 设置），在 Buffer 下一次被清空后生效
+     * Buffer 被清空（编译切换、调整尺寸）后的第一次 render() 先只运行 Buffer Pass frames 帧，
+     * 不渲染 Image Pass；之后的帧 iFrame / iTime 顺延预热的帧数，与预热结果连续
+     * 仅用于 render(UniformManager&, Renderer&)
+     */
+    void setWarmUp(const WarmUpSettings& settings) { m_warmUp = settings; }
+    const WarmUpSettings& getWarmUp() const { return m_warmUp; }
+    
+    /**
+     * Image Pass 的实际渲染尺寸（未启用动态分辨率时等于 getWidth/getHeight）
+     */
+    int getRenderWidth() const { return m_renderWidth; }
+    int getRenderHeight() const { return m_renderHeight; }
+    
+    /**
+     * 每个 Pass 的 GPU/CPU 计时
+     * 开启后动态分辨率使用各 Pass GPU 时间之和（GL_TIME_ELAPSED 查询不能嵌套）
+     */
+    void setProfilingEnabled(bool enabled);
+    bool isProfilingEnabled() const { return m_profiler.isEnabled(); }
+    const PassProfiler& getProfiler() const { return m_profiler; }
+    
+    /**
+     * 清空计时统计 / 取回已完成但尚未读取的 GPU 结果（用于基准测试分段统计）
+     */
+    void resetProfiling() { m_profiler.reset(); }
+    void flushProfiling() { m_profiler.collect(); }
+    
+    /**
+     * 导出计时记录为 Chrome Trace JSON
+     */
+    bool exportTrace(const std::string& path, std::string& errorOut) const;
+    
+    /**
+     * 开始导出帧序列：每帧渲染结束后把 Image 输出（或指定的 Buffer）异步读回并写出
+     * 读回经 PBO 环和 fence 完成，渲染循环不等待 GPU；只有写出线程积压过多时才等待
+     * @param settings 导出设置（source: -1 = Image 输出, 0-3 = Buffer A-D）
+     */
+    bool startCapture(const CaptureSettings& settings, std::string& errorOut);
+    
+    /**
+     * 结束导出，等待剩余帧写出
+     */
+    void stopCapture() { m_capture.stop(); }
+    
+    FrameCapture& getCapture() { return m_capture; }
+    const FrameCapture& getCapture() const { return m_capture; }
+    
+    /**
+     * 设置 Image Pass 的输出帧缓冲
+     * @param fbo 帧缓冲对象，0 表示默认帧缓冲（窗口）
+     */
+    void setOutputFramebuffer(GLuint fbo) { m_outputFramebuffer = fbo; }
+    GLuint getOutputFramebuffer() const { return m_outputFramebuffer; }
+    
     /**
      * 设置 Debug Buffer 模式
      * @param bufferIndex -1=关闭, 0=Buffer A, 1=B, 2=C, 3=D
@@ -188,18 +335,58 @@ private:
     // 创建或获取 Pass 状态
     PassRenderState& getOrCreatePass(ShaderPassType type);
     
+    // 异步编译完成后切换所有 Pass
+    CompileStatus applyPendingCompile();
+    
+    // 组合 Common 代码并转译
+    std::string buildPassSource(const std::string& commonCode, const std::string& code) const;
+    
+    // 计算 Pass 的源码哈希，并判断已编译的程序是否可以直接复用
+    uint64_t computeSourceHash(const std::string& commonCode, const std::string& code) const;
+    bool isPassUpToDate(ShaderPassType type, uint64_t sourceHash) const;
+    
+    // 依据当前 Pass 和绑定重建渲染依赖图，并设置各 Buffer 的 ping-pong 模式
+    void updateRenderGraph();
+    
     // 渲染单个 Pass
     void renderPass(PassRenderState& pass,
-                    std::function<void(GLuint, ShaderPassType)>& uniforms,
-                    std::function<void(GLuint, int, int)>& bindTextures,
+                    std::function<void(const ShaderEngine&, ShaderPassType)>& uniforms,
+                    std::function<void(const ShaderEngine&, int, int)>& bindTextures,
                     std::function<void()>& renderQuad);
     
     // 绑定 Buffer 纹理到 iChannel
-    void bindBufferTexture(GLuint program, int channel, int binding);
+    void bindBufferTexture(const ShaderEngine& shader, int channel, int binding);
+    
+    // 绑定内置纹理到 iChannel
+    void bindBuiltinTexture(const ShaderEngine& shader, int channel, int binding);
+    
+    // 绑定 Image Pass 的输出目标（动态分辨率时为缩放 FBO）
+    void bindOutputFramebuffer();
+    
+    // 动态分辨率：根据控制器结果更新渲染尺寸和缩放 FBO
+    void updateDynamicResolution();
+    
+    // 动态分辨率：把缩放 FBO 放大输出到最终目标
+    void blitScaledTarget();
+    
+    // 尺寸稳定后（或 force 时）把推迟的尺寸变化应用到 Buffer
+    void applyBufferResize(bool force);
+    
+    // 帧结束：动态分辨率放大、结束整帧计时、导出读回
+    void finishFrame(bool dynamicResolution, bool frameTimer);
+    
+    // 导出：读回本帧的 Image 输出或指定 Buffer
+    void captureFrame();
+    
+    // Buffer 预热：连续运行 Buffer Pass，结束后恢复 uniform 并记录帧偏移
+    void runWarmUp(UniformManager& uniformManager,
+                   std::function<void(const ShaderEngine&, ShaderPassType)>& uniforms,
+                   std::function<void(const ShaderEngine&, int, int)>& bindTextures,
+                   std::function<void()>& renderQuad);
     
     // 渲染 Debug Buffer（使用预制 shader 采样指定 Buffer）
     void renderDebugBuffer(
-        std::function<void(GLuint, ShaderPassType)>& uniforms,
+        std::function<void(const ShaderEngine&, ShaderPassType)>& uniforms,
         std::function<void()>& renderQuad);
 
 private:
@@ -216,13 +403,78 @@ private:
     int m_width = 0;
     int m_height = 0;
     
+    // 推迟的 Buffer 尺寸变化
+    bool m_bufferResizePending = false;
+    bool m_preserveBuffersOnResize = true;
+    std::chrono::steady_clock::time_point m_lastResizeTime;
+    static constexpr int RESIZE_SETTLE_MS = 150;
+    
+    // 进行中的异步编译
+    struct PendingPass {
+        ShaderPassType type = ShaderPassType::Image;
+        std::array<int, 4> channels = {-1, -1, -1, -1};
+        BufferSettings bufferSettings;
+        std::unique_ptr<ShaderEngine> shader;  // 复用时为空
+        CompileStatus status = CompileStatus::Pending;
+        std::string error;
+        uint64_t sourceHash = 0;
+        bool reused = false;  // 源码未变化，沿用当前程序
+    };
+    std::vector<PendingPass> m_pendingPasses;
+    std::string m_pendingCommonCode;
+    bool m_compileInFlight = false;
+    
+    // 帧全局 uniform 使用 uniform buffer
+    bool m_useUniformBuffer = true;
+    
+    // Image Pass 输出目标（0 = 默认帧缓冲）
+    GLuint m_outputFramebuffer = 0;
+    
+    // 动态分辨率
+    DynamicResolution m_dynamicResolution;
+    GpuTimer m_frameTimer;
+    std::unique_ptr<Framebuffer> m_scaledTarget;  // 按 maxScale 分配，按当前缩放使用左下角区域
+    int m_renderWidth = 0;
+    int m_renderHeight = 0;
+    
+    // Buffer 缩放级别的滞回：新级别需连续保持若干帧（或一次跨越多级）才重建 Buffer
+    float m_bufferScaleCandidate = 1.0f;
+    int m_bufferScaleHeldFrames = 0;
+    static constexpr int BUFFER_SCALE_HOLD_FRAMES = 30;
+    
+    // 帧导出
+    FrameCapture m_capture;
+    
+    // 计时
+    PassProfiler m_profiler;
+    UniformManager* m_frameUniforms = nullptr;  // 本帧待上传的 uniform buffer（仅在 render 调用期间有效）
+    double m_compileStartUs = 0.0;
+    double m_compileSubmitUs = 0.0;
+    
+    // 随 Profile 一起生效的设置（在 applyPendingCompile 中应用）
+    DynamicResolutionSettings m_pendingDynamicResolution;
+    WarmUpSettings m_pendingWarmUp;
+    bool m_hasPendingProfileSettings = false;
+    
+    // Buffer 预热
+    WarmUpSettings m_warmUp;
+    bool m_warmUpPending = false;   // Buffer 已清空，下一帧先预热
+    int m_warmUpFrameOffset = 0;    // 预热占用的帧数，加到之后的 iFrame
+    float m_warmUpTimeOffset = 0.0f;
+    static constexpr float WARM_UP_TIME_STEP = 1.0f / 60.0f;
+    
     // Debug Buffer 模式
     int m_debugBufferIndex = -1;  // -1=关闭, 0-3=Buffer A-D
     std::unique_ptr<ShaderEngine> m_debugShader;  // 预制的采样 shader
     bool m_debugShaderCompiled = false;
     
-    // 渲染顺序
-    static constexpr ShaderPassType RENDER_ORDER[] = {
+    // 渲染依赖图
+    RenderGraph m_graph;
+    bool m_graphDirty = true;
+    bool m_imageOnly = false;  // 调度中只有 Image Pass
+    
+    // 可渲染的 Pass 类型
+    static constexpr ShaderPassType RENDER_PASSES[] = {
         ShaderPassType::BufferA,
         ShaderPassType::BufferB,
         ShaderPassType::BufferC,
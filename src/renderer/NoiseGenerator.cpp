@@ -1,10 +1,499 @@
 #include "NoiseGenerator.h"
+#include "utils/ThreadPool.h"
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <limits>
 #include <numeric>
 
+// SSE2 在 x64 上总是可用；其他平台退回标量实现
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SHADERTOY_NOISE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace shadertoy {
 
+namespace {
+
+// 每个并行任务处理的行数
+constexpr int ROWS_PER_CHUNK = 8;
+
+// 关闭时 Perlin / Simplex / FBM 全部走标量路径
+std::atomic<bool> g_simdEnabled{true};
+
+// 按行分块并行执行 fn(y)
+template <typename RowFn>
+void forEachRow(int height, RowFn&& fn) {
+    ThreadPool::instance().parallelFor(0, height, ROWS_PER_CHUNK, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            fn(y);
+        }
+    });
+}
+
+#ifdef SHADERTOY_NOISE_SSE2
+
+// 以下 4 路实现与对应的标量函数逐条对应，运算顺序相同，结果逐位一致
+// （noise-bench 在一组尺寸和参数上逐位比较两条路径的输出，不一致时失败）
+
+// floor，返回浮点结果和整数结果
+// |x| >= 2^23 时 x 本身就是整数，直接返回 x（与 std::floor 一致；超出 int 范围时截断会溢出），
+// 整数结果与标量的 (int) 转换一样取截断值
+inline __m128 floor4(__m128 x, __m128i& intOut) {
+    __m128i truncated = _mm_cvttps_epi32(x);
+    __m128 truncatedF = _mm_cvtepi32_ps(truncated);
+    __m128 isInteger = _mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), x), _mm_set1_ps(8388608.0f));
+    __m128 needsAdjust = _mm_andnot_ps(isInteger, _mm_cmpgt_ps(truncatedF, x));   // 负数向零截断后需要减 1
+    intOut = _mm_add_epi32(truncated, _mm_castps_si128(needsAdjust));
+    __m128 floored = _mm_sub_ps(truncatedF, _mm_and_ps(needsAdjust, _mm_set1_ps(1.0f)));
+    return _mm_or_ps(_mm_and_ps(isInteger, x), _mm_andnot_ps(isInteger, floored));
+}
+
+inline __m128 fade4(__m128 t) {
+    __m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+    __m128 inner = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    inner = _mm_add_ps(_mm_mul_ps(t, inner), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(t3, inner);
+}
+
+inline __m128 lerp4(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+// 取反用符号位异或，与标量的 -u / -2.0f * v 结果相同
+inline __m128 grad4(__m128i hash, __m128 x, __m128 y) {
+    __m128i h = _mm_and_si128(hash, _mm_set1_epi32(7));
+    __m128 useX = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128 u = _mm_or_ps(_mm_and_ps(useX, x), _mm_andnot_ps(useX, y));
+    __m128 v = _mm_or_ps(_mm_and_ps(useX, y), _mm_andnot_ps(useX, x));
+    __m128i signU = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31);
+    __m128i signV = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30);
+    u = _mm_xor_ps(u, _mm_castsi128_ps(signU));
+    v = _mm_xor_ps(_mm_mul_ps(_mm_set1_ps(2.0f), v), _mm_castsi128_ps(signV));
+    return _mm_add_ps(u, v);
+}
+
+// 对应 NoiseGenerator::perlinNoise2D
+__m128 perlinNoise2D4(__m128 x, __m128 y, const int* perm) {
+    __m128i xi, yi;
+    __m128 fx = floor4(x, xi);
+    __m128 fy = floor4(y, yi);
+    x = _mm_sub_ps(x, fx);
+    y = _mm_sub_ps(y, fy);
+
+    alignas(16) int X[4], Y[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(X), _mm_and_si128(xi, _mm_set1_epi32(255)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(Y), _mm_and_si128(yi, _mm_set1_epi32(255)));
+
+    // 排列表查找只能逐通道进行
+    alignas(16) int hAA[4], hBA[4], hAB[4], hBB[4];
+    for (int lane = 0; lane < 4; lane++) {
+        int A = perm[X[lane]] + Y[lane];
+        int B = perm[X[lane] + 1] + Y[lane];
+        hAA[lane] = perm[perm[A]];
+        hAB[lane] = perm[perm[A + 1]];
+        hBA[lane] = perm[perm[B]];
+        hBB[lane] = perm[perm[B + 1]];
+    }
+
+    __m128 u = fade4(x);
+    __m128 v = fade4(y);
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 x1 = _mm_sub_ps(x, one);
+    __m128 y1 = _mm_sub_ps(y, one);
+
+    __m128 res = lerp4(
+        lerp4(grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(hAA)), x, y),
+              grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(hBA)), x1, y), u),
+        lerp4(grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(hAB)), x, y1),
+              grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(hBB)), x1, y1), u),
+        v);
+
+    return _mm_div_ps(_mm_add_ps(res, one), _mm_set1_ps(2.0f));
+}
+
+// 对应 NoiseGenerator::simplexNoise2D
+__m128 simplexNoise2D4(__m128 x, __m128 y, const int* perm) {
+    const float F2 = 0.5f * (std::sqrt(3.0f) - 1.0f);
+    const float G2 = (3.0f - std::sqrt(3.0f)) / 6.0f;
+    const __m128 g2 = _mm_set1_ps(G2);
+
+    __m128 s = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(F2));
+    __m128i i, j;
+    floor4(_mm_add_ps(x, s), i);
+    floor4(_mm_add_ps(y, s), j);
+
+    __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(i, j)), g2);
+    __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+    __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 upper = _mm_cmpgt_ps(x0, y0);
+    __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(upper, one)), g2);
+    __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_andnot_ps(upper, one)), g2);
+    __m128 g2x2 = _mm_set1_ps(2.0f * G2);
+    __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, one), g2x2);
+    __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, one), g2x2);
+
+    alignas(16) int ii[4], jj[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(ii), _mm_and_si128(i, _mm_set1_epi32(255)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(jj), _mm_and_si128(j, _mm_set1_epi32(255)));
+    int upperBits = _mm_movemask_ps(upper);
+
+    alignas(16) int h0[4], h1[4], h2[4];
+    for (int lane = 0; lane < 4; lane++) {
+        int i1 = (upperBits >> lane) & 1;
+        int j1 = 1 - i1;
+        h0[lane] = perm[ii[lane] + perm[jj[lane]]];
+        h1[lane] = perm[ii[lane] + i1 + perm[jj[lane] + j1]];
+        h2[lane] = perm[ii[lane] + 1 + perm[jj[lane] + 1]];
+    }
+
+    // 每个角的贡献，t < 0 的通道置 0
+    auto corner = [](const int* hash, __m128 cx, __m128 cy) {
+        __m128 c = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.5f), _mm_mul_ps(cx, cx)), _mm_mul_ps(cy, cy));
+        __m128 inside = _mm_cmpge_ps(c, _mm_setzero_ps());
+        c = _mm_mul_ps(c, c);
+        __m128 n = _mm_mul_ps(_mm_mul_ps(c, c),
+                              grad4(_mm_load_si128(reinterpret_cast<const __m128i*>(hash)), cx, cy));
+        return _mm_and_ps(inside, n);
+    };
+
+    __m128 n0 = corner(h0, x0, y0);
+    __m128 n1 = corner(h1, x1, y1);
+    __m128 n2 = corner(h2, x2, y2);
+
+    __m128 sum = _mm_add_ps(_mm_add_ps(n0, n1), n2);
+    return _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(70.0f), sum), one), _mm_set1_ps(2.0f));
+}
+
+// 4 个相邻像素横坐标
+inline __m128 pixelX4(int x) {
+    return _mm_cvtepi32_ps(_mm_setr_epi32(x, x + 1, x + 2, x + 3));
+}
+
+#endif // SHADERTOY_NOISE_SSE2
+
+// 分形叠加（Perlin / Simplex / FBM 共用）
+// noise4 处理 4 个像素，noise1 处理行尾剩余像素
+template <typename Noise4, typename Noise1>
+std::vector<float> generateFractal(int width, int height, float scale, int octaves,
+                                   float gain, float lacunarity, Noise4&& noise4, Noise1&& noise1) {
+    std::vector<float> result(width * height);
+    (void)noise4;
+
+    forEachRow(height, [&](int y) {
+        float ny = (float)y / height * scale;
+        float* row = result.data() + y * width;
+        int x = 0;
+
+#ifdef SHADERTOY_NOISE_SSE2
+        const __m128 widthF = _mm_set1_ps((float)width);
+        const __m128 scaleV = _mm_set1_ps(scale);
+        const __m128 nyV = _mm_set1_ps(ny);
+        const int simdEnd = g_simdEnabled.load(std::memory_order_relaxed) ? width : 0;
+        for (; x + 4 <= simdEnd; x += 4) {
+            __m128 nx = _mm_mul_ps(_mm_div_ps(pixelX4(x), widthF), scaleV);
+
+            float amplitude = 1.0f;
+            float frequency = 1.0f;
+            __m128 noiseValue = _mm_setzero_ps();
+            float maxValue = 0.0f;
+
+            for (int o = 0; o < octaves; o++) {
+                __m128 freq = _mm_set1_ps(frequency);
+                __m128 n = noise4(_mm_mul_ps(nx, freq), _mm_mul_ps(nyV, freq));
+                noiseValue = _mm_add_ps(noiseValue, _mm_mul_ps(n, _mm_set1_ps(amplitude)));
+                maxValue += amplitude;
+                amplitude *= gain;
+                frequency *= lacunarity;
+            }
+
+            _mm_storeu_ps(row + x, _mm_div_ps(noiseValue, _mm_set1_ps(maxValue)));
+        }
+#endif
+
+        for (; x < width; x++) {
+            float nx = (float)x / width * scale;
+
+            float amplitude = 1.0f;
+            float frequency = 1.0f;
+            float noiseValue = 0.0f;
+            float maxValue = 0.0f;
+
+            for (int o = 0; o < octaves; o++) {
+                noiseValue += noise1(nx * frequency, ny * frequency) * amplitude;
+                maxValue += amplitude;
+                amplitude *= gain;
+                frequency *= lacunarity;
+            }
+
+            row[x] = noiseValue / maxValue;
+        }
+    });
+
+    return result;
+}
+
+// 平铺（环面）空间上的均匀网格，用于最近点查询
+// 点坐标位于 [0, width) x [0, height)，查询时同时考虑相邻 8 份平铺副本
+class TiledPointGrid {
+public:
+    TiledPointGrid(int width, int height, float cellSize,
+                   const std::vector<float>& pointsX, const std::vector<float>& pointsY)
+        : m_width(width), m_height(height) {
+        m_cols = std::max(1, (int)std::ceil(width / cellSize));
+        m_rows = std::max(1, (int)std::ceil(height / cellSize));
+        m_cellW = (float)width / m_cols;
+        m_cellH = (float)height / m_rows;
+
+        // 按单元格排序（计数 + 前缀和）
+        const int count = (int)pointsX.size();
+        std::vector<int> cellOf(count);
+        m_cellStart.assign(m_cols * m_rows + 1, 0);
+        for (int i = 0; i < count; i++) {
+            cellOf[i] = cellIndex(pointsX[i], pointsY[i]);
+            m_cellStart[cellOf[i] + 1]++;
+        }
+        for (size_t c = 1; c < m_cellStart.size(); c++) {
+            m_cellStart[c] += m_cellStart[c - 1];
+        }
+        m_x.resize(count);
+        m_y.resize(count);
+        std::vector<int> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+        for (int i = 0; i < count; i++) {
+            int slot = fill[cellOf[i]]++;
+            m_x[slot] = pointsX[i];
+            m_y[slot] = pointsY[i];
+        }
+    }
+
+    // (x, y) 到最近点的平方距离，没有点时返回 FLT_MAX
+    // 由近到远逐圈搜索单元格，剩余单元格不可能更近时停止
+    float nearestDist2(float x, float y) const {
+        float best = std::numeric_limits<float>::max();
+        if (m_x.empty()) {
+            return best;
+        }
+
+        int cx = std::min((int)(x / m_cellW), m_cols - 1);
+        int cy = std::min((int)(y / m_cellH), m_rows - 1);
+        const float cellMin = std::min(m_cellW, m_cellH);
+        const int maxRing = std::max(m_cols, m_rows) / 2 + 1;
+
+        for (int ring = 0; ring <= maxRing; ring++) {
+            for (int j = -ring; j <= ring; j++) {
+                bool edgeRow = (j == -ring || j == ring);
+                int step = edgeRow ? 1 : 2 * ring;
+                for (int i = -ring; i <= ring; i += step) {
+                    visitCell(cx + i, cy + j, x, y, best);
+                }
+            }
+
+            // 第 ring + 1 圈的点至少相距 ring 个单元格（留出舍入余量）
+            float reach = ring * cellMin;
+            if (best <= reach * reach * 0.9999f) {
+                break;
+            }
+        }
+
+        return best;
+    }
+
+private:
+    int cellIndex(float x, float y) const {
+        int cx = std::min(std::max((int)(x / m_cellW), 0), m_cols - 1);
+        int cy = std::min(std::max((int)(y / m_cellH), 0), m_rows - 1);
+        return cy * m_cols + cx;
+    }
+
+    void visitCell(int gx, int gy, float x, float y, float& best) const {
+        // 网格外的单元格映射到平铺副本，只考虑相邻的一圈副本
+        int ox = gx < 0 ? -1 : (gx >= m_cols ? 1 : 0);
+        int oy = gy < 0 ? -1 : (gy >= m_rows ? 1 : 0);
+        gx -= ox * m_cols;
+        gy -= oy * m_rows;
+        if (gx < 0 || gx >= m_cols || gy < 0 || gy >= m_rows) {
+            return;
+        }
+
+        int cell = gy * m_cols + gx;
+        for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; k++) {
+            float px = m_x[k] + ox * m_width;
+            float py = m_y[k] + oy * m_height;
+            float d2 = (x - px) * (x - px) + (y - py) * (y - py);
+            best = std::min(best, d2);
+        }
+    }
+
+    int m_width;
+    int m_height;
+    int m_cols = 1;
+    int m_rows = 1;
+    float m_cellW = 1.0f;
+    float m_cellH = 1.0f;
+    std::vector<int> m_cellStart;   // 单元格 c 的点为 [m_cellStart[c], m_cellStart[c + 1])
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+};
+
+// 蓝噪声采样点的最小间距（像素），密度与原先 width * height / 4 个采样点相当
+constexpr float BLUE_NOISE_RADIUS = 1.8f;
+
+// 平铺的 Poisson 盘采样 (Bridson)，任意两点的环面距离不小于 radius
+// 单元格边长不超过 radius / √2，每个单元格至多一个点，候选点只需检查周围 5x5 个单元格，整体 O(n)
+void generatePoissonDisk(int width, int height, float radius, unsigned int seed,
+                         std::vector<float>& xsOut, std::vector<float>& ysOut) {
+    const int MAX_ATTEMPTS = 12;
+    const float cellSize = radius / std::sqrt(2.0f);
+    const int cols = std::max(1, (int)std::ceil(width / cellSize));
+    const int rows = std::max(1, (int)std::ceil(height / cellSize));
+    const float cellW = (float)width / cols;
+    const float cellH = (float)height / rows;
+    const float widthF = (float)width;
+    const float heightF = (float)height;
+    const float radius2 = radius * radius;
+    const float ringRadius = radius * 1.0001f;
+    const float stepCos = std::cos(6.28318530718f / MAX_ATTEMPTS);
+    const float stepSin = std::sin(6.28318530718f / MAX_ATTEMPTS);
+
+    // 网格直接保存点坐标，空单元格用远处的哨兵值，检查时不需要分支
+    // 四周各多出两圈单元格，保存对边点平移后的副本，邻域检查不需要绕回
+    const float EMPTY = 1.0e15f;
+    const int PAD = 2;
+    const int stride = cols + 2 * PAD;
+    std::vector<float> gridX(stride * (rows + 2 * PAD), EMPTY);
+    std::vector<float> gridY(gridX.size(), EMPTY);
+    std::vector<int> active;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    auto cellOf = [&](float x, float y, int& cx, int& cy) {
+        cx = std::min((int)(x / cellW), cols - 1);
+        cy = std::min((int)(y / cellH), rows - 1);
+    };
+
+    auto slotOf = [&](int cx, int cy) {
+        return (cy + PAD) * stride + cx + PAD;
+    };
+
+    // 需要检查的邻域：5x5 去掉四个角，由近到远排列
+    // 角上单元格的最近距离为 √(cellW² + cellH²)，只有单元格正好为 radius / √2 时才不小于 radius；
+    // 实际单元格按整数列数均分，通常更小，此时四个角也要检查
+    static const int NEIGHBORS[25][2] = {
+        {0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1},
+        {-2, 0}, {2, 0}, {0, -2}, {0, 2}, {-2, -1}, {2, -1}, {-2, 1}, {2, 1},
+        {-1, -2}, {1, -2}, {-1, 2}, {1, 2},
+        {-2, -2}, {2, -2}, {-2, 2}, {2, 2}
+    };
+    const int neighborCount = (cellW * cellW + cellH * cellH < radius2) ? 25 : 21;
+    int neighborOffsets[25];
+    for (int k = 0; k < neighborCount; k++) {
+        neighborOffsets[k] = NEIGHBORS[k][1] * stride + NEIGHBORS[k][0];
+    }
+
+    auto fits = [&](float x, float y) {
+        int cx, cy;
+        cellOf(x, y, cx, cy);
+        const int base = slotOf(cx, cy);
+        for (int k = 0; k < neighborCount; k++) {
+            float dx = x - gridX[base + neighborOffsets[k]];
+            float dy = y - gridY[base + neighborOffsets[k]];
+            if (dx * dx + dy * dy < radius2) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto add = [&](float x, float y) {
+        int cx, cy;
+        cellOf(x, y, cx, cy);
+
+        // 靠近边界时在对侧的填充单元格中写入平移副本
+        int shiftsX[3] = {0, 0, 0}, shiftsY[3] = {0, 0, 0};
+        int countX = 1, countY = 1;
+        if (cx < PAD) shiftsX[countX++] = 1;
+        if (cx >= cols - PAD) shiftsX[countX++] = -1;
+        if (cy < PAD) shiftsY[countY++] = 1;
+        if (cy >= rows - PAD) shiftsY[countY++] = -1;
+        for (int j = 0; j < countY; j++) {
+            for (int i = 0; i < countX; i++) {
+                int slot = slotOf(cx + shiftsX[i] * cols, cy + shiftsY[j] * rows);
+                gridX[slot] = x + shiftsX[i] * widthF;
+                gridY[slot] = y + shiftsY[j] * heightF;
+            }
+        }
+
+        active.push_back((int)xsOut.size());
+        xsOut.push_back(x);
+        ysOut.push_back(y);
+    };
+
+    // 坐标绕回到 [0, size)
+    auto wrap = [](float v, float size) {
+        if (v < 0.0f) {
+            v += size;
+        } else if (v >= size) {
+            v -= size;
+        }
+        return (v >= 0.0f && v < size) ? v : 0.0f;
+    };
+
+    xsOut.clear();
+    ysOut.clear();
+    xsOut.reserve((size_t)(widthF * heightF / radius2));
+    ysOut.reserve((size_t)(widthF * heightF / radius2));
+    add(unit(rng) * widthF, unit(rng) * heightF);
+
+    while (!active.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, active.size() - 1);
+        size_t slot = pick(rng);
+        int source = active[slot];
+        bool placed = false;
+
+        // 在紧贴 radius 的圆周上均匀取候选点（Bridson 算法的改进版本，
+        // 比在 [radius, 2 * radius] 环内随机取点更密、失败次数更少）
+        float phase = unit(rng) * 6.28318530718f;
+        float dirX = std::cos(phase) * ringRadius;
+        float dirY = std::sin(phase) * ringRadius;
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+            float x = wrap(xsOut[source] + dirX, widthF);
+            float y = wrap(ysOut[source] + dirY, heightF);
+            if (fits(x, y)) {
+                add(x, y);
+                placed = true;
+                break;
+            }
+
+            // 旋转到下一个候选方向
+            float rotated = dirX * stepCos - dirY * stepSin;
+            dirY = dirX * stepSin + dirY * stepCos;
+            dirX = rotated;
+        }
+
+        if (!placed) {
+            active[slot] = active.back();
+            active.pop_back();
+        }
+    }
+}
+
+} // namespace
+
+bool NoiseGenerator::isSimdAvailable() {
+#ifdef SHADERTOY_NOISE_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+void NoiseGenerator::setSimdEnabled(bool enabled) {
+    g_simdEnabled.store(enabled, std::memory_order_relaxed);
+}
+
 // 生成随机排列表
 std::vector<int> NoiseGenerator::generatePermutationTable(unsigned int seed) {
     std::vector<int> perm(512);
@@ -77,31 +566,15 @@ float NoiseGenerator::perlinNoise2D(float x, float y, const std::vector<int>& pe
 
 // 生成Perlin噪声纹理
 std::vector<float> NoiseGenerator::generatePerlin2D(int width, int height, int octaves, float persistence, float scale) {
-    std::vector<float> result(width * height);
     auto perm = generatePermutationTable(42);
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float nx = (float)x / width * scale;
-            float ny = (float)y / height * scale;
-            
-            float amplitude = 1.0f;
-            float frequency = 1.0f;
-            float noiseValue = 0.0f;
-            float maxValue = 0.0f;
-            
-            for (int o = 0; o < octaves; o++) {
-                noiseValue += perlinNoise2D(nx * frequency, ny * frequency, perm) * amplitude;
-                maxValue += amplitude;
-                amplitude *= persistence;
-                frequency *= 2.0f;
-            }
-            
-            result[y * width + x] = noiseValue / maxValue;
-        }
-    }
-    
-    return result;
+
+    return generateFractal(width, height, scale, octaves, persistence, 2.0f,
+#ifdef SHADERTOY_NOISE_SSE2
+        [&](__m128 x, __m128 y) { return perlinNoise2D4(x, y, perm.data()); },
+#else
+        nullptr,
+#endif
+        [&](float x, float y) { return perlinNoise2D(x, y, perm); });
 }
 
 // Simplex噪声核心 (简化版)
@@ -162,69 +635,47 @@ float NoiseGenerator::simplexNoise2D(float x, float y, const std::vector<int>& p
 
 // 生成Simplex噪声纹理
 std::vector<float> NoiseGenerator::generateSimplex2D(int width, int height, int octaves, float persistence, float scale) {
-    std::vector<float> result(width * height);
     auto perm = generatePermutationTable(42);
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float nx = (float)x / width * scale;
-            float ny = (float)y / height * scale;
-            
-            float amplitude = 1.0f;
-            float frequency = 1.0f;
-            float noiseValue = 0.0f;
-            float maxValue = 0.0f;
-            
-            for (int o = 0; o < octaves; o++) {
-                noiseValue += simplexNoise2D(nx * frequency, ny * frequency, perm) * amplitude;
-                maxValue += amplitude;
-                amplitude *= persistence;
-                frequency *= 2.0f;
-            }
-            
-            result[y * width + x] = noiseValue / maxValue;
-        }
-    }
-    
-    return result;
+
+    return generateFractal(width, height, scale, octaves, persistence, 2.0f,
+#ifdef SHADERTOY_NOISE_SSE2
+        [&](__m128 x, __m128 y) { return simplexNoise2D4(x, y, perm.data()); },
+#else
+        nullptr,
+#endif
+        [&](float x, float y) { return simplexNoise2D(x, y, perm); });
 }
 
 // 生成Worley噪声 (细胞噪声)
 std::vector<float> NoiseGenerator::generateWorley2D(int width, int height, int numPoints) {
     std::vector<float> result(width * height);
-    std::vector<std::pair<float, float>> points(numPoints);
-    
+    std::vector<float> pointsX(numPoints), pointsY(numPoints);
+
     // 生成随机点
     std::mt19937 rng(42);
     std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    
+
     for (int i = 0; i < numPoints; i++) {
-        points[i] = {dist(rng) * width, dist(rng) * height};
+        pointsX[i] = dist(rng) * width;
+        pointsY[i] = dist(rng) * height;
     }
-    
-    // 计算每个像素到最近点的距离
-    for (int y = 0; y < height; y++) {
+
+    // 平均每个单元格约一个点
+    float cellSize = std::sqrt((float)(width * height) / std::max(numPoints, 1));
+    TiledPointGrid grid(width, height, cellSize, pointsX, pointsY);
+
+    // 归一化距离
+    const float maxPossibleDist = std::sqrt((float)(width * width + height * height)) / std::sqrt((float)numPoints);
+
+    // 计算每个像素到最近点（含平铺副本）的距离
+    forEachRow(height, [&](int y) {
         for (int x = 0; x < width; x++) {
-            float minDist = std::numeric_limits<float>::max();
-            
-            for (const auto& p : points) {
-                // 考虑平铺边界
-                for (int dy = -1; dy <= 1; dy++) {
-                    for (int dx = -1; dx <= 1; dx++) {
-                        float px = p.first + dx * width;
-                        float py = p.second + dy * height;
-                        float dist = std::sqrt((x - px) * (x - px) + (y - py) * (y - py));
-                        minDist = std::min(minDist, dist);
-                    }
-                }
-            }
-            
-            // 归一化距离
-            float maxPossibleDist = std::sqrt((float)(width * width + height * height)) / std::sqrt((float)numPoints);
+            float minDist2 = grid.nearestDist2((float)x, (float)y);
+            float minDist = minDist2 < std::numeric_limits<float>::max() ? std::sqrt(minDist2) : minDist2;
             result[y * width + x] = std::min(minDist / maxPossibleDist, 1.0f);
         }
-    }
-    
+    });
+
     return result;
 }
 
@@ -241,135 +692,82 @@ std::vector<uint8_t> NoiseGenerator::generateWhiteNoise(int width, int height, i
     return result;
 }
 
-// 生成蓝噪声 (简化版 - 使用Mitchell的最佳候选算法)
+// 生成蓝噪声 (平铺的 Poisson 盘采样点的距离场)
 std::vector<uint8_t> NoiseGenerator::generateBlueNoise(int width, int height) {
     std::vector<uint8_t> result(width * height);
-    std::vector<std::pair<int, int>> samples;
-    std::mt19937 rng(42);
-    std::uniform_int_distribution<int> distX(0, width - 1);
-    std::uniform_int_distribution<int> distY(0, height - 1);
-    
-    int numSamples = width * height / 4;
-    
-    // 生成蓝噪声采样点
-    for (int i = 0; i < numSamples; i++) {
-        float bestDist = -1;
-        int bestX = 0, bestY = 0;
-        
-        // 生成多个候选点，选择离现有点最远的
-        int numCandidates = std::min(10, (int)samples.size() + 1);
-        for (int c = 0; c < numCandidates; c++) {
-            int cx = distX(rng);
-            int cy = distY(rng);
-            
-            float minDist = std::numeric_limits<float>::max();
-            for (const auto& s : samples) {
-                float dx = (float)(cx - s.first);
-                float dy = (float)(cy - s.second);
-                // 考虑平铺
-                dx = std::min(std::abs(dx), (float)width - std::abs(dx));
-                dy = std::min(std::abs(dy), (float)height - std::abs(dy));
-                float dist = dx * dx + dy * dy;
-                minDist = std::min(minDist, dist);
-            }
-            
-            if (samples.empty() || minDist > bestDist) {
-                bestDist = minDist;
-                bestX = cx;
-                bestY = cy;
-            }
-        }
-        
-        samples.push_back({bestX, bestY});
+    if (width <= 0 || height <= 0) {
+        return result;
     }
-    
-    // 将采样点转换为纹理
-    for (int y = 0; y < height; y++) {
+
+    // 生成蓝噪声采样点
+    std::vector<float> samplesX, samplesY;
+    generatePoissonDisk(width, height, BLUE_NOISE_RADIUS, 42, samplesX, samplesY);
+    TiledPointGrid grid(width, height, BLUE_NOISE_RADIUS, samplesX, samplesY);
+
+    // 将采样点转换为纹理：到最近采样点的距离，按平均间距归一化
+    const int numSamples = (int)samplesX.size();
+    const float maxDist = std::sqrt((float)(width * height) / numSamples) * 0.8f;
+
+    forEachRow(height, [&](int y) {
         for (int x = 0; x < width; x++) {
-            float minDist = std::numeric_limits<float>::max();
-            for (const auto& s : samples) {
-                float dx = std::abs((float)(x - s.first));
-                float dy = std::abs((float)(y - s.second));
-                dx = std::min(dx, (float)width - dx);
-                dy = std::min(dy, (float)height - dy);
-                float dist = std::sqrt(dx * dx + dy * dy);
-                minDist = std::min(minDist, dist);
-            }
-            
-            float maxDist = std::sqrt((float)(width * height) / numSamples) * 0.8f;
+            float minDist = std::sqrt(grid.nearestDist2((float)x, (float)y));
             result[y * width + x] = static_cast<uint8_t>(std::min(minDist / maxDist * 255.0f, 255.0f));
         }
-    }
-    
+    });
+
     return result;
 }
 
 // 生成有机噪声 (多层Perlin叠加 + 颜色变换)
 std::vector<uint8_t> NoiseGenerator::generateOrganic(int width, int height) {
     std::vector<uint8_t> result(width * height * 4);
-    
-    // 生成多层噪声
+
+    // 生成多层噪声（各自内部按行并行）
     auto noise1 = generatePerlin2D(width, height, 4, 0.5f, 4.0f);
     auto noise2 = generatePerlin2D(width, height, 6, 0.4f, 8.0f);
     auto noise3 = generateWorley2D(width, height, 16);
-    
-    for (int y = 0; y < height; y++) {
+
+    forEachRow(height, [&](int y) {
         for (int x = 0; x < width; x++) {
             int idx = y * width + x;
-            
+
             float n1 = noise1[idx];
             float n2 = noise2[idx];
             float n3 = noise3[idx];
-            
+
             // 混合噪声创建有机外观
             float r = n1 * 0.7f + n2 * 0.2f + n3 * 0.1f;
             float g = n1 * 0.5f + n2 * 0.4f + n3 * 0.1f;
             float b = n1 * 0.3f + n2 * 0.3f + n3 * 0.4f;
             float a = 1.0f;
-            
+
             // 添加一些颜色偏移
             r = std::pow(r, 0.8f);
             g = std::pow(g, 1.0f);
             b = std::pow(b, 1.2f);
-            
+
             int outIdx = idx * 4;
             result[outIdx + 0] = static_cast<uint8_t>(std::min(r * 255.0f, 255.0f));
             result[outIdx + 1] = static_cast<uint8_t>(std::min(g * 255.0f, 255.0f));
             result[outIdx + 2] = static_cast<uint8_t>(std::min(b * 255.0f, 255.0f));
             result[outIdx + 3] = static_cast<uint8_t>(a * 255.0f);
         }
-    }
-    
+    });
+
     return result;
 }
 
 // 生成FBM噪声
 std::vector<float> NoiseGenerator::generateFBM2D(int width, int height, int octaves, float lacunarity, float gain) {
-    std::vector<float> result(width * height);
     auto perm = generatePermutationTable(42);
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float nx = (float)x / width * 4.0f;
-            float ny = (float)y / height * 4.0f;
-            
-            float amplitude = 1.0f;
-            float frequency = 1.0f;
-            float noiseValue = 0.0f;
-            float maxValue = 0.0f;
-            
-            for (int o = 0; o < octaves; o++) {
-                noiseValue += perlinNoise2D(nx * frequency, ny * frequency, perm) * amplitude;
-                maxValue += amplitude;
-                amplitude *= gain;
-                frequency *= lacunarity;
-            }
-            
-            result[y * width + x] = noiseValue / maxValue;
-        }
-    }
-    
-    return result;
+
+    return generateFractal(width, height, 4.0f, octaves, gain, lacunarity,
+#ifdef SHADERTOY_NOISE_SSE2
+        [&](__m128 x, __m128 y) { return perlinNoise2D4(x, y, perm.data()); },
+#else
+        nullptr,
+#endif
+        [&](float x, float y) { return perlinNoise2D(x, y, perm); });
 }
 
 } // namespace shadertoy
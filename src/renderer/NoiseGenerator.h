@@ -7,21 +7,26 @@
 namespace shadertoy {
 
 // 噪声生成器 - 用于生成各种程序化噪声纹理
+// 各生成函数按行分块在 ThreadPool 上并行，Perlin / Simplex 有 SSE2 的 4 路实现（无 SSE2 时退回标量）
+// Worley 和蓝噪声的最近点查询使用平铺的均匀网格
 class NoiseGenerator {
 public:
+    // 生成算法版本，任何生成结果变化时递增（参与内置纹理包的缓存键）
+    static constexpr int VERSION = 2;
+    
     // Perlin噪声
     static std::vector<float> generatePerlin2D(int width, int height, int octaves = 4, float persistence = 0.5f, float scale = 4.0f);
     
     // Simplex噪声
     static std::vector<float> generateSimplex2D(int width, int height, int octaves = 4, float persistence = 0.5f, float scale = 4.0f);
     
-    // Worley噪声 (细胞噪声)
+    // Worley噪声 (细胞噪声)，可平铺
     static std::vector<float> generateWorley2D(int width, int height, int numPoints = 32);
     
     // 白噪声
     static std::vector<uint8_t> generateWhiteNoise(int width, int height, int channels, unsigned int seed = 0);
     
-    // 蓝噪声 (抖动图案)
+    // 蓝噪声 (抖动图案)：可平铺的 Poisson 盘采样点的距离场，O(n)，1024x1024 也能快速生成
     static std::vector<uint8_t> generateBlueNoise(int width, int height);
     
     // 有机噪声 (类似Shadertoy的Organic纹理 - 基于多层叠加)
@@ -30,6 +35,10 @@ public:
     // FBM (分形布朗运动)
     static std::vector<float> generateFBM2D(int width, int height, int octaves = 6, float lacunarity = 2.0f, float gain = 0.5f);
     
+    // 是否编译了 SSE2 路径；setSimdEnabled(false) 强制走标量路径（供 noise-bench 对比结果和耗时）
+    static bool isSimdAvailable();
+    static void setSimdEnabled(bool enabled);
+    
 private:
     // Perlin噪声核心函数
     static float perlinNoise2D(float x, float y, const std::vector<int>& perm);
@@ -0,0 +1,259 @@
+/**
+ * PassProfiler 实现
+ */
+
+#include "PassProfiler.h"
+#include "RenderGraph.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace shadertoy {
+
+namespace {
+
+const double AVERAGE_WEIGHT = 0.1;       // 指数平均中新样本的权重
+const double ACTIVE_WINDOW_US = 1.0e6;   // 1 秒内提交过的 Pass 计入总 GPU 时间
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+PassProfiler::PassProfiler() {
+    m_epochNs = steadyNowNs();
+    reset();
+}
+
+double PassProfiler::nowUs() const {
+    return static_cast<double>(steadyNowNs() - m_epochNs) / 1000.0;
+}
+
+void PassProfiler::setEnabled(bool enabled) {
+    if (m_enabled == enabled) {
+        return;
+    }
+    m_enabled = enabled;
+    if (!enabled) {
+        cleanup();
+    }
+    std::cout << "PassProfiler: " << (enabled ? "Enabled" : "Disabled") << std::endl;
+}
+
+void PassProfiler::cleanup() {
+    for (auto& timer : m_gpuTimers) {
+        timer.cleanup();
+    }
+    m_activeSlot = -1;
+}
+
+void PassProfiler::reset() {
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        m_timings[i] = PassTiming();
+    }
+    m_timings[0].type = ShaderPassType::BufferA;
+    m_timings[1].type = ShaderPassType::BufferB;
+    m_timings[2].type = ShaderPassType::BufferC;
+    m_timings[3].type = ShaderPassType::BufferD;
+    m_timings[4].type = ShaderPassType::Image;
+    m_lastFrameCpuMs = 0.0;
+    m_gpuCursorUs = 0.0;
+    m_events.clear();
+}
+
+bool PassProfiler::beginFrame() {
+    if (!m_enabled) {
+        return false;
+    }
+    m_frameStartUs = nowUs();
+    return collect();
+}
+
+bool PassProfiler::collect() {
+    if (!m_enabled) {
+        return false;
+    }
+
+    // 取回所有已完成的查询，按提交时间排序后放到 GPU 轨道上
+    std::vector<GpuResult> results;
+    for (int slot = 0; slot < MAX_SLOTS; slot++) {
+        double ms = 0.0;
+        int64_t submitUs = 0;
+        while (m_gpuTimers[slot].pollNext(ms, submitUs)) {
+            results.push_back({slot, ms, static_cast<double>(submitUs)});
+        }
+    }
+    if (results.empty()) {
+        return false;
+    }
+
+    std::sort(results.begin(), results.end(),
+        [](const GpuResult& a, const GpuResult& b) { return a.submitUs < b.submitUs; });
+
+    for (const auto& result : results) {
+        PassTiming& timing = m_timings[result.slot];
+        timing.gpuAvgMs = timing.gpuAvgMs > 0.0
+            ? timing.gpuAvgMs + (result.ms - timing.gpuAvgMs) * AVERAGE_WEIGHT
+            : result.ms;
+        timing.gpuMs = result.ms;
+        timing.gpuTotalMs += result.ms;
+        timing.gpuSamples++;
+
+        // GPU 不会早于提交开始执行，也不会与上一个 Pass 重叠
+        double startUs = std::max(result.submitUs, m_gpuCursorUs);
+        double durationUs = result.ms * 1000.0;
+        const char* name = result.slot == UPSCALE_SLOT ? "Upscale" : PassConfig::getTypeName(timing.type);
+        addEvent(name, GpuThread, startUs, durationUs);
+        m_gpuCursorUs = startUs + durationUs;
+    }
+    return true;
+}
+
+void PassProfiler::endFrame() {
+    if (!m_enabled) {
+        return;
+    }
+    double endUs = nowUs();
+    m_lastFrameCpuMs = (endUs - m_frameStartUs) / 1000.0;
+    addEvent("Frame", CpuThread, m_frameStartUs, endUs - m_frameStartUs);
+}
+
+void PassProfiler::beginPass(ShaderPassType type) {
+    int slot = RenderGraph::canonicalIndex(type);
+    if (slot >= 0) {
+        beginSlot(slot);
+    }
+}
+
+void PassProfiler::beginUpscale() {
+    beginSlot(UPSCALE_SLOT);
+}
+
+void PassProfiler::beginSlot(int slot) {
+    if (!m_enabled || m_activeSlot >= 0) {
+        return;
+    }
+
+    double submitUs = nowUs();
+    m_timings[slot].lastSubmitUs = submitUs;
+    m_gpuTimers[slot].begin(static_cast<int64_t>(submitUs));
+    m_activeSlot = slot;
+}
+
+void PassProfiler::endPass() {
+    if (m_activeSlot < 0) {
+        return;
+    }
+    m_gpuTimers[m_activeSlot].end();
+    m_activeSlot = -1;
+}
+
+void PassProfiler::recordUniformUpload(ShaderPassType type, double startUs, double durationUs) {
+    int slot = RenderGraph::canonicalIndex(type);
+    if (!m_enabled || slot < 0) {
+        return;
+    }
+    m_timings[slot].uniformMs = durationUs / 1000.0;
+    addEvent(std::string(PassConfig::getTypeName(type)) + " uniforms", CpuThread, startUs, durationUs);
+}
+
+void PassProfiler::recordCpu(const std::string& name, double startUs, double durationUs) {
+    if (!m_enabled) {
+        return;
+    }
+    addEvent(name, CpuThread, startUs, durationUs);
+}
+
+void PassProfiler::recordCompile(int passCount, double startUs, double submitUs, double totalUs) {
+    m_lastCompileSubmitMs = submitUs / 1000.0;
+    m_lastCompileTotalMs = totalUs / 1000.0;
+    if (!m_enabled) {
+        return;
+    }
+    std::string name = "Compile " + std::to_string(passCount) + (passCount == 1 ? " pass" : " passes");
+    addEvent(name + " (submit)", CompileThread, startUs, submitUs);
+    addEvent(name, CompileThread, startUs, totalUs);
+}
+
+std::vector<PassTiming> PassProfiler::getTimings() const {
+    std::vector<PassTiming> result;
+    for (int slot = 0; slot < MAX_PASSES; slot++) {
+        if (m_timings[slot].lastSubmitUs >= 0.0) {
+            result.push_back(m_timings[slot]);
+        }
+    }
+    return result;
+}
+
+double PassProfiler::getTotalGpuMs() const {
+    double now = nowUs();
+    double total = 0.0;
+    for (const auto& timing : m_timings) {
+        if (timing.lastSubmitUs >= 0.0 && now - timing.lastSubmitUs < ACTIVE_WINDOW_US) {
+            total += timing.gpuMs;
+        }
+    }
+    return total;
+}
+
+void PassProfiler::addEvent(const std::string& name, int thread, double startUs, double durationUs) {
+    TraceEvent event;
+    event.name = name;
+    event.thread = thread;
+    event.startUs = startUs;
+    event.durationUs = durationUs;
+    m_events.push_back(std::move(event));
+
+    while (m_events.size() > MAX_TRACE_EVENTS) {
+        m_events.pop_front();
+    }
+}
+
+bool PassProfiler::writeChromeTrace(const std::string& path, std::string& errorOut) const {
+    nlohmann::json events = nlohmann::json::array();
+
+    // 轨道名称
+    const std::pair<int, const char*> threads[] = {
+        {CpuThread, "CPU"}, {GpuThread, "GPU"}, {CompileThread, "Compile"}
+    };
+    for (const auto& thread : threads) {
+        events.push_back({
+            {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", thread.first},
+            {"args", {{"name", thread.second}}}
+        });
+    }
+
+    for (const auto& event : m_events) {
+        events.push_back({
+            {"name", event.name},
+            {"cat", event.thread == GpuThread ? "gpu" : (event.thread == CompileThread ? "compile" : "cpu")},
+            {"ph", "X"},
+            {"pid", 1},
+            {"tid", event.thread},
+            {"ts", event.startUs},
+            {"dur", event.durationUs}
+        });
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        errorOut = "Cannot open trace file: " + path;
+        return false;
+    }
+
+    nlohmann::json trace = {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+    file << trace.dump();
+    if (!file.good()) {
+        errorOut = "Failed to write trace file: " + path;
+        return false;
+    }
+
+    std::cout << "PassProfiler: Wrote " << m_events.size() << " events to " << path << std::endl;
+    return true;
+}
+
+} // namespace shadertoy
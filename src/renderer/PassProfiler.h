@@ -0,0 +1,162 @@
+/**
+ * PassProfiler - 每个 Pass 的 GPU/CPU 计时
+ *
+ * GPU：每个 Pass 一个 GpuTimer（GL_TIME_ELAPSED 查询环），结果延迟几帧后非阻塞取回
+ * CPU：uniform 上传/纹理绑定、Shader 编译
+ * 所有区间可导出为 Chrome Trace JSON（chrome://tracing 或 Perfetto 打开）
+ *
+ * GL_TIME_ELAPSED 只给出时长，GPU 轨道上的事件按提交时间依次排列，是近似位置
+ */
+
+#pragma once
+
+#include "GpuTimer.h"
+#include "../core/ScreensaverMode.h"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace shadertoy {
+
+/**
+ * 单个 Pass 的计时结果
+ */
+struct PassTiming {
+    ShaderPassType type = ShaderPassType::Image;
+    double gpuMs = 0.0;       // 最近一次取回的 GPU 时间
+    double gpuAvgMs = 0.0;    // GPU 时间的指数平均
+    double uniformMs = 0.0;   // CPU：uniform 上传 + 纹理绑定
+    double gpuTotalMs = 0.0;  // reset() 以来的 GPU 时间总和
+    int gpuSamples = 0;       // reset() 以来取回的结果数
+    double lastSubmitUs = -1.0;  // 最近一次提交的 CPU 时间，-1 表示从未运行
+};
+
+class PassProfiler {
+public:
+    static constexpr int MAX_PASSES = 5;                 // Buffer A-D + Image
+    static constexpr int UPSCALE_SLOT = MAX_PASSES;      // 动态分辨率的放大 blit
+    static constexpr int MAX_SLOTS = MAX_PASSES + 1;
+    static constexpr size_t MAX_TRACE_EVENTS = 50000;    // 约 10000 帧的多 Pass 事件
+
+    PassProfiler();
+
+    // 禁止拷贝（持有 GL 查询对象）
+    PassProfiler(const PassProfiler&) = delete;
+    PassProfiler& operator=(const PassProfiler&) = delete;
+
+    /**
+     * 开启/关闭计时（关闭时释放查询对象，未取回的结果丢弃）
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * 释放 GL 资源（需要 GL 上下文）
+     */
+    void cleanup();
+
+    /**
+     * 清空统计和 Trace 事件
+     */
+    void reset();
+
+    /**
+     * 帧开始：取回之前帧的 GPU 结果
+     * @return 是否有新的 GPU 结果
+     */
+    bool beginFrame();
+    void endFrame();
+
+    /**
+     * 取回已完成的 GPU 结果（beginFrame 会自动调用；渲染结束后可再调用一次取回最后几帧）
+     * @return 是否有新的 GPU 结果
+     */
+    bool collect();
+
+    /**
+     * Pass 的 GPU 计时区间（不能嵌套）
+     */
+    void beginPass(ShaderPassType type);
+    void endPass();
+
+    /**
+     * 动态分辨率放大 blit 的 GPU 计时区间（同样用 endPass() 结束）
+     * 计入总 GPU 时间和 Trace，不出现在 getTimings() 中
+     */
+    void beginUpscale();
+
+    /**
+     * 记录 CPU 区间（时间由 nowUs() 获得）
+     */
+    void recordUniformUpload(ShaderPassType type, double startUs, double durationUs);
+    void recordCpu(const std::string& name, double startUs, double durationUs);
+
+    /**
+     * 记录一次编译：提交耗时和从提交到可用的总耗时（关闭计时时也会更新统计）
+     */
+    void recordCompile(int passCount, double startUs, double submitUs, double totalUs);
+
+    /**
+     * 有计时结果的 Pass（按 Buffer A-D、Image 顺序）
+     */
+    std::vector<PassTiming> getTimings() const;
+
+    /**
+     * 最近运行的所有 Pass 的 GPU 时间之和（毫秒）
+     */
+    double getTotalGpuMs() const;
+
+    double getLastFrameCpuMs() const { return m_lastFrameCpuMs; }
+    double getLastCompileSubmitMs() const { return m_lastCompileSubmitMs; }
+    double getLastCompileTotalMs() const { return m_lastCompileTotalMs; }
+    size_t getTraceEventCount() const { return m_events.size(); }
+
+    /**
+     * 导出 Chrome Trace JSON
+     */
+    bool writeChromeTrace(const std::string& path, std::string& errorOut) const;
+
+    /**
+     * 当前时间（微秒，单调时钟，以 Profiler 创建时为起点）
+     */
+    double nowUs() const;
+
+private:
+    enum TraceThread { CpuThread = 1, GpuThread = 2, CompileThread = 3 };
+
+    struct TraceEvent {
+        std::string name;
+        int thread = CpuThread;
+        double startUs = 0.0;
+        double durationUs = 0.0;
+    };
+
+    struct GpuResult {
+        int slot = 0;
+        double ms = 0.0;
+        double submitUs = 0.0;
+    };
+
+    void beginSlot(int slot);
+    void addEvent(const std::string& name, int thread, double startUs, double durationUs);
+
+    bool m_enabled = false;
+    int64_t m_epochNs = 0;
+
+    std::array<GpuTimer, MAX_SLOTS> m_gpuTimers;
+    std::array<PassTiming, MAX_SLOTS> m_timings;
+    int m_activeSlot = -1;
+
+    double m_frameStartUs = 0.0;
+    double m_lastFrameCpuMs = 0.0;
+    double m_gpuCursorUs = 0.0;  // GPU 轨道上最后一个事件的结束时间
+
+    double m_lastCompileSubmitMs = 0.0;
+    double m_lastCompileTotalMs = 0.0;
+
+    std::deque<TraceEvent> m_events;
+};
+
+} // namespace shadertoy
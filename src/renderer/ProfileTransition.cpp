@@ -0,0 +1,200 @@
+#include "ProfileTransition.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace shadertoy {
+
+namespace {
+
+// 所有过渡 shader 共用的声明（fragCoord 为 [0,1] 纹理坐标，来自默认顶点着色器）
+const char* const TRANSITION_HEADER = R"(
+#version 430 core
+
+in vec2 fragCoord;
+out vec4 fragColor;
+
+uniform sampler2D uFrom;
+uniform sampler2D uTo;
+uniform float uProgress;
+uniform vec2 uResolution;
+)";
+
+const char* const TRANSITION_FADE = R"(
+void main() {
+    fragColor = mix(texture(uFrom, fragCoord), texture(uTo, fragCoord), uProgress);
+}
+)";
+
+const char* const TRANSITION_WIPE = R"(
+void main() {
+    const float edge = 0.05;
+    float t = smoothstep(-edge, edge, uProgress * (1.0 + 2.0 * edge) - edge - fragCoord.x);
+    fragColor = mix(texture(uFrom, fragCoord), texture(uTo, fragCoord), t);
+}
+)";
+
+const char* const TRANSITION_DISSOLVE = R"(
+float hash(vec2 p) {
+    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
+}
+
+void main() {
+    float n = hash(floor(fragCoord * uResolution / 8.0));
+    float t = smoothstep(n - 0.1, n + 0.1, uProgress * 1.2 - 0.1);
+    fragColor = mix(texture(uFrom, fragCoord), texture(uTo, fragCoord), t);
+}
+)";
+
+const char* const TRANSITION_CIRCLE = R"(
+void main() {
+    float aspect = uResolution.x / max(uResolution.y, 1.0);
+    float d = length((fragCoord - 0.5) * vec2(aspect, 1.0));
+    float radius = uProgress * (length(vec2(aspect, 1.0)) * 0.5 + 0.05);
+    float t = 1.0 - smoothstep(radius - 0.05, radius, d);
+    fragColor = mix(texture(uFrom, fragCoord), texture(uTo, fragCoord), t);
+}
+)";
+
+const char* getTransitionBody(TransitionType type) {
+    switch (type) {
+        case TransitionType::Wipe: return TRANSITION_WIPE;
+        case TransitionType::Dissolve: return TRANSITION_DISSOLVE;
+        case TransitionType::Circle: return TRANSITION_CIRCLE;
+        case TransitionType::Fade:
+        default: return TRANSITION_FADE;
+    }
+}
+
+} // namespace
+
+bool ProfileTransition::prepare(TransitionType type, int width, int height) {
+    if (!m_from) {
+        m_from = std::make_unique<Framebuffer>();
+        m_to = std::make_unique<Framebuffer>();
+        if (!m_from->create(width, height, GL_RGBA8) || !m_to->create(width, height, GL_RGBA8)) {
+            std::cerr << "ProfileTransition: Failed to create framebuffers" << std::endl;
+            m_from.reset();
+            m_to.reset();
+            return false;
+        }
+    } else {
+        resize(width, height);
+    }
+
+    return compileShader(type);
+}
+
+void ProfileTransition::cleanup() {
+    m_from.reset();
+    m_to.reset();
+    for (auto& program : m_programs) {
+        program = TransitionProgram{};
+    }
+    m_active = false;
+}
+
+bool ProfileTransition::begin(const TransitionSettings& settings, int width, int height,
+                              float fromTime, int fromFrame, float fromTimeScale) {
+    m_active = false;
+    if (settings.duration <= 0.0f || !prepare(settings.type, width, height)) {
+        return false;
+    }
+
+    m_settings = settings;
+    m_active = true;
+    m_elapsed = 0.0f;
+    m_frames = 0;
+    m_fromTime = fromTime;
+    m_fromFrame = fromFrame;
+    m_fromTimeScale = fromTimeScale;
+    return true;
+}
+
+bool ProfileTransition::update(float deltaTime) {
+    if (!m_active) {
+        return false;
+    }
+
+    m_elapsed += deltaTime;
+    if (m_elapsed >= m_settings.duration) {
+        m_active = false;
+        return true;
+    }
+    return false;
+}
+
+float ProfileTransition::getProgress() const {
+    if (m_settings.duration <= 0.0f) {
+        return 1.0f;
+    }
+    return std::min(1.0f, std::max(0.0f, m_elapsed / m_settings.duration));
+}
+
+void ProfileTransition::resize(int width, int height) {
+    if (m_from && (m_from->getWidth() != width || m_from->getHeight() != height)) {
+        m_from->resize(width, height);
+        m_to->resize(width, height);
+    }
+}
+
+void ProfileTransition::composite(Renderer& renderer, GLuint outputFbo) {
+    const TransitionProgram& program = m_programs[static_cast<size_t>(m_settings.type)];
+    ShaderEngine* shader = program.shader.get();
+    if (!shader || !shader->isValid() || !m_from) {
+        return;
+    }
+
+    // 缓入缓出，起止处没有突变
+    float progress = getProgress();
+    progress = progress * progress * (3.0f - 2.0f * progress);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+    glViewport(0, 0, m_from->getWidth(), m_from->getHeight());
+
+    shader->use();
+    glUniform1f(program.progress, progress);
+    glUniform2f(program.resolution,
+                static_cast<float>(m_from->getWidth()), static_cast<float>(m_from->getHeight()));
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_from->getTexture());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, m_to->getTexture());
+
+    renderer.renderFullscreenQuad();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_frames++;
+}
+
+bool ProfileTransition::compileShader(TransitionType type) {
+    TransitionProgram& program = m_programs[static_cast<size_t>(type)];
+    auto& shader = program.shader;
+    if (shader && shader->isValid()) {
+        return true;
+    }
+
+    shader = std::make_unique<ShaderEngine>();
+    std::string source = std::string(TRANSITION_HEADER) + getTransitionBody(type);
+    std::string error;
+    if (!shader->compileShader(source, error)) {
+        std::cerr << "ProfileTransition: Failed to compile " << TransitionSettings::typeToString(type)
+                  << " transition: " << error << std::endl;
+        program = TransitionProgram{};
+        return false;
+    }
+
+    GLuint handle = shader->getProgram();
+    glProgramUniform1i(handle, glGetUniformLocation(handle, "uFrom"), 0);
+    glProgramUniform1i(handle, glGetUniformLocation(handle, "uTo"), 1);
+    program.progress = glGetUniformLocation(handle, "uProgress");
+    program.resolution = glGetUniformLocation(handle, "uResolution");
+    return true;
+}
+
+} // namespace shadertoy
@@ -0,0 +1,108 @@
+/**
+ * ProfileTransition - 屏保 Profile 切换时的过渡
+ *
+ * 过渡期间旧 Profile 和新 Profile 分别渲染到两个 FBO，再用内置的过渡 shader 混合输出；
+ * 旧 Profile 的时钟继续走，画面不会冻结，新 Profile 在此期间完成 Buffer 的预热
+ * 过渡结束后不再有任何额外渲染
+ */
+
+#pragma once
+
+#include "Framebuffer.h"
+#include "Renderer.h"
+#include "../core/ScreensaverMode.h"
+#include "../core/ShaderEngine.h"
+
+#include <array>
+#include <memory>
+
+namespace shadertoy {
+
+class ProfileTransition {
+public:
+    ProfileTransition() = default;
+    ~ProfileTransition() = default;
+
+    // 禁止拷贝（持有 GL 对象）
+    ProfileTransition(const ProfileTransition&) = delete;
+    ProfileTransition& operator=(const ProfileTransition&) = delete;
+
+    /**
+     * 提前创建 FBO 并编译过渡 shader，避免第一次切换时的开销
+     */
+    bool prepare(TransitionType type, int width, int height);
+
+    /**
+     * 释放 FBO 和过渡 shader
+     */
+    void cleanup();
+
+    /**
+     * 开始过渡（未 prepare 时在这里创建 FBO 和 shader）
+     * @param fromTime 旧 Profile 当前的 iTime
+     * @param fromFrame 旧 Profile 当前的 iFrame
+     * @param fromTimeScale 旧 Profile 的时间缩放
+     * @return 过渡时长为 0 或资源创建失败时返回 false（直接切换）
+     */
+    bool begin(const TransitionSettings& settings, int width, int height,
+               float fromTime, int fromFrame, float fromTimeScale);
+
+    /**
+     * 推进过渡时间
+     * @return 本次调用中过渡结束时返回 true
+     */
+    bool update(float deltaTime);
+
+    bool isActive() const { return m_active; }
+
+    /**
+     * 过渡进度 [0, 1]
+     */
+    float getProgress() const;
+
+    /**
+     * 旧 Profile 的时钟（继续走）
+     */
+    float getFromTime() const { return m_fromTime + m_elapsed * m_fromTimeScale; }
+    int getFromFrame() const { return m_fromFrame + m_frames; }
+
+    /**
+     * 两个 Profile 的输出目标
+     */
+    GLuint getFromFramebuffer() const { return m_from ? m_from->getFBO() : 0; }
+    GLuint getToFramebuffer() const { return m_to ? m_to->getFBO() : 0; }
+
+    /**
+     * 调整 FBO 尺寸（过渡期间窗口尺寸变化时）
+     */
+    void resize(int width, int height);
+
+    /**
+     * 把两个 FBO 按当前进度混合输出到 outputFbo，并计入一帧
+     */
+    void composite(Renderer& renderer, GLuint outputFbo = 0);
+
+private:
+    // 过渡 shader 及其 uniform 位置（链接后查询一次，采样器单元同时固定）
+    struct TransitionProgram {
+        std::unique_ptr<ShaderEngine> shader;
+        GLint progress = -1;
+        GLint resolution = -1;
+    };
+
+    bool compileShader(TransitionType type);
+
+    std::unique_ptr<Framebuffer> m_from;
+    std::unique_ptr<Framebuffer> m_to;
+    std::array<TransitionProgram, static_cast<size_t>(TransitionType::Count)> m_programs;
+
+    TransitionSettings m_settings;
+    bool m_active = false;
+    float m_elapsed = 0.0f;
+    int m_frames = 0;
+    float m_fromTime = 0.0f;
+    int m_fromFrame = 0;
+    float m_fromTimeScale = 1.0f;
+};
+
+} // namespace shadertoy
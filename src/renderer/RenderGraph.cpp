@@ -0,0 +1,180 @@
+/**
+ * RenderGraph 实现
+ */
+
+#include "RenderGraph.h"
+#include "BufferManager.h"
+#include <algorithm>
+#include <sstream>
+
+namespace shadertoy {
+
+int RenderGraph::canonicalIndex(ShaderPassType type) {
+    switch (type) {
+        case ShaderPassType::BufferA: return 0;
+        case ShaderPassType::BufferB: return 1;
+        case ShaderPassType::BufferC: return 2;
+        case ShaderPassType::BufferD: return 3;
+        case ShaderPassType::Image: return 4;
+        default: return -1;
+    }
+}
+
+void RenderGraph::clear() {
+    m_nodes.clear();
+    m_schedule.clear();
+}
+
+int RenderGraph::findNode(ShaderPassType type) const {
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        if (m_nodes[i].type == type) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const RenderGraphNode* RenderGraph::getNode(ShaderPassType type) const {
+    int idx = findNode(type);
+    return idx >= 0 ? &m_nodes[static_cast<size_t>(idx)] : nullptr;
+}
+
+bool RenderGraph::isBufferLive(int bufferIndex) const {
+    const RenderGraphNode* node = getNode(BufferManager::indexToType(bufferIndex));
+    return node && node->bufferIndex >= 0 && node->live;
+}
+
+bool RenderGraph::needsPingPong(int bufferIndex) const {
+    const RenderGraphNode* node = getNode(BufferManager::indexToType(bufferIndex));
+    return node && node->bufferIndex >= 0 && node->selfRead;
+}
+
+void RenderGraph::build(const std::vector<PassInput>& passes, const std::vector<ShaderPassType>& roots) {
+    clear();
+
+    // 1. 创建节点（Common 等不可渲染的类型忽略）
+    for (const auto& pass : passes) {
+        if (canonicalIndex(pass.type) < 0 || findNode(pass.type) >= 0) {
+            continue;
+        }
+        RenderGraphNode node;
+        node.type = pass.type;
+        node.bufferIndex = BufferManager::typeToIndex(pass.type);
+        node.channels = pass.channels;
+        m_nodes.push_back(node);
+    }
+    std::sort(m_nodes.begin(), m_nodes.end(), [](const RenderGraphNode& a, const RenderGraphNode& b) {
+        return canonicalIndex(a.type) < canonicalIndex(b.type);
+    });
+
+    const size_t count = m_nodes.size();
+
+    // 2. 建立边：before[i] 中的节点必须排在 i 之前
+    //    reads[i] 为 i 读取的节点（用于活跃性分析）
+    std::vector<std::vector<size_t>> before(count);
+    std::vector<std::vector<size_t>> reads(count);
+    for (size_t reader = 0; reader < count; reader++) {
+        RenderGraphNode& readerNode = m_nodes[reader];
+        for (int binding : readerNode.channels) {
+            if (!ChannelBind::isBuffer(binding)) continue;
+
+            int srcIdx = findNode(BufferManager::indexToType(ChannelBind::bufferIndex(binding)));
+            if (srcIdx < 0) continue;  // 读取未启用的 Buffer，得到黑色纹理
+            size_t src = static_cast<size_t>(srcIdx);
+
+            if (std::find(reads[reader].begin(), reads[reader].end(), src) != reads[reader].end()) {
+                continue;  // 多个通道绑定同一 Buffer
+            }
+            reads[reader].push_back(src);
+
+            RenderGraphNode& srcNode = m_nodes[src];
+            if (src == reader) {
+                readerNode.selfRead = true;
+            } else if (canonicalIndex(srcNode.type) < canonicalIndex(readerNode.type)) {
+                srcNode.sameFrameReaders.push_back(readerNode.type);
+                before[reader].push_back(src);
+            } else {
+                srcNode.previousFrameReaders.push_back(readerNode.type);
+                before[src].push_back(reader);
+            }
+        }
+    }
+
+    // 3. 活跃性：从根节点沿读取关系反向传播
+    std::vector<size_t> stack;
+    for (ShaderPassType root : roots) {
+        int idx = findNode(root);
+        if (idx >= 0 && !m_nodes[static_cast<size_t>(idx)].live) {
+            m_nodes[static_cast<size_t>(idx)].live = true;
+            stack.push_back(static_cast<size_t>(idx));
+        }
+    }
+    while (!stack.empty()) {
+        size_t node = stack.back();
+        stack.pop_back();
+        for (size_t src : reads[node]) {
+            if (!m_nodes[src].live) {
+                m_nodes[src].live = true;
+                stack.push_back(src);
+            }
+        }
+    }
+
+    // 4. 拓扑排序（Kahn），就绪节点中优先选择 Shadertoy 顺序靠前的
+    std::vector<int> inDegree(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        inDegree[i] = static_cast<int>(before[i].size());
+    }
+    std::vector<bool> scheduled(count, false);
+    for (size_t step = 0; step < count; step++) {
+        size_t next = count;
+        for (size_t i = 0; i < count; i++) {
+            if (!scheduled[i] && inDegree[i] == 0) {
+                next = i;
+                break;
+            }
+        }
+        if (next == count) {
+            // 按上面的分类规则不会成环；防御性地按 Shadertoy 顺序补齐
+            for (size_t i = 0; i < count; i++) {
+                if (!scheduled[i]) {
+                    next = i;
+                    break;
+                }
+            }
+        }
+
+        scheduled[next] = true;
+        if (m_nodes[next].live) {
+            m_schedule.push_back(m_nodes[next].type);
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (std::find(before[i].begin(), before[i].end(), next) != before[i].end()) {
+                inDegree[i]--;
+            }
+        }
+    }
+}
+
+std::string RenderGraph::describe() const {
+    std::stringstream ss;
+    for (size_t i = 0; i < m_schedule.size(); i++) {
+        if (i > 0) ss << " -> ";
+        ss << PassConfig::getTypeName(m_schedule[i]);
+        const RenderGraphNode* node = getNode(m_schedule[i]);
+        if (node && node->selfRead) ss << "(pp)";
+    }
+    if (m_schedule.empty()) {
+        ss << "(empty)";
+    }
+
+    bool first = true;
+    for (const auto& node : m_nodes) {
+        if (node.live) continue;
+        ss << (first ? ", skipped: " : " ") << PassConfig::getTypeName(node.type);
+        first = false;
+    }
+    return ss.str();
+}
+
+} // namespace shadertoy
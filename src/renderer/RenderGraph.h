@@ -0,0 +1,94 @@
+/**
+ * RenderGraph - 根据 Pass 的 Channel 绑定构建渲染依赖图
+ *
+ * 读取语义与 Shadertoy 一致：
+ * - 读取排在自己之前的 Buffer：看到本帧结果（同帧依赖，被读者必须先渲染）
+ * - 读取自身或排在自己之后的 Buffer：看到上一帧结果（跨帧依赖，读者必须先渲染）
+ * 据此做拓扑排序，剔除输出最终不被 Image（或其他根）使用的 Pass，
+ * 并标记只有读取自身上一帧的 Buffer 才需要 ping-pong 双缓冲
+ *
+ * 经过其他 Buffer 的环（A 读 B、B 读 A）不需要双缓冲：按调度顺序，
+ * 环上每次读取都发生在被读 Buffer 本帧写入之前或之后，不会同时读写同一纹理
+ */
+
+#pragma once
+
+#include "../core/ScreensaverMode.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace shadertoy {
+
+/**
+ * 图中的单个 Pass 节点
+ */
+struct RenderGraphNode {
+    ShaderPassType type = ShaderPassType::Image;
+    int bufferIndex = -1;                           // 0-3 = Buffer A-D, -1 = Image
+    std::array<int, 4> channels = {-1, -1, -1, -1};
+    bool live = false;                              // 输出是否（间接）被根节点使用
+    bool selfRead = false;                          // 读取自身上一帧（需要 ping-pong）
+    std::vector<ShaderPassType> sameFrameReaders;     // 读取本帧结果的 Pass
+    std::vector<ShaderPassType> previousFrameReaders; // 读取上一帧结果的 Pass（不含自身）
+};
+
+/**
+ * 渲染依赖图
+ */
+class RenderGraph {
+public:
+    /**
+     * 参与构建的 Pass（仅包含已启用且编译成功的 Pass）
+     */
+    struct PassInput {
+        ShaderPassType type;
+        std::array<int, 4> channels;
+    };
+
+    /**
+     * 构建依赖图
+     * @param passes 可渲染的 Pass
+     * @param roots 输出必须保留的 Pass（通常为 Image，Debug 模式下加上被查看的 Buffer）
+     */
+    void build(const std::vector<PassInput>& passes, const std::vector<ShaderPassType>& roots);
+
+    /**
+     * 清空
+     */
+    void clear();
+
+    /**
+     * 执行顺序（只包含 live 的 Pass）
+     */
+    const std::vector<ShaderPassType>& getSchedule() const { return m_schedule; }
+
+    /**
+     * 获取节点，不在图中返回 nullptr
+     */
+    const RenderGraphNode* getNode(ShaderPassType type) const;
+
+    /**
+     * Buffer 是否需要渲染 / 是否需要 ping-pong
+     */
+    bool isBufferLive(int bufferIndex) const;
+    bool needsPingPong(int bufferIndex) const;
+
+    /**
+     * 单行描述（日志用），例如 "BufferA(pp) -> Image, skipped: BufferB"
+     */
+    std::string describe() const;
+
+    /**
+     * Shadertoy 规定的 Pass 顺序中的位置（Buffer A-D = 0-3，Image = 4）
+     */
+    static int canonicalIndex(ShaderPassType type);
+
+private:
+    std::vector<RenderGraphNode> m_nodes;       // 按 canonicalIndex 排序
+    std::vector<ShaderPassType> m_schedule;
+
+    int findNode(ShaderPassType type) const;
+};
+
+} // namespace shadertoy
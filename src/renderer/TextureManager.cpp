@@ -1,12 +1,200 @@
 #include "TextureManager.h"
 #include "NoiseGenerator.h"
+#include "TexturePack.h"
+#include "core/ScreensaverMode.h"
+#include "utils/FileUtils.h"
+#include "utils/Hash.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 
 #include <stb_image.h>
 
+namespace fs = std::filesystem;
+
 namespace shadertoy {
 
+namespace {
+
+// 内置纹理的生成方式
+enum class BuiltinGenerator {
+    WhiteNoise,
+    Perlin,
+    Organic,
+    BlueNoise,
+    Checkerboard,
+    SolidColor,
+    UVGradient
+};
+
+// 内置纹理描述，生成参数全部参与纹理包的缓存键
+struct BuiltinTextureDesc {
+    BuiltinTextureType type;
+    const char* name;
+    const char* description;
+    int width;
+    int height;
+    int channels;
+    bool tileable;
+    BuiltinGenerator generator;
+    unsigned int seed;          // 白噪声种子
+    int param;                  // Perlin 八度数 / 棋盘格单元大小
+    float color[4];             // 纯色
+};
+
+const BuiltinTextureDesc BUILTIN_TEXTURES[] = {
+    // 灰度噪声
+    {BuiltinTextureType::GrayNoise256, "Gray Noise 256", "256x256 grayscale white noise",
+     256, 256, 1, true, BuiltinGenerator::WhiteNoise, 12345, 0, {}},
+    {BuiltinTextureType::GrayNoiseMedium, "Gray Noise Medium", "64x64 grayscale white noise",
+     64, 64, 1, true, BuiltinGenerator::WhiteNoise, 23456, 0, {}},
+    {BuiltinTextureType::GrayNoiseSmall, "Gray Noise Small", "32x32 grayscale white noise",
+     32, 32, 1, true, BuiltinGenerator::WhiteNoise, 34567, 0, {}},
+
+    // RGBA噪声
+    {BuiltinTextureType::RGBANoise256, "RGBA Noise 256", "256x256 RGBA white noise",
+     256, 256, 4, true, BuiltinGenerator::WhiteNoise, 45678, 0, {}},
+    {BuiltinTextureType::RGBANoiseMedium, "RGBA Noise Medium", "64x64 RGBA white noise",
+     64, 64, 4, true, BuiltinGenerator::WhiteNoise, 56789, 0, {}},
+    {BuiltinTextureType::RGBANoiseSmall, "RGBA Noise Small", "32x32 RGBA white noise",
+     32, 32, 4, true, BuiltinGenerator::WhiteNoise, 67890, 0, {}},
+
+    // Perlin噪声
+    {BuiltinTextureType::PerlinNoise256, "Perlin Noise 256", "256x256 Perlin noise (4 octaves)",
+     256, 256, 1, true, BuiltinGenerator::Perlin, 0, 4, {}},
+    {BuiltinTextureType::PerlinNoise512, "Perlin Noise 512", "512x512 Perlin noise (6 octaves)",
+     512, 512, 1, true, BuiltinGenerator::Perlin, 0, 6, {}},
+
+    // 有机噪声
+    {BuiltinTextureType::OrganicNoise, "Organic Noise", "256x256 organic texture (multi-layer noise)",
+     256, 256, 4, true, BuiltinGenerator::Organic, 0, 0, {}},
+
+    // 蓝噪声
+    {BuiltinTextureType::BlueNoise, "Blue Noise", "64x64 blue noise (for dithering)",
+     64, 64, 1, true, BuiltinGenerator::BlueNoise, 0, 0, {}},
+
+    // 棋盘格
+    {BuiltinTextureType::Checkerboard, "Checkerboard", "256x256 checkerboard pattern",
+     256, 256, 1, true, BuiltinGenerator::Checkerboard, 0, 16, {}},
+
+    // 纯黑 / 纯白
+    {BuiltinTextureType::Black, "Black", "8x8 solid black",
+     8, 8, 4, true, BuiltinGenerator::SolidColor, 0, 0, {0.0f, 0.0f, 0.0f, 1.0f}},
+    {BuiltinTextureType::White, "White", "8x8 solid white",
+     8, 8, 4, true, BuiltinGenerator::SolidColor, 0, 0, {1.0f, 1.0f, 1.0f, 1.0f}},
+
+    // UV渐变
+    {BuiltinTextureType::UV, "UV Gradient", "256x256 UV coordinate gradient",
+     256, 256, 4, false, BuiltinGenerator::UVGradient, 0, 0, {}},
+};
+
+const char* const PACK_FILE_NAME = "builtin_textures.pack";
+
+// 纹理包缓存键：生成参数 + 噪声算法版本，任何一项变化都会使对应条目失效
+uint64_t makeTextureKey(const BuiltinTextureDesc& desc) {
+    int32_t fields[] = {
+        NoiseGenerator::VERSION,
+        static_cast<int32_t>(desc.type),
+        static_cast<int32_t>(desc.generator),
+        desc.width,
+        desc.height,
+        desc.channels,
+        static_cast<int32_t>(desc.seed),
+        desc.param,
+    };
+    uint64_t key = Hash::fnv1a(fields, sizeof(fields));
+    return Hash::fnv1a(desc.color, sizeof(desc.color), key);
+}
+
+// 生成第 0 级像素数据
+std::vector<uint8_t> generatePixels(const BuiltinTextureDesc& desc) {
+    const int width = desc.width;
+    const int height = desc.height;
+
+    switch (desc.generator) {
+        case BuiltinGenerator::WhiteNoise:
+            return NoiseGenerator::generateWhiteNoise(width, height, desc.channels, desc.seed);
+
+        case BuiltinGenerator::Perlin: {
+            auto floatData = NoiseGenerator::generatePerlin2D(width, height, desc.param, 0.5f, 4.0f);
+
+            // 转换为uint8
+            std::vector<uint8_t> data(floatData.size());
+            for (size_t i = 0; i < floatData.size(); i++) {
+                data[i] = static_cast<uint8_t>(std::min(floatData[i] * 255.0f, 255.0f));
+            }
+            return data;
+        }
+
+        case BuiltinGenerator::Organic:
+            return NoiseGenerator::generateOrganic(width, height);
+
+        case BuiltinGenerator::BlueNoise:
+            return NoiseGenerator::generateBlueNoise(width, height);
+
+        case BuiltinGenerator::Checkerboard: {
+            std::vector<uint8_t> data(width * height);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    bool isWhite = ((x / desc.param) + (y / desc.param)) % 2 == 0;
+                    data[y * width + x] = isWhite ? 255 : 0;
+                }
+            }
+            return data;
+        }
+
+        case BuiltinGenerator::SolidColor: {
+            std::vector<uint8_t> data(width * height * 4);
+            for (int i = 0; i < width * height; i++) {
+                for (int c = 0; c < 4; c++) {
+                    data[i * 4 + c] = static_cast<uint8_t>(desc.color[c] * 255.0f);
+                }
+            }
+            return data;
+        }
+
+        case BuiltinGenerator::UVGradient: {
+            std::vector<uint8_t> data(width * height * 4);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    int idx = (y * width + x) * 4;
+                    data[idx + 0] = static_cast<uint8_t>((float)x / width * 255.0f);
+                    data[idx + 1] = static_cast<uint8_t>((float)y / height * 255.0f);
+                    data[idx + 2] = 0;
+                    data[idx + 3] = 255;
+                }
+            }
+            return data;
+        }
+    }
+
+    return std::vector<uint8_t>(static_cast<size_t>(width) * height * desc.channels, 0);
+}
+
+// 生成完整图像（含 mip 链）
+TextureImage generateImage(const BuiltinTextureDesc& desc, uint64_t key) {
+    TextureImage image;
+    image.key = key;
+    image.width = desc.width;
+    image.height = desc.height;
+    image.channels = desc.channels;
+    image.levels.push_back(generatePixels(desc));
+    image.buildMipChain();
+    return image;
+}
+
+std::vector<const unsigned char*> getLevelPointers(const TextureImage& image) {
+    std::vector<const unsigned char*> levels;
+    for (const auto& level : image.levels) {
+        levels.push_back(level.data());
+    }
+    return levels;
+}
+
+} // namespace
+
 TextureManager& TextureManager::instance() {
     static TextureManager instance;
     return instance;
@@ -16,237 +204,241 @@ TextureManager::~TextureManager() {
     cleanup();
 }
 
-bool TextureManager::init() {
+std::string TextureManager::getDefaultPackPath() {
+    std::string configDir = FileUtils::getDirectory(ScreensaverMode::getConfigPath());
+    if (configDir.empty()) {
+        return PACK_FILE_NAME;
+    }
+    return (fs::path(configDir) / PACK_FILE_NAME).string();
+}
+
+bool TextureManager::init(const std::string& packPath) {
     if (m_initialized) return true;
     
     std::cout << "Initializing TextureManager..." << std::endl;
     
-    // 预分配空间
-    m_builtinTextures.reserve(static_cast<size_t>(BuiltinTextureType::Count));
-    
-    // 创建所有内置纹理
+    // 只建立元数据，纹理在 getBuiltinTexture 首次请求时创建
+    const size_t count = sizeof(BUILTIN_TEXTURES) / sizeof(BUILTIN_TEXTURES[0]);
+    m_builtinTextures.reserve(count);
     
-    // 灰度噪声
-    {
+    for (size_t i = 0; i < count; i++) {
+        const BuiltinTextureDesc& desc = BUILTIN_TEXTURES[i];
+        
         TextureInfo info;
-        info.name = "Gray Noise 256";
-        info.description = "256x256 grayscale white noise";
-        info.width = 256;
-        info.height = 256;
-        info.channels = 1;
-        info.type = BuiltinTextureType::GrayNoise256;
-        info.isTileable = true;
-        info.id = createGrayNoiseTexture(256, 256, 12345);
+        info.name = desc.name;
+        info.description = desc.description;
+        info.width = desc.width;
+        info.height = desc.height;
+        info.channels = desc.channels;
+        info.id = 0;
+        info.type = desc.type;
+        info.isTileable = desc.tileable;
         m_builtinTextures.push_back(info);
     }
     
-    {
-        TextureInfo info;
-        info.name = "Gray Noise Medium";
-        info.description = "64x64 grayscale white noise";
-        info.width = 64;
-        info.height = 64;
-        info.channels = 1;
-        info.type = BuiltinTextureType::GrayNoiseMedium;
-        info.isTileable = true;
-        info.id = createGrayNoiseTexture(64, 64, 23456);
-        m_builtinTextures.push_back(info);
-    }
+    m_packPath = packPath;
+    m_slotStates.assign(count, SlotState::Missing);
+    m_readyImages.assign(count, TextureImage());
     
-    {
-        TextureInfo info;
-        info.name = "Gray Noise Small";
-        info.description = "32x32 grayscale white noise";
-        info.width = 32;
-        info.height = 32;
-        info.channels = 1;
-        info.type = BuiltinTextureType::GrayNoiseSmall;
-        info.isTileable = true;
-        info.id = createGrayNoiseTexture(32, 32, 34567);
-        m_builtinTextures.push_back(info);
-    }
+    m_asyncLoader.init();
     
-    // RGBA噪声
+    std::cout << "TextureManager initialized with " << m_builtinTextures.size()
+              << " builtin textures (created on first use)." << std::endl;
+    m_initialized = true;
+    return true;
+}
+
+void TextureManager::cleanup() {
+    stopPrefetch();
+    flushPack();
     {
-        TextureInfo info;
-        info.name = "RGBA Noise 256";
-        info.description = "256x256 RGBA white noise";
-        info.width = 256;
-        info.height = 256;
-        info.channels = 4;
-        info.type = BuiltinTextureType::RGBANoise256;
-        info.isTileable = true;
-        info.id = createRGBANoiseTexture(256, 256, 45678);
-        m_builtinTextures.push_back(info);
+        std::lock_guard<std::mutex> lock(m_packMutex);
+        m_pack.close();
+        m_packOpenFailed = false;
     }
     
-    {
-        TextureInfo info;
-        info.name = "RGBA Noise Medium";
-        info.description = "64x64 RGBA white noise";
-        info.width = 64;
-        info.height = 64;
-        info.channels = 4;
-        info.type = BuiltinTextureType::RGBANoiseMedium;
-        info.isTileable = true;
-        info.id = createRGBANoiseTexture(64, 64, 56789);
-        m_builtinTextures.push_back(info);
+    for (auto& tex : m_builtinTextures) {
+        if (tex.id) {
+            glDeleteTextures(1, &tex.id);
+        }
     }
+    m_builtinTextures.clear();
+    m_slotStates.clear();
+    m_readyImages.clear();
     
-    {
-        TextureInfo info;
-        info.name = "RGBA Noise Small";
-        info.description = "32x32 RGBA white noise";
-        info.width = 32;
-        info.height = 32;
-        info.channels = 4;
-        info.type = BuiltinTextureType::RGBANoiseSmall;
-        info.isTileable = true;
-        info.id = createRGBANoiseTexture(32, 32, 67890);
-        m_builtinTextures.push_back(info);
-    }
+    // 加载器先交还它持有的引用，再统一删除
+    m_asyncLoader.cleanup();
+    m_registry.clear();
     
-    // Perlin噪声
-    {
-        TextureInfo info;
-        info.name = "Perlin Noise 256";
-        info.description = "256x256 Perlin noise (4 octaves)";
-        info.width = 256;
-        info.height = 256;
-        info.channels = 1;
-        info.type = BuiltinTextureType::PerlinNoise256;
-        info.isTileable = true;
-        info.id = createPerlinNoiseTexture(256, 256, 4);
-        m_builtinTextures.push_back(info);
+    m_initialized = false;
+}
+
+GLuint TextureManager::getBuiltinTexture(BuiltinTextureType type) {
+    size_t index = 0;
+    while (index < m_builtinTextures.size() && m_builtinTextures[index].type != type) {
+        index++;
     }
-    
-    {
-        TextureInfo info;
-        info.name = "Perlin Noise 512";
-        info.description = "512x512 Perlin noise (6 octaves)";
-        info.width = 512;
-        info.height = 512;
-        info.channels = 1;
-        info.type = BuiltinTextureType::PerlinNoise512;
-        info.isTileable = true;
-        info.id = createPerlinNoiseTexture(512, 512, 6);
-        m_builtinTextures.push_back(info);
+    if (index == m_builtinTextures.size()) {
+        return 0;
     }
     
-    // 有机噪声
-    {
-        TextureInfo info;
-        info.name = "Organic Noise";
-        info.description = "256x256 organic texture (multi-layer noise)";
-        info.width = 256;
-        info.height = 256;
-        info.channels = 4;
-        info.type = BuiltinTextureType::OrganicNoise;
-        info.isTileable = true;
-        info.id = createOrganicNoiseTexture(256, 256);
-        m_builtinTextures.push_back(info);
+    TextureInfo& info = m_builtinTextures[index];
+    if (info.id) {
+        return info.id;
     }
     
-    // 蓝噪声
+    // 后台线程正在准备时等待它完成，已就绪则直接接手其数据
+    TextureImage image;
+    bool prefetched = false;
     {
-        TextureInfo info;
-        info.name = "Blue Noise";
-        info.description = "64x64 blue noise (for dithering)";
-        info.width = 64;
-        info.height = 64;
-        info.channels = 1;
-        info.type = BuiltinTextureType::BlueNoise;
-        info.isTileable = true;
-        info.id = createBlueNoiseTexture(64, 64);
-        m_builtinTextures.push_back(info);
+        std::unique_lock<std::mutex> lock(m_slotMutex);
+        m_slotCv.wait(lock, [&]() { return m_slotStates[index] != SlotState::Loading; });
+        if (m_slotStates[index] == SlotState::Ready) {
+            image = std::move(m_readyImages[index]);
+            m_readyImages[index] = TextureImage();
+            prefetched = true;
+        }
+        m_slotStates[index] = SlotState::Uploaded;
     }
     
-    // 棋盘格
-    {
-        TextureInfo info;
-        info.name = "Checkerboard";
-        info.description = "256x256 checkerboard pattern";
-        info.width = 256;
-        info.height = 256;
-        info.channels = 1;
-        info.type = BuiltinTextureType::Checkerboard;
-        info.isTileable = true;
-        info.id = createCheckerboardTexture(256, 256, 16);
-        m_builtinTextures.push_back(info);
+    auto startTime = std::chrono::steady_clock::now();
+    if (!prefetched) {
+        // 命中纹理包时直接从映射内存上传，不经过堆拷贝
+        std::lock_guard<std::mutex> lock(m_packMutex);
+        const TexturePack::Entry* entry = findInPack(index);
+        if (entry) {
+            info.id = uploadTextureLevels(entry->levels, info.width, info.height, info.channels, info.isTileable);
+        }
     }
-    
-    // 纯黑
-    {
-        TextureInfo info;
-        info.name = "Black";
-        info.description = "8x8 solid black";
-        info.width = 8;
-        info.height = 8;
-        info.channels = 4;
-        info.type = BuiltinTextureType::Black;
-        info.isTileable = true;
-        info.id = createSolidColorTexture(8, 8, 0.0f, 0.0f, 0.0f, 1.0f);
-        m_builtinTextures.push_back(info);
+    if (!info.id) {
+        if (!prefetched) {
+            image = generateBuiltinImage(index);
+        }
+        info.id = uploadTextureLevels(getLevelPointers(image), info.width, info.height, info.channels,
+                                      info.isTileable);
     }
     
-    // 纯白
-    {
-        TextureInfo info;
-        info.name = "White";
-        info.description = "8x8 solid white";
-        info.width = 8;
-        info.height = 8;
-        info.channels = 4;
-        info.type = BuiltinTextureType::White;
-        info.isTileable = true;
-        info.id = createSolidColorTexture(8, 8, 1.0f, 1.0f, 1.0f, 1.0f);
-        m_builtinTextures.push_back(info);
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "TextureManager: Created " << info.name << " (" << static_cast<int>(elapsedMs) << " ms)"
+              << std::endl;
+    return info.id;
+}
+
+void TextureManager::prefetchBuiltinTextures() {
+    if (!m_initialized || m_prefetchThread.joinable()) {
+        return;
     }
     
-    // UV渐变
-    {
-        TextureInfo info;
-        info.name = "UV Gradient";
-        info.description = "256x256 UV coordinate gradient";
-        info.width = 256;
-        info.height = 256;
-        info.channels = 4;
-        info.type = BuiltinTextureType::UV;
-        info.isTileable = false;
-        info.id = createUVGradientTexture(256, 256);
-        m_builtinTextures.push_back(info);
+    m_stopPrefetch = false;
+    m_prefetchThread = std::thread([this]() {
+        for (size_t i = 0; i < m_slotStates.size() && !m_stopPrefetch; i++) {
+            {
+                std::lock_guard<std::mutex> lock(m_slotMutex);
+                if (m_slotStates[i] != SlotState::Missing) {
+                    continue;
+                }
+                m_slotStates[i] = SlotState::Loading;
+            }
+            
+            // 纹理包中已有的纹理留给主线程从映射上传，只有未命中的才在后台生成
+            bool inPack = false;
+            {
+                std::lock_guard<std::mutex> lock(m_packMutex);
+                inPack = findInPack(i) != nullptr;
+            }
+            TextureImage image;
+            if (!inPack) {
+                image = generateBuiltinImage(i);
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(m_slotMutex);
+                if (inPack) {
+                    m_slotStates[i] = SlotState::InPack;
+                } else {
+                    m_readyImages[i] = std::move(image);
+                    m_slotStates[i] = SlotState::Ready;
+                }
+            }
+            m_slotCv.notify_all();
+        }
+        
+        // 整个预取过程只写一次纹理包
+        flushPack();
+    });
+}
+
+void TextureManager::stopPrefetch() {
+    m_stopPrefetch = true;
+    if (m_prefetchThread.joinable()) {
+        m_prefetchThread.join();
     }
-    
-    std::cout << "TextureManager initialized with " << m_builtinTextures.size() << " builtin textures." << std::endl;
-    m_initialized = true;
-    return true;
 }
 
-void TextureManager::cleanup() {
-    for (auto& tex : m_builtinTextures) {
-        if (tex.id) {
-            glDeleteTextures(1, &tex.id);
-        }
+const TexturePack::Entry* TextureManager::findInPack(size_t index) {
+    if (m_packPath.empty()) {
+        return nullptr;
     }
-    m_builtinTextures.clear();
     
-    for (auto& pair : m_userTextures) {
-        if (pair.first) {
-            glDeleteTextures(1, &pair.first);
-        }
+    if (!m_pack.isOpen() && !m_packOpenFailed) {
+        std::string packError;
+        m_packOpenFailed = !m_pack.open(m_packPath, packError);
+    }
+    if (!m_pack.isOpen()) {
+        return nullptr;
     }
-    m_userTextures.clear();
     
-    m_initialized = false;
+    const BuiltinTextureDesc& desc = BUILTIN_TEXTURES[index];
+    return m_pack.find(makeTextureKey(desc), desc.width, desc.height, desc.channels);
 }
 
-GLuint TextureManager::getBuiltinTexture(BuiltinTextureType type) const {
-    for (const auto& tex : m_builtinTextures) {
-        if (tex.type == type) {
-            return tex.id;
+TextureImage TextureManager::generateBuiltinImage(size_t index) {
+    const BuiltinTextureDesc& desc = BUILTIN_TEXTURES[index];
+    TextureImage image = generateImage(desc, makeTextureKey(desc));
+    
+    if (!m_packPath.empty()) {
+        std::lock_guard<std::mutex> lock(m_packMutex);
+        m_pendingImages.push_back(image);
+    }
+    return image;
+}
+
+void TextureManager::flushPack() {
+    std::lock_guard<std::mutex> lock(m_packMutex);
+    if (m_packPath.empty() || m_pendingImages.empty()) {
+        return;
+    }
+    
+    // 保留包中与当前表一致的条目（表中已移除或参数已变化的条目随之丢弃）
+    std::vector<TextureImage> kept;
+    for (size_t i = 0; i < sizeof(BUILTIN_TEXTURES) / sizeof(BUILTIN_TEXTURES[0]); i++) {
+        uint64_t key = makeTextureKey(BUILTIN_TEXTURES[i]);
+        bool regenerated = std::any_of(m_pendingImages.begin(), m_pendingImages.end(),
+                                       [key](const TextureImage& image) { return image.key == key; });
+        const TexturePack::Entry* entry = regenerated ? nullptr : findInPack(i);
+        if (entry) {
+            kept.push_back(TexturePack::copyEntry(*entry));
         }
     }
-    return 0;
+    
+    // 写回前必须解除映射（Windows 下映射中的文件不能被替换），下次查找时重新映射
+    m_pack.close();
+    m_packOpenFailed = false;
+    
+    std::vector<const TextureImage*> packImages;
+    for (const auto& image : kept) {
+        packImages.push_back(&image);
+    }
+    for (const auto& image : m_pendingImages) {
+        packImages.push_back(&image);
+    }
+    
+    std::string writeError;
+    if (!TexturePack::write(m_packPath, packImages, writeError)) {
+        std::cerr << "TextureManager: " << writeError << std::endl;
+    }
+    m_pendingImages.clear();
 }
 
 const TextureInfo* TextureManager::getTextureInfo(BuiltinTextureType type) const {
@@ -258,9 +450,15 @@ const TextureInfo* TextureManager::getTextureInfo(BuiltinTextureType type) const
     return nullptr;
 }
 
-GLuint TextureManager::loadUserTexture(const std::string& path) {
+GLuint TextureManager::loadUserTexture(const std::string& path, const UserTextureOptions& options) {
+    std::string key = TextureRegistry::makeKey(path, options);
+    GLuint textureId = m_registry.acquire(key);
+    if (textureId) {
+        return textureId;
+    }
+    
     int width, height, channels;
-    stbi_set_flip_vertically_on_load(true);
+    stbi_set_flip_vertically_on_load_thread(options.flipY ? 1 : 0);
     unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
     
     if (!data) {
@@ -268,21 +466,26 @@ GLuint TextureManager::loadUserTexture(const std::string& path) {
         return 0;
     }
     
-    GLuint textureId = uploadTexture(data, width, height, channels, true);
+    textureId = uploadTexture(data, width, height, channels, options.repeat);
     stbi_image_free(data);
     
     if (textureId) {
-        m_userTextures[textureId] = path;
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        TextureRegistry::applySampler(options);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        m_registry.insert(key, textureId, width, height, channels);
     }
     
     return textureId;
 }
 
 void TextureManager::unloadUserTexture(GLuint id) {
-    auto it = m_userTextures.find(id);
-    if (it != m_userTextures.end()) {
-        glDeleteTextures(1, &id);
-        m_userTextures.erase(it);
+    m_registry.release(id);
+}
+
+void TextureManager::update() {
+    if (m_initialized) {
+        m_asyncLoader.update();
     }
 }
 
@@ -316,95 +519,10 @@ std::string TextureManager::getTextureName(BuiltinTextureType type) {
     }
 }
 
-// 创建灰度噪声纹理
-GLuint TextureManager::createGrayNoiseTexture(int width, int height, unsigned int seed) {
-    auto data = NoiseGenerator::generateWhiteNoise(width, height, 1, seed);
-    return uploadTexture(data.data(), width, height, 1, true);
-}
-
-// 创建RGBA噪声纹理
-GLuint TextureManager::createRGBANoiseTexture(int width, int height, unsigned int seed) {
-    auto data = NoiseGenerator::generateWhiteNoise(width, height, 4, seed);
-    return uploadTexture(data.data(), width, height, 4, true);
-}
-
-// 创建Perlin噪声纹理
-GLuint TextureManager::createPerlinNoiseTexture(int width, int height, int octaves) {
-    auto floatData = NoiseGenerator::generatePerlin2D(width, height, octaves, 0.5f, 4.0f);
-    
-    // 转换为uint8
-    std::vector<uint8_t> data(floatData.size());
-    for (size_t i = 0; i < floatData.size(); i++) {
-        data[i] = static_cast<uint8_t>(std::min(floatData[i] * 255.0f, 255.0f));
-    }
-    
-    return uploadTexture(data.data(), width, height, 1, true);
-}
-
-// 创建有机噪声纹理
-GLuint TextureManager::createOrganicNoiseTexture(int width, int height) {
-    auto data = NoiseGenerator::generateOrganic(width, height);
-    return uploadTexture(data.data(), width, height, 4, true);
-}
-
-// 创建蓝噪声纹理
-GLuint TextureManager::createBlueNoiseTexture(int width, int height) {
-    auto data = NoiseGenerator::generateBlueNoise(width, height);
-    return uploadTexture(data.data(), width, height, 1, true);
-}
-
-// 创建棋盘格纹理
-GLuint TextureManager::createCheckerboardTexture(int width, int height, int cellSize) {
-    std::vector<uint8_t> data(width * height);
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            bool isWhite = ((x / cellSize) + (y / cellSize)) % 2 == 0;
-            data[y * width + x] = isWhite ? 255 : 0;
-        }
-    }
-    
-    return uploadTexture(data.data(), width, height, 1, true);
-}
-
-// 创建纯色纹理
-GLuint TextureManager::createSolidColorTexture(int width, int height, float r, float g, float b, float a) {
-    std::vector<uint8_t> data(width * height * 4);
-    
-    uint8_t R = static_cast<uint8_t>(r * 255.0f);
-    uint8_t G = static_cast<uint8_t>(g * 255.0f);
-    uint8_t B = static_cast<uint8_t>(b * 255.0f);
-    uint8_t A = static_cast<uint8_t>(a * 255.0f);
-    
-    for (int i = 0; i < width * height; i++) {
-        data[i * 4 + 0] = R;
-        data[i * 4 + 1] = G;
-        data[i * 4 + 2] = B;
-        data[i * 4 + 3] = A;
-    }
-    
-    return uploadTexture(data.data(), width, height, 4, true);
-}
-
-// 创建UV渐变纹理
-GLuint TextureManager::createUVGradientTexture(int width, int height) {
-    std::vector<uint8_t> data(width * height * 4);
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = (y * width + x) * 4;
-            data[idx + 0] = static_cast<uint8_t>((float)x / width * 255.0f);
-            data[idx + 1] = static_cast<uint8_t>((float)y / height * 255.0f);
-            data[idx + 2] = 0;
-            data[idx + 3] = 255;
-        }
-    }
-    
-    return uploadTexture(data.data(), width, height, 4, false);
-}
+namespace {
 
-// 上传纹理到GPU
-GLuint TextureManager::uploadTexture(const unsigned char* data, int width, int height, int channels, bool tileable) {
+// 创建纹理对象并设置采样参数
+GLuint createTextureObject(bool tileable) {
     GLuint textureId;
     glGenTextures(1, &textureId);
     glBindTexture(GL_TEXTURE_2D, textureId);
@@ -421,9 +539,11 @@ GLuint TextureManager::uploadTexture(const unsigned char* data, int width, int h
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     
-    // 确定格式
-    GLenum format;
-    GLenum internalFormat;
+    return textureId;
+}
+
+// 确定格式
+void getTextureFormat(int channels, GLenum& format, GLenum& internalFormat) {
     switch (channels) {
         case 1:
             format = GL_RED;
@@ -443,6 +563,17 @@ GLuint TextureManager::uploadTexture(const unsigned char* data, int width, int h
             internalFormat = GL_RGBA8;
             break;
     }
+}
+
+} // namespace
+
+// 上传纹理到GPU
+GLuint TextureManager::uploadTexture(const unsigned char* data, int width, int height, int channels, bool tileable) {
+    GLuint textureId = createTextureObject(tileable);
+    
+    GLenum format;
+    GLenum internalFormat;
+    getTextureFormat(channels, format, internalFormat);
     
     // 上传数据
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
@@ -453,4 +584,32 @@ GLuint TextureManager::uploadTexture(const unsigned char* data, int width, int h
     return textureId;
 }
 
+// 上传带完整 mip 链的纹理
+GLuint TextureManager::uploadTextureLevels(const std::vector<const unsigned char*>& levels, int width, int height,
+                                           int channels, bool tileable) {
+    GLuint textureId = createTextureObject(tileable);
+    
+    GLenum format;
+    GLenum internalFormat;
+    getTextureFormat(channels, format, internalFormat);
+    
+    // 各级数据紧密排列，小尺寸级别的行宽不是 4 的倍数
+    GLint previousAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    
+    for (size_t level = 0; level < levels.size(); level++) {
+        int levelWidth = std::max(1, width >> level);
+        int levelHeight = std::max(1, height >> level);
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internalFormat, levelWidth, levelHeight, 0,
+                     format, GL_UNSIGNED_BYTE, levels[level]);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size()) - 1);
+    
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    return textureId;
+}
+
 } // namespace shadertoy
@@ -1,10 +1,17 @@
 #pragma once
 
+#include "AsyncTextureLoader.h"
+#include "TexturePack.h"
+#include "TextureRegistry.h"
+
 #include <glad/glad.h>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace shadertoy {
 
@@ -44,7 +51,7 @@ struct TextureInfo {
     int width;
     int height;
     int channels;
-    GLuint id;
+    GLuint id;                  // 内置纹理首次使用前为 0
     BuiltinTextureType type;
     bool isTileable;
 };
@@ -58,23 +65,42 @@ public:
     TextureManager(const TextureManager&) = delete;
     TextureManager& operator=(const TextureManager&) = delete;
     
-    // 初始化所有内置纹理
-    bool init();
+    // 初始化内置纹理表（只建立元数据，纹理在首次使用时才生成并上传）
+    // packPath: 内置纹理包路径，命中的纹理直接从包中读取，其余生成后写回（空 = 不使用纹理包）
+    bool init(const std::string& packPath = getDefaultPackPath());
+    
+    // 默认纹理包：配置文件旁的 builtin_textures.pack
+    static std::string getDefaultPackPath();
     
     // 清理资源
     void cleanup();
     
-    // 获取内置纹理
-    GLuint getBuiltinTexture(BuiltinTextureType type) const;
+    // 获取内置纹理，首次调用时读取/生成并上传（需要在 GL 线程调用）
+    GLuint getBuiltinTexture(BuiltinTextureType type);
     const TextureInfo* getTextureInfo(BuiltinTextureType type) const;
     
-    // 获取所有内置纹理列表
+    // 获取所有内置纹理列表（元数据，未使用过的纹理 id 为 0）
     const std::vector<TextureInfo>& getBuiltinTextures() const { return m_builtinTextures; }
     
-    // 加载用户纹理
-    GLuint loadUserTexture(const std::string& path);
+    // 在后台线程准备所有尚未创建的内置纹理的像素数据（不做 GL 调用）
+    // 之后的 getBuiltinTexture 只需上传，用于通道选择器等即将用到任意纹理的场合
+    void prefetchBuiltinTextures();
+    
+    // 加载用户纹理（在调用线程同步解码并上传，大图会阻塞渲染）
+    // 同一路径和选项的纹理只上传一次，每次成功调用都要对应一次 unloadUserTexture
+    GLuint loadUserTexture(const std::string& path, const UserTextureOptions& options = UserTextureOptions());
     void unloadUserTexture(GLuint id);
     
+    // 用户纹理的显存预算：引用归零的纹理保留在预算内以便复用，超出时按 LRU 淘汰
+    void setUserTextureBudget(size_t bytes) { m_registry.setBudget(bytes); }
+    const TextureRegistryStats& getUserTextureStats() const { return m_registry.getStats(); }
+    
+    // 异步加载用户纹理：后台解码、每帧分块上传，就绪前解析为占位纹理
+    AsyncTextureLoader& getAsyncLoader() { return m_asyncLoader; }
+    
+    // 每帧在 GL 线程调用，推进异步纹理的上传
+    void update();
+    
     // 绑定纹理到指定单元
     void bindTexture(GLuint textureId, int unit) const;
     void unbindTexture(int unit) const;
@@ -83,26 +109,55 @@ public:
     static std::string getTextureName(BuiltinTextureType type);
 
 private:
+    // 内置纹理的准备状态
+    enum class SlotState {
+        Missing,        // 尚未准备
+        Loading,        // 后台线程正在读取/生成
+        Ready,          // 像素数据已就绪，等待上传
+        InPack,         // 纹理包中已有，由主线程直接从映射上传
+        Uploaded        // 已上传（或已由主线程接手）
+    };
+    
     TextureManager() = default;
     ~TextureManager();
     
-    // 生成各种噪声纹理
-    GLuint createGrayNoiseTexture(int width, int height, unsigned int seed = 0);
-    GLuint createRGBANoiseTexture(int width, int height, unsigned int seed = 0);
-    GLuint createPerlinNoiseTexture(int width, int height, int octaves = 4);
-    GLuint createOrganicNoiseTexture(int width, int height);
-    GLuint createBlueNoiseTexture(int width, int height);
-    GLuint createCheckerboardTexture(int width, int height, int cellSize = 16);
-    GLuint createSolidColorTexture(int width, int height, float r, float g, float b, float a);
-    GLuint createUVGradientTexture(int width, int height);
-    
-    // 上传纹理数据到GPU
+    // 在纹理包中查找内置纹理，首次查找时映射纹理包并一直保持到下次写回（调用方持有 m_packMutex）
+    const TexturePack::Entry* findInPack(size_t index);
+    
+    // 生成内置纹理并记入待写回列表（不做 GL 调用，可在任意线程调用）
+    TextureImage generateBuiltinImage(size_t index);
+    
+    // 把待写回的图像连同包中仍有效的条目一次写成新的纹理包
+    void flushPack();
+    
+    void stopPrefetch();
+    
+    // 上传纹理数据到GPU（自动生成 mip）
     GLuint uploadTexture(const unsigned char* data, int width, int height, int channels, bool tileable);
     
+    // 上传带完整 mip 链的纹理（levels[i] 为第 i 级的紧密排列数据）
+    GLuint uploadTextureLevels(const std::vector<const unsigned char*>& levels, int width, int height,
+                               int channels, bool tileable);
+    
 private:
     std::vector<TextureInfo> m_builtinTextures;
-    std::unordered_map<GLuint, std::string> m_userTextures;
+    TextureRegistry m_registry;                         // 同步和异步加载的用户纹理共用
+    AsyncTextureLoader m_asyncLoader{&m_registry};
     bool m_initialized = false;
+    
+    std::string m_packPath;
+    std::mutex m_packMutex;                 // 保护 m_pack / m_packOpenFailed / m_pendingImages
+    TexturePack m_pack;                     // 保持映射，上传直接读取映射内存
+    bool m_packOpenFailed = false;          // 打开失败后不再重试，直到下次写回
+    std::vector<TextureImage> m_pendingImages;  // 已生成但尚未写入纹理包的图像
+    
+    // 后台预取（m_slotStates / m_readyImages 受 m_slotMutex 保护）
+    std::mutex m_slotMutex;
+    std::condition_variable m_slotCv;
+    std::vector<SlotState> m_slotStates;
+    std::vector<TextureImage> m_readyImages;
+    std::thread m_prefetchThread;
+    std::atomic<bool> m_stopPrefetch{false};
 };
 
 } // namespace shadertoy
@@ -0,0 +1,274 @@
+#include "TexturePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace shadertoy {
+
+namespace {
+
+// 纹理包文件头
+struct PackHeader {
+    char magic[4];          // "STTP"
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+// 条目表
+struct PackEntry {
+    uint64_t key;
+    int32_t width;
+    int32_t height;
+    int32_t channels;
+    int32_t levels;
+    uint64_t offset;        // 相对文件开头
+    uint64_t size;          // 所有级别的总字节数
+};
+
+const char PACK_MAGIC[4] = {'S', 'T', 'T', 'P'};
+const size_t DATA_ALIGNMENT = 16;
+
+size_t alignUp(size_t value) {
+    return (value + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+}
+
+// 第 level 级的尺寸
+int levelSize(int size, int level) {
+    return std::max(1, size >> level);
+}
+
+size_t levelBytes(int width, int height, int channels, int level) {
+    return static_cast<size_t>(levelSize(width, level)) * levelSize(height, level) * channels;
+}
+
+} // namespace
+
+void TextureImage::buildMipChain() {
+    levels.resize(1);
+    int w = width;
+    int h = height;
+
+    while (w > 1 || h > 1) {
+        const std::vector<uint8_t>& src = levels.back();
+        int nw = std::max(1, w / 2);
+        int nh = std::max(1, h / 2);
+        std::vector<uint8_t> dst(static_cast<size_t>(nw) * nh * channels);
+
+        for (int y = 0; y < nh; y++) {
+            int y0 = std::min(y * 2, h - 1);
+            int y1 = std::min(y * 2 + 1, h - 1);
+            for (int x = 0; x < nw; x++) {
+                int x0 = std::min(x * 2, w - 1);
+                int x1 = std::min(x * 2 + 1, w - 1);
+                for (int c = 0; c < channels; c++) {
+                    int sum = src[(y0 * w + x0) * channels + c] + src[(y0 * w + x1) * channels + c] +
+                              src[(y1 * w + x0) * channels + c] + src[(y1 * w + x1) * channels + c];
+                    dst[(y * nw + x) * channels + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        levels.push_back(std::move(dst));
+        w = nw;
+        h = nh;
+    }
+}
+
+int TexturePack::getLevelCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+bool TexturePack::open(const std::string& path, std::string& errorOut) {
+    close();
+
+    if (!m_file.open(path, errorOut)) {
+        return false;
+    }
+
+    const uint8_t* base = m_file.data();
+    const size_t fileSize = m_file.size();
+
+    PackHeader header{};
+    if (fileSize < sizeof(header)) {
+        errorOut = "Texture pack is truncated";
+        close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) {
+        errorOut = "Not a texture pack";
+        close();
+        return false;
+    }
+    if (header.version != VERSION) {
+        errorOut = "Texture pack version " + std::to_string(header.version) +
+                   " (expected " + std::to_string(VERSION) + ")";
+        close();
+        return false;
+    }
+    if (sizeof(header) + static_cast<size_t>(header.entryCount) * sizeof(PackEntry) > fileSize) {
+        errorOut = "Texture pack entry table is truncated";
+        close();
+        return false;
+    }
+
+    m_entries.reserve(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        PackEntry packed{};
+        std::memcpy(&packed, base + sizeof(header) + i * sizeof(PackEntry), sizeof(packed));
+
+        // 校验条目，损坏的文件不能导致越界读取
+        bool valid = packed.width > 0 && packed.height > 0 &&
+                     packed.channels >= 1 && packed.channels <= 4 &&
+                     packed.levels == getLevelCount(packed.width, packed.height) &&
+                     packed.offset <= fileSize && packed.size <= fileSize - packed.offset;
+        size_t expected = 0;
+        for (int level = 0; valid && level < packed.levels; level++) {
+            expected += levelBytes(packed.width, packed.height, packed.channels, level);
+        }
+        if (!valid || expected != packed.size) {
+            errorOut = "Texture pack entry " + std::to_string(i) + " is corrupt";
+            close();
+            return false;
+        }
+
+        Entry entry;
+        entry.key = packed.key;
+        entry.width = packed.width;
+        entry.height = packed.height;
+        entry.channels = packed.channels;
+        const uint8_t* data = base + packed.offset;
+        for (int level = 0; level < packed.levels; level++) {
+            entry.levels.push_back(data);
+            data += levelBytes(packed.width, packed.height, packed.channels, level);
+        }
+        m_entries.push_back(std::move(entry));
+    }
+
+    return true;
+}
+
+void TexturePack::close() {
+    m_entries.clear();
+    m_file.close();
+}
+
+const TexturePack::Entry* TexturePack::find(uint64_t key, int width, int height, int channels) const {
+    for (const auto& entry : m_entries) {
+        if (entry.key == key) {
+            if (entry.width == width && entry.height == height && entry.channels == channels) {
+                return &entry;
+            }
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+TextureImage TexturePack::copyEntry(const Entry& entry) {
+    TextureImage image;
+    image.key = entry.key;
+    image.width = entry.width;
+    image.height = entry.height;
+    image.channels = entry.channels;
+    for (int level = 0; level < static_cast<int>(entry.levels.size()); level++) {
+        size_t bytes = levelBytes(entry.width, entry.height, entry.channels, level);
+        image.levels.emplace_back(entry.levels[level], entry.levels[level] + bytes);
+    }
+    return image;
+}
+
+bool TexturePack::write(const std::string& path, const std::vector<const TextureImage*>& images,
+                        std::string& errorOut) {
+    PackHeader header{};
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(images.size());
+
+    // 计算各条目的偏移
+    std::vector<PackEntry> entries(images.size());
+    size_t offset = alignUp(sizeof(header) + entries.size() * sizeof(PackEntry));
+    for (size_t i = 0; i < images.size(); i++) {
+        const TextureImage& image = *images[i];
+        if (static_cast<int>(image.levels.size()) != getLevelCount(image.width, image.height)) {
+            errorOut = "Texture image has an incomplete mip chain";
+            return false;
+        }
+
+        PackEntry& entry = entries[i];
+        entry.key = image.key;
+        entry.width = image.width;
+        entry.height = image.height;
+        entry.channels = image.channels;
+        entry.levels = static_cast<int32_t>(image.levels.size());
+        entry.offset = offset;
+        entry.size = 0;
+        for (const auto& level : image.levels) {
+            entry.size += level.size();
+        }
+        offset = alignUp(offset + static_cast<size_t>(entry.size));
+    }
+
+    std::error_code ec;
+    fs::path target(path);
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path(), ec);
+    }
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            errorOut = "Cannot write texture pack: " + tempPath;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+
+        const char padding[DATA_ALIGNMENT] = {};
+        for (size_t i = 0; i < images.size(); i++) {
+            size_t position = static_cast<size_t>(file.tellp());
+            file.write(padding, static_cast<std::streamsize>(entries[i].offset - position));
+            for (const auto& level : images[i]->levels) {
+                file.write(reinterpret_cast<const char*>(level.data()),
+                           static_cast<std::streamsize>(level.size()));
+            }
+        }
+
+        if (!file) {
+            file.close();
+            fs::remove(tempPath, ec);
+            errorOut = "Failed writing texture pack: " + tempPath;
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        // 部分平台不允许覆盖已存在的文件
+        fs::remove(path, ec);
+        fs::rename(tempPath, path, ec);
+    }
+    if (ec) {
+        fs::remove(tempPath, ec);
+        errorOut = "Cannot replace texture pack: " + path;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace shadertoy
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "utils/MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace shadertoy {
+
+// 带完整 mip 链的 8 位纹理图像
+struct TextureImage {
+    uint64_t key = 0;                       // 生成参数的哈希
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<std::vector<uint8_t>> levels;   // levels[0] 为原图，逐级减半到 1x1
+
+    // 用 2x2 盒式滤波从 levels[0] 生成其余各级
+    void buildMipChain();
+};
+
+// 内置纹理包：单个版本化的二进制文件，保存生成好的纹理及其 mip 链
+// 读取时内存映射整个文件，各级数据直接作为 glTexImage2D 的源指针，不做拷贝
+//
+// 文件布局：PackHeader | PackEntry * entryCount | 各条目数据（16 字节对齐，各级依次紧密排列）
+class TexturePack {
+public:
+    // 文件格式或 mip 生成方式变化时递增
+    static constexpr uint32_t VERSION = 1;
+
+    // 映射中的一个条目
+    struct Entry {
+        uint64_t key = 0;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::vector<const uint8_t*> levels;     // 指向映射内存
+    };
+
+    TexturePack() = default;
+
+    // 禁止拷贝
+    TexturePack(const TexturePack&) = delete;
+    TexturePack& operator=(const TexturePack&) = delete;
+
+    // 映射并校验纹理包（魔数、版本、条目边界），失败时保持关闭
+    bool open(const std::string& path, std::string& errorOut);
+    void close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // 按键查找，尺寸或通道数不符时视为未命中
+    const Entry* find(uint64_t key, int width, int height, int channels) const;
+
+    // 把条目复制为独立的图像（关闭纹理包后仍可使用）
+    static TextureImage copyEntry(const Entry& entry);
+
+    // 写出纹理包（先写临时文件再替换，避免留下半个文件）
+    static bool write(const std::string& path, const std::vector<const TextureImage*>& images,
+                      std::string& errorOut);
+
+    // mip 级数（到 1x1 为止）
+    static int getLevelCount(int width, int height);
+
+private:
+    MappedFile m_file;
+    std::vector<Entry> m_entries;
+};
+
+} // namespace shadertoy
@@ -0,0 +1,140 @@
+#include "TextureRegistry.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace shadertoy {
+
+std::string TextureRegistry::makeKey(const std::string& path, const UserTextureOptions& options) {
+    std::error_code ec;
+    fs::path normalized = fs::absolute(fs::path(path), ec);
+    if (!ec) {
+        normalized = fs::weakly_canonical(normalized, ec);
+    }
+    std::string key = ec ? fs::path(path).lexically_normal().string() : normalized.string();
+
+    key += '|';
+    key += options.repeat ? 'R' : 'C';
+    key += options.linear ? 'L' : 'N';
+    key += options.flipY ? 'F' : '-';
+    return key;
+}
+
+size_t TextureRegistry::estimateBytes(int width, int height, int channels, bool mipmaps) {
+    // 驱动通常把 RGB8 按 RGBA8 存储
+    size_t bytesPerPixel = channels == 3 ? 4 : static_cast<size_t>(channels);
+    size_t bytes = static_cast<size_t>(width) * height * bytesPerPixel;
+    return mipmaps ? bytes + bytes / 3 : bytes;
+}
+
+void TextureRegistry::applySampler(const UserTextureOptions& options) {
+    GLint wrap = options.repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, options.linear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, options.linear ? GL_LINEAR : GL_NEAREST);
+}
+
+GLuint TextureRegistry::acquire(const std::string& key) {
+    auto it = m_textureByKey.find(key);
+    if (it == m_textureByKey.end()) {
+        m_stats.misses++;
+        return 0;
+    }
+
+    Entry& entry = m_entries[it->second];
+    if (entry.refCount == 0) {
+        m_lru.erase(entry.lruPos);
+        m_stats.referencedBytes += entry.bytes;
+    }
+    entry.refCount++;
+    m_stats.hits++;
+    return it->second;
+}
+
+void TextureRegistry::insert(const std::string& key, GLuint texture, int width, int height, int channels) {
+    Entry entry;
+    entry.key = key;
+    entry.width = width;
+    entry.height = height;
+    entry.bytes = estimateBytes(width, height, channels, true);
+    entry.refCount = 1;
+    m_entries[texture] = entry;
+    m_textureByKey[key] = texture;
+
+    m_stats.residentBytes += entry.bytes;
+    m_stats.referencedBytes += entry.bytes;
+    m_stats.residentCount++;
+
+    evictToBudget();
+}
+
+bool TextureRegistry::getSize(GLuint texture, int& widthOut, int& heightOut) const {
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    widthOut = it->second.width;
+    heightOut = it->second.height;
+    return true;
+}
+
+bool TextureRegistry::release(GLuint texture) {
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end()) {
+        return false;
+    }
+
+    Entry& entry = it->second;
+    if (entry.refCount > 0 && --entry.refCount == 0) {
+        entry.lruPos = m_lru.insert(m_lru.end(), texture);
+        m_stats.referencedBytes -= entry.bytes;
+        evictToBudget();
+    }
+    return true;
+}
+
+void TextureRegistry::setBudget(size_t bytes) {
+    m_budget = bytes;
+    evictToBudget();
+}
+
+void TextureRegistry::clear() {
+    for (auto& pair : m_entries) {
+        GLuint texture = pair.first;
+        glDeleteTextures(1, &texture);
+    }
+    m_entries.clear();
+    m_textureByKey.clear();
+    m_lru.clear();
+
+    m_stats.residentBytes = 0;
+    m_stats.referencedBytes = 0;
+    m_stats.residentCount = 0;
+}
+
+void TextureRegistry::evictToBudget() {
+    while (m_stats.residentBytes > m_budget && !m_lru.empty()) {
+        GLuint texture = m_lru.front();
+        m_lru.pop_front();
+
+        auto it = m_entries.find(texture);
+        std::cout << "TextureRegistry: Evicted " << it->second.key << " (" << it->second.bytes / 1024 << " KB)"
+                  << std::endl;
+
+        m_stats.residentBytes -= it->second.bytes;
+        m_stats.residentCount--;
+        m_stats.evictions++;
+        // 同一键可能已被后来上传的纹理取代
+        auto keyIt = m_textureByKey.find(it->second.key);
+        if (keyIt != m_textureByKey.end() && keyIt->second == texture) {
+            m_textureByKey.erase(keyIt);
+        }
+        m_entries.erase(it);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+} // namespace shadertoy
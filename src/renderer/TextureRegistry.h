@@ -0,0 +1,122 @@
+/**
+ * TextureRegistry - 用户纹理的引用计数注册表
+ *
+ * 以（规范化路径 + 采样设置 + 翻转）为键去重，同一图片被多个 Pass 或 Profile 使用时只上传一次
+ * 引用归零的纹理不会立即删除，而是按最近使用顺序保留在显存预算内，超出预算时淘汰最久未用的
+ * 仍被引用的纹理永远不会被淘汰，所以总占用可能暂时超过预算
+ * 所有方法都需要在 GL 线程调用
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace shadertoy {
+
+/**
+ * 用户纹理的加载选项（参与去重键）
+ */
+struct UserTextureOptions {
+    bool repeat = true;         // GL_REPEAT / GL_CLAMP_TO_EDGE
+    bool linear = true;         // 三线性过滤 / 最近邻
+    bool flipY = true;          // 垂直翻转（OpenGL 纹理原点在左下）
+};
+
+/**
+ * 注册表统计
+ */
+struct TextureRegistryStats {
+    uint64_t hits = 0;              // 命中已驻留的纹理
+    uint64_t misses = 0;            // 需要重新加载
+    uint64_t evictions = 0;         // 因超出预算被删除
+    size_t residentBytes = 0;       // 注册表中所有纹理的估算显存
+    size_t referencedBytes = 0;     // 其中仍被引用的部分
+    int residentCount = 0;
+};
+
+class TextureRegistry {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+    TextureRegistry() = default;
+    ~TextureRegistry() = default;
+
+    // 禁止拷贝
+    TextureRegistry(const TextureRegistry&) = delete;
+    TextureRegistry& operator=(const TextureRegistry&) = delete;
+
+    /**
+     * 生成去重键（路径先规范化，同一文件的不同写法得到同一个键）
+     */
+    static std::string makeKey(const std::string& path, const UserTextureOptions& options);
+
+    /**
+     * 估算纹理占用的显存（RGB 按 4 字节计，mip 链按 4/3 计）
+     */
+    static size_t estimateBytes(int width, int height, int channels, bool mipmaps);
+
+    /**
+     * 按选项设置当前绑定的 GL_TEXTURE_2D 的采样参数
+     */
+    static void applySampler(const UserTextureOptions& options);
+
+    /**
+     * 查找并增加引用，未命中返回 0
+     */
+    GLuint acquire(const std::string& key);
+
+    /**
+     * 登记新上传的纹理（带 mip 链，引用计数为 1），注册表接管其所有权
+     */
+    void insert(const std::string& key, GLuint texture, int width, int height, int channels);
+
+    /**
+     * 已登记纹理的尺寸
+     */
+    bool getSize(GLuint texture, int& widthOut, int& heightOut) const;
+
+    /**
+     * 释放一次引用，归零后进入 LRU 等待淘汰
+     * @return 纹理是否属于注册表
+     */
+    bool release(GLuint texture);
+
+    /**
+     * 显存预算，超出时淘汰未引用的纹理（0 = 引用归零立即删除）
+     */
+    void setBudget(size_t bytes);
+    size_t getBudget() const { return m_budget; }
+
+    const TextureRegistryStats& getStats() const { return m_stats; }
+
+    /**
+     * 删除所有纹理
+     */
+    void clear();
+
+private:
+    struct Entry {
+        std::string key;
+        int width = 0;
+        int height = 0;
+        size_t bytes = 0;
+        int refCount = 0;
+        std::list<GLuint>::iterator lruPos;     // refCount == 0 时有效
+    };
+
+    // 从最久未用的开始删除未引用的纹理，直到总占用不超过预算
+    void evictToBudget();
+
+    std::unordered_map<std::string, GLuint> m_textureByKey;
+    std::unordered_map<GLuint, Entry> m_entries;
+    std::list<GLuint> m_lru;                    // 未引用的纹理，front 为最久未用
+    size_t m_budget = DEFAULT_BUDGET;
+    TextureRegistryStats m_stats;
+};
+
+} // namespace shadertoy
@@ -1,11 +1,42 @@
 #include "GLSLTranspiler.h"
 
-#include <regex>
-#include <sstream>
+#include <cctype>
+#include <cstring>
 
 namespace shadertoy {
 
-std::string GLSLTranspiler::getUniformDeclarations() {
+std::string GLSLTranspiler::getUniformDeclarations(bool useUniformBuffer) {
+    if (useUniformBuffer) {
+        // 帧全局 uniform 由所有 Pass 共享，每帧只上传一次
+        // 布局必须与 UniformManager 中的 ShadertoyInputsBlock 一致，binding 与 INPUTS_BLOCK_BINDING 一致
+        // iResolution / iChannelResolution 随 Pass 变化，保持普通 uniform
+        return R"(
+// Shadertoy uniform declarations (shared uniform block)
+layout(std140, binding = 0) uniform ShadertoyInputs {
+    vec4 st_Mouse;                  // mouse pixel coords. xy: current, zw: click
+    vec4 st_Date;                   // (year, month, day, time in seconds)
+    float st_Time;                  // shader playback time (in seconds)
+    float st_TimeDelta;             // render time (in seconds)
+    int st_Frame;                   // shader playback frame
+    float st_SampleRate;            // sound sample rate (i.e., 44100)
+    vec4 st_ChannelTime;            // channel playback time (in seconds)
+};
+#define iMouse st_Mouse
+#define iDate st_Date
+#define iTime st_Time
+#define iTimeDelta st_TimeDelta
+#define iFrame st_Frame
+#define iSampleRate st_SampleRate
+#define iChannelTime st_ChannelTime
+uniform vec3 iResolution;           // viewport resolution (in pixels)
+uniform vec3 iChannelResolution[4]; // channel resolution (in pixels)
+uniform sampler2D iChannel0;        // input channel 0
+uniform sampler2D iChannel1;        // input channel 1
+uniform sampler2D iChannel2;        // input channel 2
+uniform sampler2D iChannel3;        // input channel 3
+)";
+    }
+    
     return R"(
 // Shadertoy uniform declarations
 uniform vec3 iResolution;           // viewport resolution (in pixels)
@@ -34,61 +65,278 @@ void main() {
 )";
 }
 
-std::string GLSLTranspiler::removePrecision(const std::string& code) {
-    // 移除 precision 声明
-    std::regex precisionRegex(R"(precision\s+(lowp|mediump|highp)\s+\w+\s*;)");
-    return std::regex_replace(code, precisionRegex, "");
+namespace {
+
+bool isIdentifierStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
 }
 
-std::string GLSLTranspiler::replaceWebGLFunctions(const std::string& code) {
-    std::string result = code;
-    
-    // texture2D -> texture
-    result = std::regex_replace(result, std::regex(R"(\btexture2D\s*\()"), "texture(");
-    
-    // textureCube -> texture
-    result = std::regex_replace(result, std::regex(R"(\btextureCube\s*\()"), "texture(");
-    
-    // texture2DLod -> textureLod
-    result = std::regex_replace(result, std::regex(R"(\btexture2DLod\s*\()"), "textureLod(");
-    
-    return result;
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// WebGL 函数名 -> GLSL 4.30 函数名，不需要替换时返回 nullptr
+const char* mapFunctionName(const char* name, size_t length) {
+    struct Mapping { const char* from; size_t length; const char* to; };
+    static const Mapping MAPPINGS[] = {
+        {"texture2D", 9, "texture"},
+        {"textureCube", 11, "texture"},
+        {"texture2DLod", 12, "textureLod"},
+    };
+    for (const auto& mapping : MAPPINGS) {
+        if (mapping.length == length && std::memcmp(mapping.from, name, length) == 0) {
+            return mapping.to;
+        }
+    }
+    return nullptr;
+}
+
+bool equals(const char* name, size_t length, const char* keyword) {
+    return std::strlen(keyword) == length && std::memcmp(name, keyword, length) == 0;
 }
 
-std::string GLSLTranspiler::transpile(const std::string& shadertoyCode) {
-    std::stringstream ss;
+// 单遍扫描的源码改写器，注释原样保留
+class SourceRewriter {
+public:
+    explicit SourceRewriter(const std::string& source) : m_src(source) {
+        m_out.reserve(source.size());
+    }
+
+    std::string run() {
+        bool lineStart = true;  // 当前行到目前为止只有空白（可以出现预处理指令）
+        while (m_pos < m_src.size()) {
+            char c = m_src[m_pos];
+            if (c == '/' && peek(1) == '/') {
+                copyLineComment();
+            } else if (c == '/' && peek(1) == '*') {
+                copyBlockComment();
+            } else if (c == '\n') {
+                m_out += c;
+                m_pos++;
+                lineStart = true;
+            } else if (isSpace(c)) {
+                m_out += c;
+                m_pos++;
+            } else if (c == '#' && lineStart) {
+                processDirective();
+            } else {
+                lineStart = false;
+                if (isIdentifierStart(c)) {
+                    processIdentifier(false);
+                } else if (isDigit(c) || (c == '.' && isDigit(peek(1)))) {
+                    copyNumber();
+                } else {
+                    m_out += c;
+                    m_pos++;
+                }
+            }
+        }
+        return std::move(m_out);
+    }
+
+private:
+    char peek(size_t offset) const {
+        size_t pos = m_pos + offset;
+        return pos < m_src.size() ? m_src[pos] : '\0';
+    }
+
+    size_t skipSpace(size_t pos) const {
+        while (pos < m_src.size() && isSpace(m_src[pos])) {
+            pos++;
+        }
+        return pos;
+    }
+
+    size_t identifierEnd(size_t pos) const {
+        while (pos < m_src.size() && isIdentifierChar(m_src[pos])) {
+            pos++;
+        }
+        return pos;
+    }
+
+    // 复制到行尾（不含换行符）
+    void copyLineComment() {
+        size_t end = m_src.find('\n', m_pos);
+        if (end == std::string::npos) {
+            end = m_src.size();
+        }
+        m_out.append(m_src, m_pos, end - m_pos);
+        m_pos = end;
+    }
+
+    void copyBlockComment() {
+        size_t end = m_src.find("*/", m_pos + 2);
+        end = (end == std::string::npos) ? m_src.size() : end + 2;
+        m_out.append(m_src, m_pos, end - m_pos);
+        m_pos = end;
+    }
+
+    // 数字整体复制，避免把 1e5、2u 之类的后缀当成标识符
+    void copyNumber() {
+        size_t end = m_pos;
+        while (end < m_src.size() && (isIdentifierChar(m_src[end]) || m_src[end] == '.')) {
+            end++;
+        }
+        m_out.append(m_src, m_pos, end - m_pos);
+        m_pos = end;
+    }
+
+    void processIdentifier(bool inDefine) {
+        size_t end = identifierEnd(m_pos);
+        const char* name = m_src.data() + m_pos;
+        size_t length = end - m_pos;
+
+        if (!inDefine && equals(name, length, "precision") && skipPrecision(end)) {
+            return;
+        }
+
+        // 普通代码中仅替换函数调用（与用户定义的同名变量区分）
+        // #define 内容可能是函数名别名，总是替换
+        const char* mapped = mapFunctionName(name, length);
+        if (mapped && (inDefine || (skipSpace(end) < m_src.size() && m_src[skipSpace(end)] == '('))) {
+            m_out += mapped;
+        } else {
+            m_out.append(name, length);
+        }
+        m_pos = end;
+    }
+
+    // precision <lowp|mediump|highp> <type> ; 整句删除
+    bool skipPrecision(size_t pos) {
+        pos = skipSpace(pos);
+        size_t qualifierEnd = identifierEnd(pos);
+        const char* qualifier = m_src.data() + pos;
+        size_t qualifierLength = qualifierEnd - pos;
+        if (!equals(qualifier, qualifierLength, "lowp") &&
+            !equals(qualifier, qualifierLength, "mediump") &&
+            !equals(qualifier, qualifierLength, "highp")) {
+            return false;
+        }
+
+        pos = skipSpace(qualifierEnd);
+        size_t typeEnd = identifierEnd(pos);
+        if (typeEnd == pos) {
+            return false;
+        }
+
+        pos = skipSpace(typeEnd);
+        if (pos >= m_src.size() || m_src[pos] != ';') {
+            return false;
+        }
+        m_pos = pos + 1;
+        return true;
+    }
+
+    // 处理一条预处理指令，停在行尾换行符处（#version 连同换行一起删除）
+    void processDirective() {
+        size_t nameStart = m_pos + 1;
+        while (nameStart < m_src.size() && (m_src[nameStart] == ' ' || m_src[nameStart] == '\t')) {
+            nameStart++;
+        }
+        size_t nameEnd = identifierEnd(nameStart);
+        const char* name = m_src.data() + nameStart;
+        size_t nameLength = nameEnd - nameStart;
+
+        if (equals(name, nameLength, "version")) {
+            skipDirectiveLine();
+            return;
+        }
+
+        // 只有 #define 的内容会被展开到代码中，#error/#pragma 等保持原样
+        bool rewrite = equals(name, nameLength, "define");
+        m_out.append(m_src, m_pos, nameEnd - m_pos);
+        m_pos = nameEnd;
+
+        while (m_pos < m_src.size()) {
+            char c = m_src[m_pos];
+            if (c == '\\' && (peek(1) == '\n' || (peek(1) == '\r' && peek(2) == '\n'))) {
+                size_t length = peek(1) == '\n' ? 2 : 3;  // 续行
+                m_out.append(m_src, m_pos, length);
+                m_pos += length;
+            } else if (c == '\n') {
+                break;
+            } else if (c == '/' && peek(1) == '/') {
+                copyLineComment();
+                break;
+            } else if (c == '/' && peek(1) == '*') {
+                copyBlockComment();
+            } else if (isIdentifierStart(c)) {
+                if (rewrite) {
+                    processIdentifier(true);
+                } else {
+                    size_t end = identifierEnd(m_pos);
+                    m_out.append(m_src, m_pos, end - m_pos);
+                    m_pos = end;
+                }
+            } else if (isDigit(c)) {
+                copyNumber();
+            } else {
+                m_out += c;
+                m_pos++;
+            }
+        }
+    }
+
+    void skipDirectiveLine() {
+        while (m_pos < m_src.size()) {
+            char c = m_src[m_pos];
+            if (c == '\\' && peek(1) == '\n') {
+                m_pos += 2;
+            } else if (c == '\n') {
+                m_pos++;
+                return;
+            } else {
+                m_pos++;
+            }
+        }
+    }
+
+    const std::string& m_src;
+    std::string m_out;
+    size_t m_pos = 0;
+};
+
+} // namespace
+
+std::string GLSLTranspiler::rewriteSource(const std::string& code) {
+    return SourceRewriter(code).run();
+}
+
+std::string GLSLTranspiler::transpile(const std::string& shadertoyCode, bool useUniformBuffer) {
+    static const char* MAIN_WRAPPER = R"(
+void main() {
+    mainImage(FragColor, gl_FragCoord.xy);
+}
+)";
+    std::string declarations = getUniformDeclarations(useUniformBuffer);
+    
+    std::string result;
+    result.reserve(shadertoyCode.size() + declarations.size() + 256);
     
     // 1. 添加版本声明
-    ss << "#version 430 core\n";
-    ss << "out vec4 FragColor;\n\n";
+    result += "#version 430 core\n";
+    result += "out vec4 FragColor;\n\n";
     
     // 2. 添加 uniform 声明
-    ss << getUniformDeclarations();
-    ss << "\n";
-    
-    // 3. 处理 Shadertoy 代码
-    std::string processedCode = shadertoyCode;
-    
-    // 移除已有的版本声明
-    processedCode = std::regex_replace(processedCode, std::regex(R"(#version\s+\d+(\s+\w+)?\s*)"), "");
+    result += declarations;
+    result += "\n";
     
-    // 移除 precision 声明
-    processedCode = removePrecision(processedCode);
-    
-    // 替换 WebGL 函数
-    processedCode = replaceWebGLFunctions(processedCode);
-    
-    ss << processedCode;
-    ss << "\n\n";
+    // 3. 处理 Shadertoy 代码（移除 #version/precision，替换 WebGL 函数）
+    result += rewriteSource(shadertoyCode);
+    result += "\n\n";
     
     // 4. 添加 main 函数包装
-    ss << R"(
-void main() {
-    mainImage(FragColor, gl_FragCoord.xy);
-}
-)";
+    result += MAIN_WRAPPER;
     
-    return ss.str();
+    return result;
 }
 
 } // namespace shadertoy
@@ -6,21 +6,27 @@ namespace shadertoy {
 
 class GLSLTranspiler {
 public:
+    // ShadertoyInputs uniform block 的绑定点
+    static constexpr int INPUTS_BLOCK_BINDING = 0;
+    
+    // 转译规则版本，输出格式变化时递增（用于判断已编译的 Pass 是否过期）
+    static constexpr int VERSION = 2;
+    
     // 将 Shadertoy GLSL 转换为 OpenGL Core GLSL
-    static std::string transpile(const std::string& shadertoyCode);
+    // useUniformBuffer: 帧全局 uniform 放入 std140 的 ShadertoyInputs block
+    static std::string transpile(const std::string& shadertoyCode, bool useUniformBuffer = false);
     
     // 获取默认顶点着色器
     static std::string getDefaultVertexShader();
     
     // 获取 uniform 声明
-    static std::string getUniformDeclarations();
+    static std::string getUniformDeclarations(bool useUniformBuffer = false);
 
-private:
-    // 移除 precision 声明
-    static std::string removePrecision(const std::string& code);
-    
-    // 替换 WebGL 函数为 OpenGL 函数
-    static std::string replaceWebGLFunctions(const std::string& code);
+    // 单次线性扫描完成所有源码改写（跳过注释，识别预处理指令）：
+    // - 删除 #version 行和 precision 声明
+    // - texture2D/textureCube -> texture，texture2DLod -> textureLod
+    //   （普通代码中仅在函数调用处替换，#define 内容中总是替换）
+    static std::string rewriteSource(const std::string& code);
 };
 
 } // namespace shadertoy
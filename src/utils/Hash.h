@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace shadertoy {
+
+// FNV-1a 64 位哈希（用于缓存键，非加密用途）
+class Hash {
+public:
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    static uint64_t fnv1a(const void* data, size_t size, uint64_t seed = FNV_OFFSET) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    static uint64_t fnv1a(const std::string& str, uint64_t seed = FNV_OFFSET) {
+        return fnv1a(str.data(), str.size(), seed);
+    }
+
+    // 组合多个字符串时追加长度，避免 "ab"+"c" 与 "a"+"bc" 冲突
+    static uint64_t combine(uint64_t seed, const std::string& str) {
+        uint64_t size = str.size();
+        seed = fnv1a(&size, sizeof(size), seed);
+        return fnv1a(str, seed);
+    }
+
+    // 16 位十六进制字符串
+    static std::string toHex(uint64_t hash) {
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+        return buf;
+    }
+};
+
+} // namespace shadertoy
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace shadertoy {
+
+// 只读内存映射文件（Windows: CreateFileMapping，其他平台: mmap）
+// 映射期间文件内容由操作系统按页读入，不需要先整体读到内存
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // 禁止拷贝
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, std::string& errorOut);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+} // namespace shadertoy
@@ -0,0 +1,112 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace shadertoy {
+
+namespace {
+
+// 当前线程是否正在执行线程池任务（工作线程，或正在 parallelFor 中的调用线程）
+thread_local bool t_insideJob = false;
+
+} // namespace
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount < 0) {
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        threadCount = std::max(0, hardware - 1);
+    }
+
+    m_workers.reserve(static_cast<size_t>(threadCount));
+    for (int i = 0; i < threadCount; i++) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeCv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn) {
+    if (end <= begin) {
+        return;
+    }
+    grain = std::max(1, grain);
+
+    // 任务太小、没有工作线程或嵌套调用时直接在当前线程执行
+    if (m_workers.empty() || t_insideJob || end - begin <= grain) {
+        for (int i = begin; i < end; i += grain) {
+            fn(i, std::min(i + grain, end));
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_next.store(begin);
+        m_end = end;
+        m_grain = grain;
+        m_pendingWorkers = static_cast<int>(m_workers.size());
+        m_generation++;
+    }
+    m_wakeCv.notify_all();
+
+    // 调用线程也领取分块
+    t_insideJob = true;
+    runChunks();
+    t_insideJob = false;
+
+    // 等待所有工作线程离开本任务，之后 fn 才能安全销毁
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this]() { return m_pendingWorkers == 0; });
+    m_job = nullptr;
+}
+
+void ThreadPool::runChunks() {
+    for (;;) {
+        int start = m_next.fetch_add(m_grain);
+        if (start >= m_end) {
+            return;
+        }
+        (*m_job)(start, std::min(start + m_grain, m_end));
+    }
+}
+
+void ThreadPool::workerLoop() {
+    t_insideJob = true;
+    unsigned long long seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCv.wait(lock, [&]() { return m_stop || m_generation != seen; });
+            if (m_stop) {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pendingWorkers == 0) {
+            m_doneCv.notify_all();
+        }
+    }
+}
+
+} // namespace shadertoy
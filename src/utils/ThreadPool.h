@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace shadertoy {
+
+// 简单的 fork-join 线程池，用于 CPU 端的数据并行（如噪声纹理按行分块生成）
+// parallelFor 把区间按 grain 分块，工作线程和调用线程一起领取，全部完成后返回
+// 同一时刻只执行一个任务；在任务内部嵌套调用时直接在当前线程串行执行
+class ThreadPool {
+public:
+    static ThreadPool& instance();
+
+    // threadCount: 工作线程数（不含调用线程），-1 = 硬件线程数 - 1
+    explicit ThreadPool(int threadCount = -1);
+    ~ThreadPool();
+
+    // 禁止拷贝
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 参与计算的线程数（工作线程 + 调用线程）
+    int getConcurrency() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    // 并行执行 fn(chunkBegin, chunkEnd)，覆盖 [begin, end)，每块最多 grain 个元素
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn);
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_submitMutex;   // 串行化 parallelFor 调用
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCv;
+    std::condition_variable m_doneCv;
+
+    // 当前任务
+    const std::function<void(int, int)>* m_job = nullptr;
+    std::atomic<int> m_next{0};
+    int m_end = 0;
+    int m_grain = 1;
+    int m_pendingWorkers = 0;
+    unsigned long long m_generation = 0;
+    bool m_stop = false;
+};
+
+} // namespace shadertoy